@@ -0,0 +1,117 @@
+#include "Acquisition.h"
+#include <driver/gpio.h>
+#include "Hx711Reader.h"
+#include "Hx711Esp32.h"
+#include "SampleRing.h"
+
+// ==================== STATE PRIVATE ====================
+// Pin HX711 hanya disentuh oleh task akuisisi setelah startAcquisition()
+static Esp32Hx711Pins hxPins;
+static SampleRing<RawSample, Config::ACQ_RING_SIZE> sampleRing;
+static TaskHandle_t acqTaskHandle = nullptr;
+static portMUX_TYPE hxMux = portMUX_INITIALIZER_UNLOCKED;
+
+static volatile uint32_t statProduced = 0;
+static volatile uint32_t statDropped = 0;
+static volatile uint32_t statMissed = 0;
+static volatile uint32_t statMaxGapUs = 0;
+
+// ==================== ISR DATA-READY ====================
+// DOUT turun = konversi siap. ISR hanya membangunkan task akuisisi;
+// clock-out 24 bit dilakukan di konteks task.
+static void IRAM_ATTR onDataReady() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(acqTaskHandle, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// Baca satu word dengan interrupt DOUT dimatikan, supaya tepi turun
+// dari bit data sendiri tidak memicu notifikasi palsu
+static int32_t readConversion() {
+  gpio_intr_disable(static_cast<gpio_num_t>(Config::HX711_DOUT));
+  portENTER_CRITICAL(&hxMux);
+  int32_t raw = Hx711::readWord(hxPins, Hx711::GAIN_128_A);
+  portEXIT_CRITICAL(&hxMux);
+  gpio_intr_enable(static_cast<gpio_num_t>(Config::HX711_DOUT));
+  return raw;
+}
+
+// Polling blocking untuk fase boot (sebelum ISR aktif). Return false jika timeout.
+static bool readConversionBlocking(int32_t& raw, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (!Hx711::isReady(hxPins)) {
+    if (millis() - start > timeoutMs) return false;
+    delay(1);
+  }
+  portENTER_CRITICAL(&hxMux);
+  raw = Hx711::readWord(hxPins, Hx711::GAIN_128_A);
+  portEXIT_CRITICAL(&hxMux);
+  return true;
+}
+
+// ==================== TASK AKUISISI ====================
+
+static void acquisitionTask(void*) {
+  const uint32_t periodUs = 1000000UL / Config::HX711_SPS;
+  const uint32_t missThresholdUs = periodUs + periodUs / 2;
+  const TickType_t waitTicks = pdMS_TO_TICKS(2 * periodUs / 1000 + 1);
+  uint32_t seq = 0;
+  uint32_t lastUs = 0;
+
+  for (;;) {
+    // Tidur sampai ISR data-ready; timeout hanya jaring pengaman jika
+    // tepi turun terlewat (mis. DOUT sudah LOW saat interrupt diaktifkan)
+    ulTaskNotifyTake(pdTRUE, waitTicks);
+    if (!Hx711::isReady(hxPins)) continue;
+
+    RawSample sample;
+    sample.raw = readConversion();
+    sample.timestampUs = micros();
+    sample.seq = seq++;
+
+    if (lastUs != 0) {
+      uint32_t gap = sample.timestampUs - lastUs;
+      if (gap > statMaxGapUs) statMaxGapUs = gap;
+      if (gap > missThresholdUs) statMissed += (gap + periodUs / 2) / periodUs - 1;
+    }
+    lastUs = sample.timestampUs;
+
+    if (sampleRing.push(sample)) {
+      statProduced++;
+    } else {
+      statDropped++;
+    }
+  }
+}
+
+// ==================== IMPLEMENTASI FUNGSI ====================
+
+bool startAcquisition() {
+  hxPins.begin();
+
+  // Satu konversi cukup untuk memastikan HX711 terpasang (~12 ms pada 80 SPS);
+  // konversi awal yang belum settle ditangani detektor stabilitas
+  int32_t raw = 0;
+  if (!readConversionBlocking(raw, Config::HX711_TIMEOUT_MS)) return false;
+
+  BaseType_t ok = xTaskCreatePinnedToCore(
+      acquisitionTask, "acq", Config::ACQ_TASK_STACK, nullptr,
+      Config::ACQ_TASK_PRIORITY, &acqTaskHandle, Config::ACQ_TASK_CORE);
+  if (ok != pdPASS) return false;
+
+  attachInterrupt(digitalPinToInterrupt(Config::HX711_DOUT), onDataReady, FALLING);
+  return true;
+}
+
+bool popSample(RawSample& out) {
+  return sampleRing.pop(out);
+}
+
+AcquisitionStats getAcquisitionStats() {
+  AcquisitionStats s;
+  s.produced = statProduced;
+  s.dropped = statDropped;
+  s.missed = statMissed;
+  s.maxGapUs = statMaxGapUs;
+  return s;
+}
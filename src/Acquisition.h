@@ -0,0 +1,22 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Types.h"
+
+// ==================== FUNGSI AKUISISI ====================
+
+// Cek HX711 merespons lalu jalankan task akuisisi yang di-pin ke
+// Config::ACQ_TASK_CORE dan dibangunkan oleh interrupt DOUT. Tidak ada
+// settle/tare blocking: tare dimiliki WeighingPipeline (tersimpan di NVS,
+// re-tare di latar belakang). Return false jika HX711 tidak merespons.
+bool startAcquisition();
+
+// Ambil satu sampel dari ring buffer (dipanggil dari loop utama saja)
+bool popSample(RawSample& out);
+
+// Snapshot counter akuisisi (aman dipanggil dari task mana pun)
+AcquisitionStats getAcquisitionStats();
+
+#endif
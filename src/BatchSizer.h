@@ -0,0 +1,48 @@
+#ifndef BATCH_SIZER_H
+#define BATCH_SIZER_H
+
+#include <stdint.h>
+
+// ==================== UKURAN BATCH ADAPTIF ====================
+// Batas record per POST batch, diatur dari RTT yang terukur:
+//   - batch penuh (ada antrean) selesai < target/2  -> batas x2
+//   - batch selesai > target, atau gagal            -> batas /2
+// Mulai dari 1 record, jadi pengiriman live tetap satu record per POST dan
+// batch hanya membesar saat ada backlog (setelah offline / jam sibuk).
+// Target menjaga satu POST jauh di bawah HTTP_TIMEOUT: batch yang terlalu
+// besar di jaringan lambat lebih mahal diulang daripada beberapa batch kecil.
+
+class BatchSizer {
+public:
+  BatchSizer(uint16_t maxRecords, uint32_t targetMs, uint16_t initial = 1)
+    : max_(maxRecords), targetMs_(targetMs), limit_(initial < maxRecords ? initial : maxRecords) {}
+
+  uint16_t limit() const { return limit_; }
+
+  void onBatch(uint16_t records, uint32_t elapsedMs, bool ok) {
+    batches_++;
+    if (ok) sent_ += records;
+    // RTT per batch, EWMA 1/4 (hanya untuk laporan)
+    rttMs_ = batches_ == 1 ? elapsedMs : rttMs_ + ((static_cast<int32_t>(elapsedMs) - static_cast<int32_t>(rttMs_)) >> 2);
+
+    if (!ok || elapsedMs > targetMs_) {
+      limit_ = limit_ > 1 ? limit_ / 2 : 1;
+    } else if (records >= limit_ && elapsedMs * 2 <= targetMs_) {
+      limit_ = limit_ * 2 < max_ ? limit_ * 2 : max_;
+    }
+  }
+
+  uint32_t batches() const { return batches_; }
+  uint32_t recordsSent() const { return sent_; }
+  uint32_t smoothedRttMs() const { return rttMs_; }
+
+private:
+  uint16_t max_;
+  uint32_t targetMs_;
+  uint16_t limit_;
+  uint32_t batches_ = 0;
+  uint32_t sent_ = 0;
+  uint32_t rttMs_ = 0;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Hal.h"
+
+// ==================== PROFIL BOOT ====================
+// Cap waktu (ms sejak reset) di akhir setiap fase startup. Fase jaringan
+// selesai di loop() setelah timbangan sudah bisa dipakai, jadi laporan
+// dicetak dua kali: saat "ready" dan saat MQTT pertama kali tersambung
+// (sekaligus dikirim sebagai telemetri).
+
+class BootProfiler {
+public:
+  static constexpr size_t MAX_PHASES = 12;
+
+  // Tandai fase 'name' selesai pada nowMs. 'name' harus string literal.
+  void mark(const char* name, uint32_t nowMs) {
+    if (count_ >= MAX_PHASES) return;
+    phases_[count_].name = name;
+    phases_[count_].atMs = nowMs;
+    count_++;
+  }
+
+  size_t count() const { return count_; }
+
+  // Waktu fase (ms sejak reset), 0 jika belum pernah ditandai
+  uint32_t at(const char* name) const {
+    for (size_t i = 0; i < count_; i++) {
+      if (strcmp(phases_[i].name, name) == 0) return phases_[i].atMs;
+    }
+    return 0;
+  }
+
+  // "BOOT: lcd @142ms (+118)" per fase, durasi relatif terhadap fase sebelumnya
+  void report() const {
+    uint32_t prev = 0;
+    for (size_t i = 0; i < count_; i++) {
+      logPrintf("BOOT: %-10s @%lums (+%lu)\n", phases_[i].name,
+                (unsigned long)phases_[i].atMs, (unsigned long)(phases_[i].atMs - prev));
+      prev = phases_[i].atMs;
+    }
+  }
+
+  // {"fakultas":"FT","boot_ms":{"serial":21,"lcd":142,...}}
+  // Return panjang string, 0 jika buffer tidak cukup
+  size_t toJson(char* out, size_t len, const char* fakultas) const {
+    int n = snprintf(out, len, "{\"fakultas\":\"%s\",\"boot_ms\":{", fakultas);
+    for (size_t i = 0; i < count_ && n > 0 && static_cast<size_t>(n) < len; i++) {
+      n += snprintf(out + n, len - n, "%s\"%s\":%lu", i ? "," : "",
+                    phases_[i].name, (unsigned long)phases_[i].atMs);
+    }
+    if (n > 0 && static_cast<size_t>(n) < len) n += snprintf(out + n, len - n, "}}");
+    return (n > 0 && static_cast<size_t>(n) < len) ? static_cast<size_t>(n) : 0;
+  }
+
+private:
+  struct Phase {
+    const char* name;
+    uint32_t atMs;
+  };
+
+  Phase phases_[MAX_PHASES];
+  size_t count_ = 0;
+};
+
+#endif
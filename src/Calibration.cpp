@@ -0,0 +1,34 @@
+#include "Calibration.h"
+#include "Settings.h"
+
+static const char* CAL_TABLE_KEY = "cal_table";
+static constexpr uint8_t CAL_BLOB_VERSION = 1;
+
+// Layout blob di NVS (little-endian, sama di ESP32 dan host)
+struct CalibrationBlob {
+  uint8_t version;
+  uint8_t count;
+  uint8_t reserved[2];
+  CalibrationTable::Point points[CalibrationTable::MAX_POINTS];
+};
+
+// ==================== IMPLEMENTASI FUNGSI ====================
+
+bool loadCalibration(CalibrationTable& table) {
+  CalibrationBlob blob;
+  if (!loadPersistedBlob(CAL_TABLE_KEY, &blob, sizeof(blob))) return false;
+  if (blob.version != CAL_BLOB_VERSION) return false;
+  return table.setPoints(blob.points, blob.count);
+}
+
+bool saveCalibration(const CalibrationTable& table) {
+  CalibrationBlob blob = {};
+  blob.version = CAL_BLOB_VERSION;
+  blob.count = static_cast<uint8_t>(table.pointCount());
+  for (size_t i = 0; i < table.pointCount(); i++) blob.points[i] = table.point(i);
+  return savePersistedBlob(CAL_TABLE_KEY, &blob, sizeof(blob));
+}
+
+bool clearCalibration() {
+  return erasePersisted(CAL_TABLE_KEY);
+}
@@ -0,0 +1,110 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FixedWeight.h"
+
+// ==================== KALIBRASI MULTI-TITIK ====================
+// Pengganti faktor tunggal Config::CALIBRATION_VALUE (satu beban acuan 1000 g
+// di kalibrasi-baru.cpp). Tabel N titik (net count -> mg) diinterpolasi
+// linear per segmen, jadi non-linearitas sel beban di 20-50 kg ikut terkoreksi.
+//  - Slope tiap segmen (mg per count, Q16) dihitung sekali saat tabel diset
+//  - Lookup segmen per sampel: jumlah perbandingan (tanpa cabang bergantung
+//    data), lalu satu perkalian int64 seperti FixedWeight::countsToMg
+//  - Di luar titik terendah/tertinggi: ekstrapolasi segmen ujung
+
+class CalibrationTable {
+public:
+  static constexpr size_t MAX_POINTS = 8;
+
+  struct Point {
+    int32_t net;   // raw - tare (count)
+    int32_t mg;    // berat acuan
+  };
+
+  // Default: faktor tunggal, identik dengan countsToMg(net, mgPerCountQ16)
+  explicit CalibrationTable(int32_t mgPerCountQ16) { setSingleFactor(mgPerCountQ16); }
+
+  void setSingleFactor(int32_t mgPerCountQ16) {
+    // 2^Q count -> tepat mgPerCountQ16 mg, sehingga slope hasil = pengali aslinya
+    const Point pts[2] = { { 0, 0 }, { 1 << FixedWeight::Q, mgPerCountQ16 } };
+    setPoints(pts, 2);
+    custom_ = false;
+  }
+
+  // Titik harus urut naik (net dan mg), 2..MAX_POINTS titik.
+  // Return false (tabel tidak berubah) jika tidak valid.
+  bool setPoints(const Point* pts, size_t n) {
+    if (n < 2 || n > MAX_POINTS) return false;
+    for (size_t i = 1; i < n; i++) {
+      if (pts[i].net <= pts[i - 1].net || pts[i].mg <= pts[i - 1].mg) return false;
+    }
+    for (size_t i = 0; i < n; i++) points_[i] = pts[i];
+    count_ = n;
+    for (size_t i = 0; i + 1 < n; i++) {
+      int64_t dMg = static_cast<int64_t>(pts[i + 1].mg) - pts[i].mg;
+      int64_t dNet = static_cast<int64_t>(pts[i + 1].net) - pts[i].net;
+      slopeQ16_[i] = static_cast<int32_t>((dMg * (1 << FixedWeight::Q) + dNet / 2) / dNet);
+    }
+    custom_ = true;
+    return true;
+  }
+
+  // Tambah/ganti satu titik acuan (titik dengan mg sama diganti). Titik
+  // pertama pada tabel default memulai tabel baru dari (0, 0).
+  bool insertPoint(const Point& p) {
+    Point pts[MAX_POINTS + 1];
+    size_t n = 0;
+    if (!custom_) {
+      pts[n++] = Point{ 0, 0 };
+    } else {
+      for (size_t i = 0; i < count_; i++) {
+        if (points_[i].mg != p.mg) pts[n++] = points_[i];
+      }
+    }
+    if (n >= MAX_POINTS) return false;
+
+    size_t at = n;
+    while (at > 0 && pts[at - 1].mg > p.mg) { pts[at] = pts[at - 1]; at--; }
+    pts[at] = p;
+    return setPoints(pts, n + 1);
+  }
+
+  // Net count -> miligram, dibulatkan ke terdekat
+  int32_t toMg(int32_t net) const {
+    size_t seg = 0;
+    for (size_t i = 1; i + 1 < count_; i++) seg += net >= points_[i].net;
+    return points_[seg].mg + FixedWeight::countsToMg(net - points_[seg].net, slopeQ16_[seg]);
+  }
+
+  // Kebalikan toMg (mis. offset auto-zero mg -> count), dibulatkan ke nol
+  int32_t toNet(int32_t mg) const {
+    size_t seg = 0;
+    for (size_t i = 1; i + 1 < count_; i++) seg += mg >= points_[i].mg;
+    int64_t dMg = static_cast<int64_t>(mg) - points_[seg].mg;
+    return points_[seg].net + static_cast<int32_t>(dMg * (1 << FixedWeight::Q) / slopeQ16_[seg]);
+  }
+
+  // false = masih faktor tunggal dari profil perangkat
+  bool isCustom() const { return custom_; }
+  size_t pointCount() const { return count_; }
+  const Point& point(size_t i) const { return points_[i]; }
+
+private:
+  Point points_[MAX_POINTS];
+  int32_t slopeQ16_[MAX_POINTS - 1];
+  size_t count_ = 0;
+  bool custom_ = false;
+};
+
+// ==================== PERSISTENSI ====================
+// Disimpan sebagai satu blob di storage (key "cal_table"); tabel default
+// (faktor tunggal dari profil perangkat) tidak disimpan.
+
+// Return true jika tabel tersimpan ditemukan dan valid
+bool loadCalibration(CalibrationTable& table);
+bool saveCalibration(const CalibrationTable& table);
+bool clearCalibration();
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef CAPTURE_FRAME_H
+#define CAPTURE_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Types.h"
+
+// ==================== FRAME CAPTURE BINER ====================
+// Format stream mode capture (console 'capture on'), satu frame per konversi:
+//
+//   off  ukuran  isi
+//   0    2       sync 0xA5 0x5A
+//   2    4       seq (little-endian)
+//   6    4       timestamp us (little-endian)
+//   10   3       raw 24-bit two's complement (little-endian)
+//   13   2       CRC-16/CCITT-FALSE atas byte 2..12 (little-endian)
+//
+// 15 byte/sampel = 1200 B/s pada 80 SPS, jauh di bawah 11.5 kB/s Serial 115200.
+// Decoder mencari sync lalu memvalidasi CRC, jadi teks log yang ikut
+// tercampur di stream cukup dilewati.
+
+namespace Capture {
+
+  constexpr uint8_t SYNC_0 = 0xA5;
+  constexpr uint8_t SYNC_1 = 0x5A;
+  constexpr size_t FRAME_SIZE = 15;
+
+  // CRC-16/CCITT-FALSE, 4 bit per langkah lewat tabel 16 entri (32 byte):
+  // hasil sama dengan versi bit-per-bit, ~4x lebih cepat
+  inline uint16_t crc16(const uint8_t* data, size_t len) {
+    static const uint16_t NIBBLE[16] = {
+      0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+      0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+      uint8_t byte = *data++;
+      crc = static_cast<uint16_t>((crc << 4) ^ NIBBLE[(crc >> 12) ^ (byte >> 4)]);
+      crc = static_cast<uint16_t>((crc << 4) ^ NIBBLE[(crc >> 12) ^ (byte & 0x0F)]);
+    }
+    return crc;
+  }
+
+  inline void putLe(uint8_t* p, uint32_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+  }
+
+  inline uint32_t getLe(const uint8_t* p, size_t bytes) {
+    uint32_t v = 0;
+    for (size_t i = 0; i < bytes; i++) v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    return v;
+  }
+
+  inline void encode(const RawSample& s, uint8_t out[FRAME_SIZE]) {
+    out[0] = SYNC_0;
+    out[1] = SYNC_1;
+    putLe(out + 2, s.seq, 4);
+    putLe(out + 6, s.timestampUs, 4);
+    putLe(out + 10, static_cast<uint32_t>(s.raw), 3);
+    putLe(out + 13, crc16(out + 2, 11), 2);
+  }
+
+  // Decoder streaming byte demi byte dengan resinkronisasi
+  class Decoder {
+  public:
+    // Return true jika 'out' berisi frame valid baru
+    bool feed(uint8_t byte, RawSample& out) {
+      if (len_ == 0 && byte != SYNC_0) { skipped_++; return false; }
+      if (len_ == 1 && byte != SYNC_1) {
+        skipped_++;
+        len_ = (byte == SYNC_0) ? 1 : 0;
+        return false;
+      }
+      buf_[len_++] = byte;
+      if (len_ < FRAME_SIZE) return false;
+
+      len_ = 0;
+      if (crc16(buf_ + 2, 11) != getLe(buf_ + 13, 2)) {
+        crcErrors_++;
+        resync();
+        return false;
+      }
+      out.seq = getLe(buf_ + 2, 4);
+      out.timestampUs = getLe(buf_ + 6, 4);
+      uint32_t raw = getLe(buf_ + 10, 3);
+      out.raw = (raw & 0x800000) ? static_cast<int32_t>(raw | 0xFF000000u) : static_cast<int32_t>(raw);
+      frames_++;
+      return true;
+    }
+
+    uint32_t frames() const { return frames_; }
+    uint32_t crcErrors() const { return crcErrors_; }
+    uint32_t skippedBytes() const { return skipped_; }
+
+  private:
+    // Frame rusak: lanjutkan dari sync berikutnya di dalam buffer, bukan
+    // membuang 15 byte sekaligus (frame valid bisa dimulai di tengahnya)
+    void resync() {
+      for (size_t i = 1; i < FRAME_SIZE; i++) {
+        if (buf_[i] != SYNC_0 || (i + 1 < FRAME_SIZE && buf_[i + 1] != SYNC_1)) continue;
+        len_ = FRAME_SIZE - i;
+        memmove(buf_, buf_ + i, len_);
+        return;
+      }
+    }
+
+    uint8_t buf_[FRAME_SIZE];
+    size_t len_ = 0;
+    uint32_t frames_ = 0;
+    uint32_t crcErrors_ = 0;
+    uint32_t skipped_ = 0;
+  };
+}
+
+#endif
@@ -1,24 +1,68 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "FixedWeight.h"
 
 // ==================== CONFIGURATION ====================
 namespace Config {
   // Timing Constants
   constexpr unsigned long WEIGHT_READ_INTERVAL = 100;
   constexpr unsigned long LCD_UPDATE_INTERVAL = 150;
-  constexpr unsigned long WIFI_CHECK_INTERVAL = 15000;
   constexpr unsigned long MQTT_RETRY_INTERVAL = 5000;
-  constexpr unsigned long PING_CHECK_INTERVAL = 10000;
   constexpr unsigned long STATUS_MSG_DURATION = 2000;
   constexpr unsigned long STATUS_DISPLAY_INTERVAL = 1000;
   
   // Hardware Configuration
-  constexpr float CALIBRATION_VALUE = 12.487849f;
-  constexpr float MIN_WEIGHT_THRESHOLD = 0.01f;
-  constexpr float NOISE_GATE_THRESHOLD = 0.01f;
-  constexpr int LOAD_CELL_SAMPLES = 4;
+  constexpr double CALIBRATION_VALUE = 12.487849;   // count per gram
+  constexpr int32_t MG_PER_COUNT_Q16 = FixedWeight::mgPerCountQ16(CALIBRATION_VALUE);
+  
+  // Semua ambang berat dalam miligram (jalur berat fixed-point int32)
+  constexpr int32_t MIN_WEIGHT_THRESHOLD_MG = 10000;
+  constexpr int32_t NOISE_GATE_THRESHOLD_MG = 10000;
+  constexpr int32_t FILTER_HAMPEL_MIN_MG = 5000;       // ambang minimum Hampel (preset Standard/Heavy)
+  constexpr int32_t FILTER_DEADBAND_MG = 5000;         // pita deadband (preset Heavy)
+  
+  // Adaptive Smoothing (default, bisa diubah lewat console 'set' tanpa flash ulang)
+  constexpr int32_t ADAPT_STEP_THRESHOLD_MG = 20000;  // Lompatan > 20 g = beban berubah
+  constexpr int32_t ADAPT_MIN_SHIFT = 0;              // Langsung ikut saat step
+  constexpr int32_t ADAPT_MAX_SHIFT = 5;              // alpha 1/32 saat diam
+  constexpr int32_t ADAPT_SETTLE_SAMPLES = 8;         // 100 ms tenang per tingkat shift
+  
+  // Stability Detection (window 32 konversi = 0.4 detik pada 80 SPS)
+  constexpr size_t STABILITY_WINDOW = 32;
+  constexpr int32_t STABLE_RANGE_MG = 25000;          // maks max-min dalam window
+  constexpr int32_t STABLE_STD_MG = 6000;             // maks simpangan baku dalam window
+  
+  // Auto-Zero Tracking (hanya aktif saat kosong & stabil)
+  constexpr int32_t AZT_ZERO_BAND_MG = 8000;          // < 1 digit layar (10 g)
+  constexpr int32_t AZT_MAX_STEP_MG = 1;              // 1 mg/sampel = 0.08 g/detik, ~20x drift suhu tercepat
+  constexpr int32_t AZT_MAX_CORRECTION_MG = 500000;   // batas total koreksi 500 g
+  constexpr int32_t AZT_PERSIST_DELTA_MG = 2000;      // simpan ke NVS jika bergeser >= 2 g
+  constexpr unsigned long AZT_PERSIST_INTERVAL = 600000; // paling sering 10 menit sekali
+  
+  // Tare tersimpan + re-tare latar belakang (tidak ada lagi tare blocking saat boot)
+  constexpr uint32_t TARE_HOLD_SAMPLES = 160;         // 2 detik stabil di sekitar nol sebelum re-tare
+  constexpr int32_t TARE_MAX_DRIFT_MG = 100000;       // geser > 100 g = ada beban, re-tare ditolak
+  
+  // Kalibrasi Sekuensial (chord tombol 1+3 ditahan, atau console 'cal auto')
+  constexpr int32_t CAL_REFERENCE_G = 1000;           // beban acuan, sama dengan kalibrasi-baru.cpp
+  constexpr int32_t CAL_TOLERANCE_PPM = 500;          // CI 95% faktor <= 0.05% (0.5 g pada 1 kg)
+  constexpr uint32_t CAL_MIN_SAMPLES = 32;            // minimal per fase, satu window stabilitas
+  constexpr uint32_t CAL_MAX_SAMPLES = 2400;          // 30 detik stabil per fase, lalu menyerah
+  constexpr unsigned long CAL_CHORD_HOLD_MS = 2000;
+  
+  // HX711
+  constexpr uint32_t HX711_SPS = 80;          // Pin RATE HX711 di-set ke 80 SPS
+  constexpr unsigned long HX711_TIMEOUT_MS = 500;
+  
+  // Acquisition Task
+  constexpr size_t ACQ_RING_SIZE = 64;        // ~0.8 detik buffer pada 80 SPS (harus pangkat dua)
+  constexpr int ACQ_TASK_CORE = 0;            // loop() Arduino berjalan di core 1
+  constexpr unsigned ACQ_TASK_PRIORITY = 5;
+  constexpr uint32_t ACQ_TASK_STACK = 4096;
+  constexpr unsigned long ACQ_REPORT_INTERVAL = 60000;
   
   // Pin Configuration
   constexpr int PIN_TOMBOL_1 = 27;
@@ -30,8 +74,54 @@ namespace Config {
   constexpr int HX711_SCK = 4;
   
   // Network Configuration
-  constexpr int WIFI_RETRY_COUNT = 20;
+  constexpr unsigned long WIFI_BOOT_TIMEOUT = 10000;  // asosiasi pertama; lewat ini = offline
+  // Link WiFi (WifiLink): event-driven, backoff eksponensial + jitter
+  constexpr unsigned long WIFI_JOIN_TIMEOUT = 8000;   // join tanpa GOT_IP/putus = gagal
+  constexpr unsigned long WIFI_BACKOFF_MIN = 500;     // jeda setelah gagal pertama (sebelum jitter)
+  constexpr unsigned long WIFI_BACKOFF_MAX = 30000;
+  constexpr uint8_t WIFI_FAST_REJOIN_TRIES = 2;       // join ke BSSID cache sebelum scan penuh
   constexpr int HTTP_TIMEOUT = 15000;
+  constexpr size_t SEND_QUEUE_SIZE = 32;             // record antri ke worker jaringan (pangkat dua), 2 batch penuh
+  constexpr int NET_TASK_CORE = 0;                   // bersama stack WiFi, di bawah prioritas akuisisi
+  constexpr unsigned NET_TASK_PRIORITY = 1;
+  constexpr uint32_t NET_TASK_STACK = 8192;          // handshake TLS mbedtls butuh stack besar
+  constexpr unsigned long HTTPS_IDLE_TIMEOUT = 50000; // < keepalive_timeout nginx (75 s)
+  // Salin sesi TLS (termasuk master secret) ke RTC memory agar resumption
+  // bertahan soft reset / WDT reset. Default mati: rahasia sesi tinggal di RAM
+  // yang tidak dihapus reset dan bisa dibaca lewat JTAG / dump memori; aktifkan
+  // hanya jika perangkat terkunci secara fisik dan handshake penuh setelah
+  // reset terasa mahal. Tanpa ini cache sesi hanya di RAM (hilang saat reset).
+  constexpr bool TLS_SESSION_RTC = false;
+  constexpr size_t TLS_SESSION_RTC_BYTES = 2048;      // slot sesi TLS di RTC memory (jika TLS_SESSION_RTC)
+  
+  // Probe keterjangkauan server Laravel (ReachabilityProbe), pengganti ping ICMP
+  constexpr unsigned long PROBE_INTERVAL = 15000;     // selama server terjangkau
+  constexpr unsigned long PROBE_TIMEOUT = 3000;       // connect TCP tanpa jawaban = gagal
+  constexpr unsigned long PROBE_BACKOFF_MIN = 1000;   // setelah gagal: 1, 2, 4, ... s
+  constexpr unsigned long PROBE_BACKOFF_MAX = 60000;
+  constexpr uint16_t PROBE_ONLINE_PERMILLE = 500;     // tingkat sukses (EWMA) untuk online
+  constexpr uint16_t PROBE_OFFLINE_PERMILLE = 300;    // ... dan untuk kembali offline
+  
+  // MQTT QoS 1 (MqttPublisher): beberapa PUBLISH menunggu PUBACK sekaligus
+  constexpr uint16_t MQTT_INFLIGHT_WINDOW = 8;        // packet ID belum di-ack, maksimal
+  constexpr size_t MQTT_QUEUE_SIZE = 16;              // pesan antri + in-flight (pangkat dua)
+  constexpr size_t MQTT_MAX_PAYLOAD = 256;            // laporan boot paling panjang
+  constexpr uint16_t MQTT_KEEPALIVE_S = 15;
+  constexpr unsigned long MQTT_CONNECT_TIMEOUT = 3000; // DNS + TCP connect, lalu CONNACK
+  constexpr unsigned long MQTT_ACK_TIMEOUT = 10000;    // PUBACK tak kunjung datang = koneksi mati
+  constexpr bool MQTT_BINARY_RECORDS = false;         // true: RecordCodec ke MQTT_BIN_TOPIC, bukan JSON
+  constexpr unsigned long MQTT_REPLAY_INTERVAL = 1000; // coba ulang record yang ditolak antrean MQTT penuh
+  
+  // Upload batch (SERVER_URL + "/batch"): N record per POST, N adaptif (BatchSizer)
+  constexpr uint16_t BATCH_MAX_RECORDS = 16;          // body JSON ~1 KB
+  constexpr unsigned long BATCH_LINGER_MS = 150;      // tunggu record lain setelah record pertama
+  constexpr uint32_t BATCH_TARGET_MS = 2000;          // RTT per POST yang dituju, << HTTP_TIMEOUT
+  
+  // Jurnal offline (LittleFS): record disimpan dulu, dikirim berurutan saat online
+  // 1820 record x 36 byte (RecordJournal::ENTRY_SIZE, dicek static_assert) ~64 KB, beberapa hari offline
+  constexpr uint32_t JOURNAL_MAX_BYTES = 1820 * 36;
+  constexpr unsigned long JOURNAL_RETRY_MS = 5000;     // jeda kirim ulang setelah upload gagal
+  constexpr uint32_t JOURNAL_FORWARD_PER_TICK = 4;     // baca flash per tick saat mengisi antrean kirim
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "DeviceProfile.h"
+#include <ctype.h>
+#include <string.h>
+#include "Config.h"
+#include "Settings.h"
+
+// ==================== TABEL PRESET ====================
+// Salinan faktor-kalibrasi.txt (count per gram, format HX711_ADC)
+struct ProfilePreset {
+  const char* fakultas;
+  double countsPerGram;
+  int32_t mgPerCountQ16;
+};
+
+#define PROFILE_PRESET(name, factor) { name, factor, FixedWeight::mgPerCountQ16(factor) }
+
+static const ProfilePreset PRESET_TABLE[] = {
+  PROFILE_PRESET("FIB",   12.1604963),
+  PROFILE_PRESET("FT",    12.244260),
+  PROFILE_PRESET("FISIP", 12.2066126),
+  PROFILE_PRESET("FPsi",  12.3382398),
+  PROFILE_PRESET("TPST",  12.259820),
+  PROFILE_PRESET("FKM",   12.01),
+  PROFILE_PRESET("FSM",   12.333372),
+};
+
+#undef PROFILE_PRESET
+
+static const char* PROFILE_KEY = "profile";
+static constexpr uint8_t PROFILE_BLOB_VERSION = 1;
+
+// Layout record di NVS (16 byte, little-endian)
+struct ProfileBlob {
+  uint8_t version;
+  uint8_t preset;
+  uint8_t reserved[2];
+  char fakultas[8];
+  int32_t mgPerCountQ16;
+};
+
+// ==================== IMPLEMENTASI FUNGSI ====================
+
+void defaultDeviceProfile(DeviceProfile& out) {
+  out.preset = DeviceProfile::CUSTOM;
+  copyText(out.fakultas, "FPsi");
+  out.mgPerCountQ16 = Config::MG_PER_COUNT_Q16;
+}
+
+size_t profilePresetCount() {
+  return sizeof(PRESET_TABLE) / sizeof(PRESET_TABLE[0]);
+}
+
+bool profileFromPreset(size_t index, DeviceProfile& out) {
+  if (index >= profilePresetCount()) return false;
+  out.preset = static_cast<uint8_t>(index);
+  copyText(out.fakultas, PRESET_TABLE[index].fakultas);
+  out.mgPerCountQ16 = PRESET_TABLE[index].mgPerCountQ16;
+  return true;
+}
+
+int findProfilePreset(const char* fakultas) {
+  for (size_t i = 0; i < profilePresetCount(); i++) {
+    const char* a = PRESET_TABLE[i].fakultas;
+    const char* b = fakultas;
+    while (*a && tolower(static_cast<unsigned char>(*a)) == tolower(static_cast<unsigned char>(*b))) { a++; b++; }
+    if (*a == '\0' && *b == '\0') return static_cast<int>(i);
+  }
+  return -1;
+}
+
+double profilePresetFactor(size_t index) {
+  return index < profilePresetCount() ? PRESET_TABLE[index].countsPerGram : 0.0;
+}
+
+const char* profilePresetName(size_t index) {
+  return index < profilePresetCount() ? PRESET_TABLE[index].fakultas : nullptr;
+}
+
+bool makeCustomProfile(const char* fakultas, double countsPerGram, DeviceProfile& out) {
+  // Batas wajar untuk sel beban 50-200 kg di HX711 gain 128
+  if (fakultas[0] == '\0' || countsPerGram < 1.0 || countsPerGram > 1000.0) return false;
+  out.preset = DeviceProfile::CUSTOM;
+  copyText(out.fakultas, fakultas);
+  out.mgPerCountQ16 = FixedWeight::mgPerCountQ16(countsPerGram);
+  return true;
+}
+
+bool loadDeviceProfile(DeviceProfile& out) {
+  ProfileBlob blob;
+  if (!loadPersistedBlob(PROFILE_KEY, &blob, sizeof(blob)) ||
+      blob.version != PROFILE_BLOB_VERSION || blob.mgPerCountQ16 <= 0) {
+    defaultDeviceProfile(out);
+    return false;
+  }
+  out.preset = blob.preset;
+  blob.fakultas[sizeof(blob.fakultas) - 1] = '\0';
+  copyText(out.fakultas, blob.fakultas);
+  out.mgPerCountQ16 = blob.mgPerCountQ16;
+  return true;
+}
+
+bool saveDeviceProfile(const DeviceProfile& profile) {
+  ProfileBlob blob = {};
+  blob.version = PROFILE_BLOB_VERSION;
+  blob.preset = profile.preset;
+  copyText(blob.fakultas, profile.fakultas);
+  blob.mgPerCountQ16 = profile.mgPerCountQ16;
+  return savePersistedBlob(PROFILE_KEY, &blob, sizeof(blob));
+}
@@ -0,0 +1,40 @@
+#ifndef DEVICE_PROFILE_H
+#define DEVICE_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ==================== PROFIL PERANGKAT ====================
+// Identitas lokasi (fakultas) + faktor kalibrasi dasar, dimuat dari NVS saat
+// boot. Satu binary melayani semua lokasi: pindah lokasi cukup lewat menu
+// maintenance (tahan tombol 4 saat boot) atau console 'profile', tanpa build
+// ulang. Preset diambil dari faktor-kalibrasi.txt.
+
+struct DeviceProfile {
+  static constexpr uint8_t CUSTOM = 0xFF;   // faktor diset manual, bukan preset
+
+  uint8_t preset = CUSTOM;
+  char fakultas[8] = "";
+  int32_t mgPerCountQ16 = 0;
+};
+
+// Profil bawaan (Config::CALIBRATION_VALUE, "FPsi"): perilaku firmware lama
+void defaultDeviceProfile(DeviceProfile& out);
+
+size_t profilePresetCount();
+bool profileFromPreset(size_t index, DeviceProfile& out);
+// Indeks preset berdasarkan nama fakultas (tidak peka huruf besar), -1 jika tidak ada
+int findProfilePreset(const char* fakultas);
+// Faktor preset dalam count per gram (hanya untuk tampilan)
+double profilePresetFactor(size_t index);
+// Nama fakultas preset persis seperti di tabel, nullptr jika indeks di luar tabel
+const char* profilePresetName(size_t index);
+
+// Profil kustom: nama bebas (maks 7 karakter) + faktor count per gram
+bool makeCustomProfile(const char* fakultas, double countsPerGram, DeviceProfile& out);
+
+// Record NVS 16 byte (key "profile"). load mengisi default jika belum ada.
+bool loadDeviceProfile(DeviceProfile& out);
+bool saveDeviceProfile(const DeviceProfile& profile);
+
+#endif
@@ -38,11 +38,11 @@ void initializeLCD(LiquidCrystal_I2C& lcd) {
   }
 }
 
-void updateWeightDisplay(float weight) {
+void updateWeightDisplay(int32_t weightMg) {
   if (internalBigNumbers == nullptr) return; // Safety check
 
   char buffer[10];
-  snprintf(buffer, sizeof(buffer), "%6.2f", weight);
+  FixedWeight::formatKg(buffer, sizeof(buffer), weightMg, 6);
   
   internalBigNumbers->setBigNumberCursor(1, 1);
   internalBigNumbers->print(buffer);
@@ -51,7 +51,8 @@ void updateWeightDisplay(float weight) {
 void restoreDefaultDisplay(LiquidCrystal_I2C& lcd, const SystemState& state) {
   lcd.clear();
   lcd.setCursor(0, 0);
-  lcd.print("Jenis: " + state.waste.getDisplayName());
+  lcd.print("Jenis: ");
+  lcd.print(state.waste.getDisplayName());
   lcd.setCursor(17, 1);
   lcd.print("kg");
 }
@@ -89,8 +90,15 @@ void updateStatusIndicators(LiquidCrystal_I2C& lcd, bool isOffline, bool mqttCon
   }
 }
 
+void updateStabilityIndicator(LiquidCrystal_I2C& lcd, bool isStable) {
+  lcd.setCursor(19, 1);
+  lcd.print(isStable ? " " : "~");
+}
+
 void showStatusMessage(LiquidCrystal_I2C& lcd, const char* msg) {
+  // Tepat 20 kolom: pesan lebih panjang dipotong, tidak tumpah ke baris 2
+  char line[21];
+  snprintf(line, sizeof(line), "%-20.20s", msg);
   lcd.setCursor(0, 0);
-  lcd.print(msg);
-  for (int i = strlen(msg); i < 20; i++) lcd.print(" ");
+  lcd.print(line);
 }
\ No newline at end of file
@@ -14,8 +14,8 @@
 // Inisialisasi LCD dan internal BigNumbers
 void initializeLCD(LiquidCrystal_I2C& lcd);
 
-// Menampilkan angka berat (BigNumbers dikelola secara internal di .cpp)
-void updateWeightDisplay(float weight);
+// Menampilkan angka berat dalam kg dari nilai miligram (BigNumbers dikelola secara internal di .cpp)
+void updateWeightDisplay(int32_t weightMg);
 
 // Kembali ke tampilan default
 void restoreDefaultDisplay(LiquidCrystal_I2C& lcd, const SystemState& state);
@@ -26,6 +26,9 @@ void showSubtypeSelection(LiquidCrystal_I2C& lcd);
 // Update indikator (WiFi, MQTT, dll)
 void updateStatusIndicators(LiquidCrystal_I2C& lcd, bool isOffline, bool mqttConnected);
 
+// Penanda stabil di pojok kanan baris berat ('~' = beban masih bergerak)
+void updateStabilityIndicator(LiquidCrystal_I2C& lcd, bool isStable);
+
 // Tampilkan pesan status
 void showStatusMessage(LiquidCrystal_I2C& lcd, const char* msg);
 
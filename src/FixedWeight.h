@@ -0,0 +1,69 @@
+#ifndef FIXED_WEIGHT_H
+#define FIXED_WEIGHT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ==================== JALUR BERAT FIXED-POINT ====================
+// Berat dibawa dari raw count sampai layar/payload sebagai int32 miligram.
+// Kalibrasi diterapkan sebagai pengali Q16 (mg per count * 2^16), sehingga
+// tidak ada soft-float maupun printf("%f") di jalur per sampel, dan hasilnya
+// bit-exact antara ESP32 dan build host.
+// Rentang int32 mg = +/- 2147 kg, jauh di atas kapasitas timbangan.
+
+namespace FixedWeight {
+
+  constexpr int Q = 16;
+
+  // Faktor kalibrasi (count per gram, format HX711_ADC) -> mg per count dalam Q16.
+  // constexpr agar dihitung saat compile dari Config::CALIBRATION_VALUE.
+  constexpr int32_t mgPerCountQ16(double countsPerGram) {
+    return static_cast<int32_t>(1000.0 * (1 << Q) / countsPerGram + 0.5);
+  }
+
+  // Net count (raw - tare) -> miligram, dibulatkan ke terdekat
+  inline int32_t countsToMg(int32_t netCounts, int32_t mgPerCountQ16) {
+    int64_t scaled = static_cast<int64_t>(netCounts) * mgPerCountQ16;
+    scaled += (scaled >= 0) ? (1 << (Q - 1)) : -(1 << (Q - 1));
+    return static_cast<int32_t>(scaled / (1 << Q));
+  }
+
+  // Format mg -> teks kg 2 desimal ("12.34"), rata kanan sampai 'width'
+  // karakter (0 = tanpa padding). Pengganti snprintf("%*.2f") tanpa float;
+  // bedanya nilai yang dibulatkan ke nol tidak pernah tampil "-0.00".
+  // Return panjang string, buffer selalu diterminasi '\0'.
+  inline size_t formatKg(char* buf, size_t len, int32_t mg, size_t width = 0) {
+    if (len == 0) return 0;
+
+    // Bulatkan ke 10 g (0.01 kg), half away from zero seperti printf
+    bool negative = mg < 0;
+    uint32_t mag = negative ? static_cast<uint32_t>(-(int64_t)mg) : static_cast<uint32_t>(mg);
+    uint32_t centiKg = (mag + 5000) / 10000;
+    if (centiKg == 0) negative = false;
+
+    // Susun digit dari belakang
+    char tmp[16];
+    size_t n = 0;
+    tmp[n++] = static_cast<char>('0' + centiKg % 10);
+    tmp[n++] = static_cast<char>('0' + (centiKg / 10) % 10);
+    tmp[n++] = '.';
+    uint32_t whole = centiKg / 100;
+    do {
+      tmp[n++] = static_cast<char>('0' + whole % 10);
+      whole /= 10;
+    } while (whole > 0);
+    if (negative) tmp[n++] = '-';
+
+    size_t pad = (width > n) ? width - n : 0;
+    size_t total = pad + n;
+    if (total >= len) total = len - 1;
+
+    size_t out = 0;
+    for (; out < pad && out < total; out++) buf[out] = ' ';
+    while (out < total) buf[out++] = tmp[--n];
+    buf[out] = '\0';
+    return out;
+  }
+}
+
+#endif
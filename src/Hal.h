@@ -0,0 +1,169 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Types.h"
+
+// ==================== HARDWARE ABSTRACTION ====================
+// Antarmuka tipis antara logika aplikasi (ScaleApp, WeighingPipeline,
+// Settings) dan perangkat keras. Implementasi ESP32 ada di HalEsp32.*,
+// implementasi simulasi untuk env 'native' ada di sim/HalSim.*.
+// Logika aplikasi tidak boleh meng-include Arduino.h secara langsung.
+
+namespace Hal {
+
+  // LCD 20x4: semua tata letak tetap ditentukan oleh implementasi
+  class Display {
+  public:
+    virtual ~Display() {}
+    virtual void showWeight(int32_t weightMg) = 0;
+    virtual void showDefault(const SystemState& state) = 0;
+    virtual void showSubtypeSelection() = 0;
+    virtual void showStatusIndicators(bool isOffline, bool mqttConnected) = 0;
+    virtual void showStability(bool isStable) = 0;
+    virtual void showStatusMessage(const char* msg) = 0;
+    // Layar teks penuh 4 baris (menu maintenance); nullptr = baris kosong
+    virtual void showLines(const char* r0, const char* r1, const char* r2, const char* r3) = 0;
+  };
+
+  // Empat tombol panel. isPressed() true satu kali per tekanan (edge),
+  // berlaku sampai update() berikutnya.
+  class Buttons {
+  public:
+    static constexpr uint8_t COUNT = 4;
+    virtual ~Buttons() {}
+    virtual void update() = 0;
+    virtual bool isPressed(uint8_t index) = 0;
+    // Level saat ini (true = sedang ditekan), untuk tombol yang ditahan
+    virtual bool isDown(uint8_t index) = 0;
+  };
+
+  class Buzzer {
+  public:
+    virtual ~Buzzer() {}
+    virtual void tone(uint16_t freq, uint16_t durationMs) = 0;
+  };
+
+  // Sumber konversi HX711 (task akuisisi di perangkat, skrip di simulasi)
+  class SampleSource {
+  public:
+    virtual ~SampleSource() {}
+    virtual bool pop(RawSample& out) = 0;
+    virtual AcquisitionStats stats() = 0;
+  };
+
+  // Penerima salinan setiap konversi mentah (mode capture), sebelum diproses
+  class SampleTap {
+  public:
+    virtual ~SampleTap() {}
+    virtual void onSample(const RawSample& sample) = 0;
+  };
+
+  // WiFi + Laravel + MQTT. Upload berjalan di luar loop utama: enqueue()
+  // langsung kembali, hasilnya diambil lewat pollResult() di tick berikutnya.
+  class Uplink {
+  public:
+    virtual ~Uplink() {}
+    // Reconnect berkala; meng-update state.offlineMode / state.isOnline
+    virtual void maintain(SystemState& state, uint32_t now) = 0;
+    virtual bool mqttConnected() = 0;
+    // Feed live (MQTT QoS 1) satu kali per penimbangan, terpisah dari upload
+    // jurnal. Return false jika antrean MQTT penuh; ScaleApp mengulangnya
+    // dari jurnal selama record belum di-ack Laravel.
+    // 'seq' = nomor urut jurnal, ikut di payload biner (RecordCodec).
+    virtual bool publish(uint32_t seq, const WeighingRecord& record) = 0;
+    // Masukkan record ke antrian upload. Return 0 jika antrian penuh,
+    // selain itu nomor urut record (muncul lagi di SendResult::id)
+    virtual uint32_t enqueue(const WeighingRecord& record) = 0;
+    // Ambil satu hasil upload yang sudah selesai. Return false jika belum ada.
+    virtual bool pollResult(SendResult& out) = 0;
+    // Record yang masih antri atau sedang dikirim
+    virtual size_t pending() = 0;
+  };
+
+  // Penyimpanan key/value yang bertahan setelah reboot (NVS)
+  class Storage {
+  public:
+    virtual ~Storage() {}
+    virtual int32_t getInt(const char* key, int32_t defaultValue) = 0;
+    virtual bool putInt(const char* key, int32_t value) = 0;
+    // Blob berukuran tetap; getBlob false jika key tidak ada atau ukurannya beda
+    virtual bool getBlob(const char* key, void* out, size_t len) = 0;
+    virtual bool putBlob(const char* key, const void* data, size_t len) = 0;
+    virtual bool remove(const char* key) = 0;
+  };
+
+  // Radio WiFi station. join() tidak menunggu; hasilnya datang sebagai event
+  // (dari task WiFi di perangkat) yang diambil pollEvent() dari loop.
+  class WifiRadio {
+  public:
+    enum class EventType : uint8_t { ASSOCIATED, GOT_IP, DISCONNECTED };
+    struct Event {
+      EventType type;
+      uint8_t reason;           // alasan DISCONNECTED (kode 802.11 / ESP-IDF)
+    };
+    // AP tujuan rejoin cepat: langsung ke kanal + BSSID ini tanpa scan
+    struct Bss {
+      uint8_t bssid[6];
+      uint8_t channel;
+    };
+    virtual ~WifiRadio() {}
+    // hint == nullptr: scan semua kanal. Membatalkan join yang sedang berjalan.
+    virtual void join(const Bss* hint) = 0;
+    virtual bool pollEvent(Event& out) = 0;
+    // AP yang sedang tersambung (valid setelah ASSOCIATED)
+    virtual bool currentBss(Bss& out) = 0;
+  };
+
+  // Connect TCP tanpa blok, untuk probe keterjangkauan server. start()
+  // memulai DNS + SYN lalu langsung kembali; poll() tiap loop sampai selesai.
+  class Connector {
+  public:
+    enum class Status : uint8_t { PENDING, CONNECTED, FAILED };
+    virtual ~Connector() {}
+    // Return false jika gagal seketika (DNS gagal, socket habis)
+    virtual bool start(const char* host, uint16_t port) = 0;
+    virtual Status poll() = 0;
+    // Tutup koneksi, tersambung atau masih pending
+    virtual void close() = 0;
+  };
+
+  // Koneksi TCP ke broker MQTT. connect() tidak menunggu, sama seperti
+  // Connector: memulai DNS + SYN lalu kembali, hasilnya diambil poll() tiap
+  // loop. Setelah tersambung read() dan write() juga tidak pernah menunggu.
+  class Socket {
+  public:
+    virtual ~Socket() {}
+    // Return false jika gagal seketika (DNS gagal, socket habis)
+    virtual bool connect(const char* host, uint16_t port) = 0;
+    // PENDING selama DNS / connect berjalan, lalu CONNECTED atau FAILED
+    virtual Connector::Status poll() = 0;
+    virtual void stop() = 0;
+    virtual bool connected() = 0;
+    // Byte yang sudah tersedia, maksimal 'len'. Return 0 jika belum ada.
+    virtual size_t read(uint8_t* buf, size_t len) = 0;
+    // Return false jika tidak semua byte diterima stack TCP
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+  };
+
+  // File append-only (LittleFS di perangkat). Setiap operasi selesai
+  // (ter-commit) sebelum kembali; path absolut, mis. "/journal.bin".
+  class FileStore {
+  public:
+    virtual ~FileStore() {}
+    // Ukuran file dalam byte, -1 jika belum ada
+    virtual int32_t size(const char* path) = 0;
+    virtual bool append(const char* path, const void* data, size_t len) = 0;
+    // Baca tepat 'len' byte mulai 'offset'. Return false jika kurang.
+    virtual bool read(const char* path, uint32_t offset, void* out, size_t len) = 0;
+    // Potong file menjadi 'len' byte (buang ekor rusak)
+    virtual bool truncate(const char* path, uint32_t len) = 0;
+    virtual bool remove(const char* path) = 0;
+  };
+}
+
+// Log teks ke Serial (perangkat) atau stdout (native)
+void logPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif
@@ -0,0 +1,551 @@
+#include "HalEsp32.h"
+#include <WiFi.h>
+#include <Preferences.h>
+#include <LittleFS.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <lwip/dns.h>
+#include <lwip/sockets.h>
+#include <lwip/tcpip.h>
+
+#include "Config.h"
+#include "DisplayHandler.h"
+#include "NetworkHandler.h"
+#include "Acquisition.h"
+#include "CaptureFrame.h"
+
+// ==================== DISPLAY ====================
+
+void LcdDisplay::showWeight(int32_t weightMg) { updateWeightDisplay(weightMg); }
+void LcdDisplay::showDefault(const SystemState& state) { restoreDefaultDisplay(lcd_, state); }
+void LcdDisplay::showSubtypeSelection() { ::showSubtypeSelection(lcd_); }
+void LcdDisplay::showStatusIndicators(bool isOffline, bool mqttConnected) {
+  updateStatusIndicators(lcd_, isOffline, mqttConnected);
+}
+void LcdDisplay::showStability(bool isStable) { updateStabilityIndicator(lcd_, isStable); }
+void LcdDisplay::showStatusMessage(const char* msg) { ::showStatusMessage(lcd_, msg); }
+void LcdDisplay::showLines(const char* r0, const char* r1, const char* r2, const char* r3) {
+  const char* rows[] = { r0, r1, r2, r3 };
+  lcd_.clear();
+  for (uint8_t r = 0; r < 4; r++) {
+    if (rows[r] == nullptr) continue;
+    lcd_.setCursor(0, r);
+    lcd_.print(rows[r]);
+  }
+}
+
+// ==================== TOMBOL & BUZZER ====================
+
+void EzButtonPanel::update() {
+  for (uint8_t i = 0; i < Hal::Buttons::COUNT; i++) buttons_[i].loop();
+}
+
+bool EzButtonPanel::isPressed(uint8_t index) {
+  return index < Hal::Buttons::COUNT && buttons_[index].isPressed();
+}
+
+bool EzButtonPanel::isDown(uint8_t index) {
+  // INPUT_PULLUP: LOW = ditekan
+  return index < Hal::Buttons::COUNT && buttons_[index].getState() == LOW;
+}
+
+void PinBuzzer::tone(uint16_t freq, uint16_t durationMs) {
+  ::tone(Config::PIN_BUZZER, freq, durationMs);
+}
+
+// ==================== AKUISISI ====================
+
+bool AcquisitionSource::pop(RawSample& out) { return popSample(out); }
+AcquisitionStats AcquisitionSource::stats() { return getAcquisitionStats(); }
+
+void SerialCaptureTap::onSample(const RawSample& sample) {
+  uint8_t frame[Capture::FRAME_SIZE];
+  Capture::encode(sample, frame);
+  Serial.write(frame, sizeof(frame));
+}
+
+// ==================== NETWORK ====================
+
+EspWifiRadio* EspWifiRadio::instance_ = nullptr;
+
+void EspWifiRadio::begin() {
+  instance_ = this;
+  WiFi.persistent(false);         // SSID/BSSID dikelola WifiLink, bukan flash WiFi
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);   // reconnect hanya lewat WifiLink (backoff + jitter)
+#ifdef WIFI_STATIC_IP
+  // IP statis lewat build flag (lewati DHCP), mis.
+  //   -D WIFI_STATIC_IP=\"192.168.1.60\" -D WIFI_GATEWAY=\"192.168.1.1\"
+  //   -D WIFI_SUBNET=\"255.255.255.0\" -D WIFI_DNS=\"192.168.1.1\"
+  IPAddress ip, gateway, subnet, dns;
+  ip.fromString(WIFI_STATIC_IP);
+  gateway.fromString(WIFI_GATEWAY);
+  subnet.fromString(WIFI_SUBNET);
+  dns.fromString(WIFI_DNS);
+  WiFi.config(ip, gateway, subnet, dns);
+#endif
+  WiFi.onEvent(onEvent);
+}
+
+void EspWifiRadio::onEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+  // Task event WiFi (produsen tunggal ring events_), jangan blok di sini
+  EspWifiRadio* self = instance_;
+  if (self == nullptr) return;
+  Hal::WifiRadio::Event ev = { EventType::DISCONNECTED, 0 };
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+      ev.type = EventType::ASSOCIATED;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      ev.type = EventType::GOT_IP;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      ev.reason = info.wifi_sta_disconnected.reason;
+      // Putus karena join() sendiri membatalkan percobaan lama: bukan kegagalan
+      if (self->leaving_.exchange(false)) return;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      break;
+    default:
+      return;
+  }
+  self->events_.push(ev);
+}
+
+void EspWifiRadio::join(const Bss* hint) {
+  // Hanya sesi yang tersambung memicu event DISCONNECTED saat ditinggalkan
+  if (WiFi.status() == WL_CONNECTED) {
+    leaving_.store(true);
+    WiFi.disconnect(false, false);
+  }
+  if (hint != nullptr) WiFi.begin(WIFI_SSID, WIFI_PASSWORD, hint->channel, hint->bssid);
+  else WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+}
+
+bool EspWifiRadio::pollEvent(Event& out) {
+  return events_.pop(out);
+}
+
+bool EspWifiRadio::currentBss(Bss& out) {
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid == nullptr) return false;
+  memcpy(out.bssid, bssid, sizeof(out.bssid));
+  out.channel = static_cast<uint8_t>(WiFi.channel());
+  return out.channel != 0;
+}
+
+void NetworkUplink::finishBootReport(const SystemState& state, uint32_t now) {
+  char payload[256];
+  boot_->mark("mqtt", now);
+  boot_->report();
+  if (boot_->toJson(payload, sizeof(payload), state.fakultas) > 0) sendBootReport(mqtt_, payload);
+  boot_ = nullptr;
+}
+
+void NetworkUplink::maintain(SystemState& state, uint32_t now) {
+  link_.tick(now);
+  if (link_.up() != linkUp_) {
+    linkUp_ = link_.up();
+    if (linkUp_) {
+      Serial.print("WiFi Connected, IP: ");
+      Serial.println(WiFi.localIP());
+      if (boot_ != nullptr && !bootWifiMarked_) boot_->mark("wifi", now);
+      bootWifiMarked_ = true;
+    } else {
+      logPrintf("WiFi putus (alasan %u), rejoin\n", link_.lastReason());
+    }
+  }
+  if (!link_.everUp() && !bootTimeoutLogged_ && now > Config::WIFI_BOOT_TIMEOUT) {
+    bootTimeoutLogged_ = true;
+    Serial.println("WiFi Gagal saat boot, lanjut offline");
+  }
+
+  // offlineMode = WiFi putus atau server Laravel tidak terjangkau (probe)
+  const bool wasOffline = state.offlineMode;
+  if (link_.up()) {
+    probe_.tick(now);
+    state.offlineMode = !probe_.reachable();
+  } else {
+    probe_.linkDown();
+    state.offlineMode = true;
+  }
+  state.isOnline = !state.offlineMode;
+  if (wasOffline && !state.offlineMode) link_.markOnline(now);
+  if (wasOffline != state.offlineMode) {
+    logPrintf("Server %s (sukses %u%%, RTT~%lums)\n", state.offlineMode ? "tidak terjangkau" : "terjangkau",
+              probe_.successPermille() / 10, (unsigned long)probe_.smoothedRttMs());
+  }
+
+  // Broker MQTT tidak bergantung pada server Laravel: dilayani selama WiFi
+  // tersambung, juga saat probe Laravel gagal. Reconnect (dengan jeda
+  // MQTT_RETRY_INTERVAL) diatur MqttPublisher sendiri.
+  if (link_.up()) {
+    mqtt_.loop(now);
+    if (boot_ != nullptr && mqtt_.connected()) finishBootReport(state, now);
+  }
+}
+
+bool NetworkUplink::mqttConnected() { return mqtt_.connected(); }
+
+bool NetworkUplink::publish(uint32_t seq, const WeighingRecord& record) {
+  return sendToMQTT(mqtt_, seq, record);
+}
+
+bool NetworkUplink::begin() {
+  // Client ID tetap per perangkat: sesi persisten broker mengikuti ID ini
+  char clientId[24];
+  snprintf(clientId, sizeof(clientId), "ecoscale-%012llx", (unsigned long long)ESP.getEfuseMac());
+  mqtt_.setClientId(clientId);
+
+  char host[64];
+  uint16_t port = 0;
+  if (laravelEndpoint(host, sizeof(host), port)) probe_.setTarget(host, port);
+
+  // Join pertama (BSSID cache dari NVS jika ada); hasilnya lewat event
+  radio_.begin();
+  link_.begin(millis(), static_cast<uint32_t>(ESP.getEfuseMac() >> 16));
+
+  BaseType_t ok = xTaskCreatePinnedToCore(
+      workerTask, "net", Config::NET_TASK_STACK, this,
+      Config::NET_TASK_PRIORITY, &worker_, Config::NET_TASK_CORE);
+  return ok == pdPASS;
+}
+
+size_t NetworkUplink::collectBatch(Job* jobs, size_t limit) {
+  size_t count = 0;
+  unsigned long first = 0;
+  while (count < limit) {
+    if (outbox_.pop(jobs[count])) {
+      if (count++ == 0) first = millis();
+      continue;
+    }
+    if (count == 0) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+    // Beri kesempatan record lain menyusul, tapi record pertama tidak ditahan lama
+    unsigned long waited = millis() - first;
+    if (waited >= Config::BATCH_LINGER_MS) break;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Config::BATCH_LINGER_MS - waited));
+  }
+  return count;
+}
+
+void NetworkUplink::workerTask(void* self) {
+  NetworkUplink& uplink = *static_cast<NetworkUplink*>(self);
+  // Statis: stack worker disisakan untuk handshake TLS
+  static Job jobs[Config::BATCH_MAX_RECORDS];
+  static WeighingRecord records[Config::BATCH_MAX_RECORDS];
+  static bool accepted[Config::BATCH_MAX_RECORDS];
+  for (;;) {
+    size_t count = uplink.collectBatch(jobs, uplink.sizer_.limit());
+    for (size_t i = 0; i < count; i++) records[i] = jobs[i].record;
+
+    unsigned long start = millis();
+    bool ok = sendBatchToLaravel(records, count, accepted);
+    uint32_t elapsed = millis() - start;
+    uplink.sizer_.onBatch(count, elapsed, ok);
+
+    for (size_t i = 0; i < count; i++) {
+      SendResult result;
+      result.id = jobs[i].id;
+      result.record = jobs[i].record;
+      result.ok = accepted[i];
+      result.elapsedMs = elapsed;
+      // results_ sama besar dengan outbox_ dan dikuras tiap tick, jadi tidak penuh
+      uplink.results_.push(result);
+      uplink.pending_--;
+    }
+  }
+}
+
+uint32_t NetworkUplink::enqueue(const WeighingRecord& record) {
+  Job job = { nextId_, record };
+  if (worker_ == nullptr) return 0;
+  pending_++;   // sebelum push: worker bisa selesai sebelum baris berikutnya
+  if (!outbox_.push(job)) {
+    pending_--;
+    return 0;
+  }
+  xTaskNotifyGive(worker_);
+  return nextId_++;
+}
+
+bool NetworkUplink::pollResult(SendResult& out) {
+  return results_.pop(out);
+}
+
+// ==================== PROBE CONNECT ====================
+
+void LwipConnector::onDnsFound(const char*, const ip_addr_t* addr, void* arg) {
+  // Dipanggil dari task tcpip; hanya menulis hasil, poll() yang membaca
+  LwipConnector* self = static_cast<LwipConnector*>(arg);
+  if (addr != nullptr) {
+    self->addr_ = *addr;
+    self->dns_.store(DNS_OK);
+  } else {
+    self->dns_.store(DNS_FAILED);
+  }
+}
+
+bool LwipConnector::start(const char* host, uint16_t port) {
+  close();
+  failed_ = false;
+  port_ = port;
+  if (strcmp(host, host_) != 0) {
+    copyText(host_, host);
+    addrValid_ = false;
+  }
+  if (addrValid_) return beginConnect();
+  // Callback DNS lama yang masih tertunda tidak boleh menimpa hasil baru
+  if (dns_.load() == DNS_PENDING) return true;
+
+  dns_.store(DNS_PENDING);
+#if LWIP_TCPIP_CORE_LOCKING
+  LOCK_TCPIP_CORE();
+#endif
+  err_t err = dns_gethostbyname(host_, &addr_, onDnsFound, this);
+#if LWIP_TCPIP_CORE_LOCKING
+  UNLOCK_TCPIP_CORE();
+#endif
+  if (err == ERR_OK) {
+    dns_.store(DNS_OK);
+  } else if (err != ERR_INPROGRESS) {
+    dns_.store(DNS_IDLE);
+    return false;
+  }
+  return true;
+}
+
+bool LwipConnector::beginConnect() {
+  fd_ = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd_ < 0) return false;
+  lwip_fcntl(fd_, F_SETFL, lwip_fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+  // Tutup dengan RST: tidak meninggalkan PCB TIME_WAIT tiap probe
+  struct linger lin = { 1, 0 };
+  lwip_setsockopt(fd_, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port_);
+  sa.sin_addr.s_addr = ip4_addr_get_u32(ip_2_ip4(&addr_));
+  if (lwip_connect(fd_, reinterpret_cast<struct sockaddr*>(&sa), sizeof(sa)) < 0 && errno != EINPROGRESS) {
+    close();
+    addrValid_ = false;
+    return false;
+  }
+  return true;
+}
+
+Hal::Connector::Status LwipConnector::poll() {
+  if (failed_) return Status::FAILED;
+  if (fd_ < 0) {
+    uint8_t dns = dns_.load();
+    if (dns == DNS_PENDING) return Status::PENDING;
+    if (dns == DNS_FAILED || dns == DNS_IDLE) {
+      dns_.store(DNS_IDLE);
+      failed_ = true;
+      return Status::FAILED;
+    }
+    dns_.store(DNS_IDLE);
+    addrValid_ = true;
+    if (!beginConnect()) {
+      failed_ = true;
+      return Status::FAILED;
+    }
+  }
+
+  // select() dengan timeout 0: hanya melihat status, tidak menunggu
+  fd_set writable;
+  FD_ZERO(&writable);
+  FD_SET(fd_, &writable);
+  struct timeval zero = { 0, 0 };
+  if (lwip_select(fd_ + 1, nullptr, &writable, nullptr, &zero) <= 0) return Status::PENDING;
+
+  int error = 0;
+  socklen_t len = sizeof(error);
+  lwip_getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+  if (error == 0) {
+    connected_ = true;
+    return Status::CONNECTED;
+  }
+  // Alamat cache mungkin basi (server pindah IP): close() me-resolve ulang
+  failed_ = true;
+  return Status::FAILED;
+}
+
+int LwipConnector::detach() {
+  if (fd_ < 0 || !connected_) return -1;
+  int fd = fd_;
+  fd_ = -1;
+  connected_ = false;
+  return fd;
+}
+
+void LwipConnector::close() {
+  // Connect yang tidak pernah tersambung (timeout): resolve ulang berikutnya
+  if (fd_ >= 0 && !connected_) addrValid_ = false;
+  if (fd_ >= 0) lwip_close(fd_);
+  fd_ = -1;
+  connected_ = false;
+}
+
+// ==================== SOCKET ====================
+
+bool LwipSocket::connect(const char* host, uint16_t port) {
+  stop();
+  return connector_.start(host, port);
+}
+
+Hal::Connector::Status LwipSocket::poll() {
+  if (fd_ >= 0) return Hal::Connector::Status::CONNECTED;
+  Hal::Connector::Status status = connector_.poll();
+  if (status != Hal::Connector::Status::CONNECTED) return status;
+
+  fd_ = connector_.detach();
+  // Sesi MQTT ditutup normal (FIN), bukan RST seperti probe
+  struct linger lin = { 0, 0 };
+  lwip_setsockopt(fd_, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+  int one = 1;
+  lwip_setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return status;
+}
+
+void LwipSocket::stop() {
+  connector_.close();
+  if (fd_ >= 0) lwip_close(fd_);
+  fd_ = -1;
+}
+
+size_t LwipSocket::read(uint8_t* buf, size_t len) {
+  if (fd_ < 0) return 0;
+  int n = lwip_recv(fd_, buf, len, MSG_DONTWAIT);
+  if (n > 0) return static_cast<size_t>(n);
+  // 0 = ditutup broker; EAGAIN = belum ada data
+  if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) stop();
+  return 0;
+}
+
+bool LwipSocket::write(const uint8_t* data, size_t len) {
+  // Paket MQTT jauh lebih kecil dari buffer kirim TCP; kiriman sebagian
+  // (buffer penuh) dianggap gagal dan MqttPublisher memutus sesi
+  return fd_ >= 0 && lwip_send(fd_, data, len, MSG_DONTWAIT) == static_cast<int>(len);
+}
+
+// ==================== STORAGE ====================
+
+int32_t NvsStorage::getInt(const char* key, int32_t defaultValue) {
+  Preferences prefs;
+  if (!prefs.begin(namespace_, true)) return defaultValue;
+  int32_t v = prefs.getInt(key, defaultValue);
+  prefs.end();
+  return v;
+}
+
+bool NvsStorage::putInt(const char* key, int32_t value) {
+  Preferences prefs;
+  if (!prefs.begin(namespace_, false)) return false;
+  bool ok = prefs.putInt(key, value) == sizeof(int32_t);
+  prefs.end();
+  return ok;
+}
+
+bool NvsStorage::getBlob(const char* key, void* out, size_t len) {
+  Preferences prefs;
+  if (!prefs.begin(namespace_, true)) return false;
+  bool ok = prefs.getBytesLength(key) == len && prefs.getBytes(key, out, len) == len;
+  prefs.end();
+  return ok;
+}
+
+bool NvsStorage::putBlob(const char* key, const void* data, size_t len) {
+  Preferences prefs;
+  if (!prefs.begin(namespace_, false)) return false;
+  bool ok = prefs.putBytes(key, data, len) == len;
+  prefs.end();
+  return ok;
+}
+
+bool NvsStorage::remove(const char* key) {
+  Preferences prefs;
+  if (!prefs.begin(namespace_, false)) return false;
+  bool ok = !prefs.isKey(key) || prefs.remove(key);
+  prefs.end();
+  return ok;
+}
+
+// ==================== FILE (LITTLEFS) ====================
+
+bool LittleFsStore::begin() {
+  mounted_ = LittleFS.begin(true);
+  return mounted_;
+}
+
+int32_t LittleFsStore::size(const char* path) {
+  if (!mounted_ || !LittleFS.exists(path)) return -1;
+  File f = LittleFS.open(path, FILE_READ);
+  if (!f) return -1;
+  int32_t n = static_cast<int32_t>(f.size());
+  f.close();
+  return n;
+}
+
+bool LittleFsStore::append(const char* path, const void* data, size_t len) {
+  if (!mounted_) return false;
+  File f = LittleFS.open(path, FILE_APPEND);
+  if (!f) return false;
+  bool ok = f.write(static_cast<const uint8_t*>(data), len) == len;
+  f.close();
+  return ok;
+}
+
+bool LittleFsStore::read(const char* path, uint32_t offset, void* out, size_t len) {
+  if (!mounted_) return false;
+  File f = LittleFS.open(path, FILE_READ);
+  if (!f) return false;
+  bool ok = f.seek(offset) && f.read(static_cast<uint8_t*>(out), len) == len;
+  f.close();
+  return ok;
+}
+
+bool LittleFsStore::truncate(const char* path, uint32_t len) {
+  // Arduino File tidak punya truncate: salin 'len' byte pertama ke file
+  // sementara lalu rename. Hanya terjadi saat ekor rusak.
+  static const char* TMP_PATH = "/truncate.tmp";
+  if (!mounted_) return false;
+  File src = LittleFS.open(path, FILE_READ);
+  File dst = LittleFS.open(TMP_PATH, FILE_WRITE);
+  bool ok = src && dst;
+  uint8_t buf[128];
+  for (uint32_t done = 0; ok && done < len; ) {
+    size_t chunk = len - done < sizeof(buf) ? len - done : sizeof(buf);
+    ok = src.read(buf, chunk) == chunk && dst.write(buf, chunk) == chunk;
+    done += chunk;
+  }
+  if (src) src.close();
+  if (dst) dst.close();
+  if (!ok) {
+    LittleFS.remove(TMP_PATH);
+    return false;
+  }
+  // lfs_rename mengganti file tujuan yang sudah ada tanpa celah
+  return LittleFS.rename(TMP_PATH, path);
+}
+
+bool LittleFsStore::remove(const char* path) {
+  if (!mounted_) return false;
+  return !LittleFS.exists(path) || LittleFS.remove(path);
+}
+
+// ==================== LOG ====================
+
+void logPrintf(const char* fmt, ...) {
+  char buffer[192];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  Serial.print(buffer);
+}
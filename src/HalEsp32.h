@@ -0,0 +1,214 @@
+#ifndef HAL_ESP32_H
+#define HAL_ESP32_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <LiquidCrystal_I2C.h>
+#include <ezButton.h>
+#include <atomic>
+#include <lwip/ip_addr.h>
+#include "Config.h"
+#include "Hal.h"
+#include "BootProfiler.h"
+#include "BatchSizer.h"
+#include "MqttPublisher.h"
+#include "ReachabilityProbe.h"
+#include "WifiLink.h"
+#include "SampleRing.h"
+
+// ==================== IMPLEMENTASI HAL ESP32 ====================
+// Adapter tipis ke modul perangkat yang sudah ada (DisplayHandler,
+// NetworkHandler, Acquisition, Preferences). Tidak ada logika aplikasi di sini.
+
+class LcdDisplay : public Hal::Display {
+public:
+  explicit LcdDisplay(LiquidCrystal_I2C& lcd) : lcd_(lcd) {}
+  void showWeight(int32_t weightMg) override;
+  void showDefault(const SystemState& state) override;
+  void showSubtypeSelection() override;
+  void showStatusIndicators(bool isOffline, bool mqttConnected) override;
+  void showStability(bool isStable) override;
+  void showStatusMessage(const char* msg) override;
+  void showLines(const char* r0, const char* r1, const char* r2, const char* r3) override;
+
+private:
+  LiquidCrystal_I2C& lcd_;
+};
+
+class EzButtonPanel : public Hal::Buttons {
+public:
+  explicit EzButtonPanel(ezButton* buttons) : buttons_(buttons) {}
+  void update() override;
+  bool isPressed(uint8_t index) override;
+  bool isDown(uint8_t index) override;
+
+private:
+  ezButton* buttons_;   // array Hal::Buttons::COUNT tombol
+};
+
+class PinBuzzer : public Hal::Buzzer {
+public:
+  void tone(uint16_t freq, uint16_t durationMs) override;
+};
+
+class AcquisitionSource : public Hal::SampleSource {
+public:
+  bool pop(RawSample& out) override;
+  AcquisitionStats stats() override;
+};
+
+// Stream frame capture biner (CaptureFrame.h) ke Serial
+class SerialCaptureTap : public Hal::SampleTap {
+public:
+  void onSample(const RawSample& sample) override;
+};
+
+// Connect TCP non-blocking lewat socket lwIP untuk ReachabilityProbe. DNS
+// pakai dns_gethostbyname (callback, tidak menunggu); alamat di-cache sampai
+// probe gagal, jadi probe rutin hanya SYN/SYN-ACK lalu RST.
+class LwipConnector : public Hal::Connector {
+public:
+  bool start(const char* host, uint16_t port) override;
+  Status poll() override;
+  void close() override;
+  // Ambil alih socket yang sudah CONNECTED (pemanggil yang menutupnya);
+  // -1 jika belum tersambung. Alamat tetap di-cache untuk start() berikutnya.
+  int detach();
+
+private:
+  enum : uint8_t { DNS_IDLE, DNS_PENDING, DNS_OK, DNS_FAILED };
+  static void onDnsFound(const char* name, const ip_addr_t* addr, void* arg);
+  bool beginConnect();
+
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  char host_[64] = "";
+  ip_addr_t addr_;
+  bool addrValid_ = false;
+  bool connected_ = false;
+  bool failed_ = false;
+  std::atomic<uint8_t> dns_{DNS_IDLE};
+};
+
+// Radio WiFi lewat event Arduino (WiFi.onEvent). Event dari task WiFi masuk
+// ring SPSC, diambil loop lewat pollEvent(). Auto-reconnect bawaan dimatikan:
+// kapan join diatur WifiLink.
+class EspWifiRadio : public Hal::WifiRadio {
+public:
+  // Mode STA, IP statis (build flag WIFI_STATIC_IP), daftarkan handler event
+  void begin();
+  void join(const Bss* hint) override;
+  bool pollEvent(Event& out) override;
+  bool currentBss(Bss& out) override;
+
+private:
+  static void onEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+  static EspWifiRadio* instance_;
+
+  SampleRing<Event, 8> events_;
+  std::atomic<bool> leaving_{false};   // DISCONNECTED berikutnya akibat join() sendiri
+};
+
+// Upload Laravel di worker task (NET_TASK_CORE) lewat dua ring SPSC:
+// outbox_ (loop -> worker) dan results_ (worker -> loop). Worker menggabung
+// record yang antri (maks sizer_.limit(), tunggu BATCH_LINGER_MS) jadi satu
+// POST batch. MQTT (MqttPublisher, QoS 1) tetap dari loop(). offlineMode
+// saat WiFi tersambung mengikuti ReachabilityProbe ke host Laravel.
+class NetworkUplink : public Hal::Uplink {
+public:
+  explicit NetworkUplink(MqttPublisher& mqtt) : mqtt_(mqtt) {}
+  // Jalankan worker task, set client ID MQTT dari MAC (sesi persisten),
+  // arahkan probe ke host SERVER_URL. Return false jika task gagal dibuat.
+  bool begin();
+  void maintain(SystemState& state, uint32_t now) override;
+  bool mqttConnected() override;
+  bool publish(uint32_t seq, const WeighingRecord& record) override;
+  uint32_t enqueue(const WeighingRecord& record) override;
+  bool pollResult(SendResult& out) override;
+  size_t pending() override { return pending_.load(); }
+
+  // Tandai fase "wifi" & "mqtt" di profil boot, lalu kirim sebagai telemetri
+  // begitu MQTT tersambung pertama kali (nullptr = sudah terkirim)
+  void setBootProfiler(BootProfiler* profiler) { boot_ = profiler; }
+
+  // Ukuran batch saat ini & RTT (ditulis worker, dibaca console 'net')
+  const BatchSizer& batchSizer() const { return sizer_; }
+  const ReachabilityProbe& probe() const { return probe_; }
+  const WifiLink& link() const { return link_; }
+
+private:
+  void finishBootReport(const SystemState& state, uint32_t now);
+
+  struct Job {
+    uint32_t id;
+    WeighingRecord record;
+  };
+  static void workerTask(void* self);
+  // Kumpulkan batch berikutnya dari outbox_ (blok sampai ada record)
+  size_t collectBatch(Job* jobs, size_t limit);
+
+  MqttPublisher& mqtt_;
+  EspWifiRadio radio_;
+  WifiLink link_{radio_};
+  LwipConnector connector_;
+  ReachabilityProbe probe_{connector_};
+  SampleRing<Job, Config::SEND_QUEUE_SIZE> outbox_;
+  SampleRing<SendResult, Config::SEND_QUEUE_SIZE> results_;
+  std::atomic<uint32_t> pending_{0};
+  BatchSizer sizer_{Config::BATCH_MAX_RECORDS, Config::BATCH_TARGET_MS};
+  uint32_t nextId_ = 1;
+  TaskHandle_t worker_ = nullptr;
+  BootProfiler* boot_ = nullptr;
+  bool linkUp_ = false;
+  bool bootWifiMarked_ = false;
+  bool bootTimeoutLogged_ = false;
+};
+
+// Socket lwIP untuk MqttPublisher. Connect lewat LwipConnector (DNS callback,
+// SYN non-blocking, alamat di-cache), jadi reconnect broker tidak pernah
+// menahan loop(). Nagle dimatikan (PUBLISH kecil, PUBACK ditunggu).
+class LwipSocket : public Hal::Socket {
+public:
+  bool connect(const char* host, uint16_t port) override;
+  Hal::Connector::Status poll() override;
+  void stop() override;
+  bool connected() override { return fd_ >= 0; }
+  size_t read(uint8_t* buf, size_t len) override;
+  bool write(const uint8_t* data, size_t len) override;
+
+private:
+  LwipConnector connector_;
+  int fd_ = -1;
+};
+
+// Preferences, satu namespace NVS untuk semua key
+class NvsStorage : public Hal::Storage {
+public:
+  explicit NvsStorage(const char* ns) : namespace_(ns) {}
+  int32_t getInt(const char* key, int32_t defaultValue) override;
+  bool putInt(const char* key, int32_t value) override;
+  bool getBlob(const char* key, void* out, size_t len) override;
+  bool putBlob(const char* key, const void* data, size_t len) override;
+  bool remove(const char* key) override;
+
+private:
+  const char* namespace_;
+};
+
+// LittleFS (partisi "spiffs" di tabel default), diformat otomatis jika belum.
+// File dibuka-tutup per operasi: close() = commit metadata LittleFS.
+class LittleFsStore : public Hal::FileStore {
+public:
+  // Mount filesystem. Return false jika partisi tidak ada / gagal format.
+  bool begin();
+  int32_t size(const char* path) override;
+  bool append(const char* path, const void* data, size_t len) override;
+  bool read(const char* path, uint32_t offset, void* out, size_t len) override;
+  bool truncate(const char* path, uint32_t len) override;
+  bool remove(const char* path) override;
+
+private:
+  bool mounted_ = false;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HX711_ESP32_H
+#define HX711_ESP32_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// ==================== PIN HX711 ESP32 ====================
+// Implementasi antarmuka 'Pins' untuk Hx711::readWord() di ESP32.
+
+struct Esp32Hx711Pins {
+  void begin() {
+    pinMode(Config::HX711_SCK, OUTPUT);
+    pinMode(Config::HX711_DOUT, INPUT);
+    digitalWrite(Config::HX711_SCK, LOW);
+  }
+
+  bool readDout() { return digitalRead(Config::HX711_DOUT) == HIGH; }
+  void writeSck(bool high) { digitalWrite(Config::HX711_SCK, high ? HIGH : LOW); }
+  void delayUs(uint32_t us) { delayMicroseconds(us); }
+};
+
+#endif
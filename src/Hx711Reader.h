@@ -0,0 +1,83 @@
+#ifndef HX711_READER_H
+#define HX711_READER_H
+
+#include <stdint.h>
+
+// ==================== HX711 READER (PORTABLE) ====================
+// Logika pembacaan word 24-bit HX711, terpisah dari hardware.
+// 'Pins' adalah lapisan abstraksi hardware dengan bentuk:
+//
+//   struct Pins {
+//     bool readDout();             // level pin DOUT (true = HIGH)
+//     void writeSck(bool high);    // set level pin SCK
+//     void delayUs(uint32_t us);   // tunda minimal 'us' mikrodetik
+//   };
+//
+// Di ESP32 dipakai Esp32Hx711Pins (Hx711Esp32.h), di host dipakai
+// SimHx711Pins (Hx711SimPins.h) sehingga logika yang sama bisa diuji
+// tanpa board. Template dipilih agar tidak ada virtual call per bit.
+
+namespace Hx711 {
+  // Jumlah pulsa tambahan setelah 24 bit data, menentukan gain berikutnya
+  enum Gain : uint8_t {
+    GAIN_128_A = 1,
+    GAIN_32_B = 2,
+    GAIN_64_A = 3
+  };
+
+  // Nilai mentah minimum/maksimum (output HX711 jenuh di nilai ini)
+  constexpr int32_t RAW_MIN = -0x800000;
+  constexpr int32_t RAW_MAX = 0x7FFFFF;
+
+  // SCK HIGH lebih dari ini -> power-down (datasheet: > 60 us)
+  constexpr uint32_t POWER_DOWN_US = 60;
+  // Setelah bangun, data pertama siap setelah settling (datasheet, 80 SPS: 50 ms)
+  constexpr uint32_t WAKE_SETTLE_US = 50000;
+
+  // DOUT LOW berarti konversi baru siap dibaca
+  template <typename Pins>
+  inline bool isReady(Pins& pins) {
+    return !pins.readDout();
+  }
+
+  // Clock-out 24 bit (MSB dulu) + pulsa gain, lalu sign-extend ke int32.
+  // Pemanggil wajib memastikan isReady() dan tidak di-preempt > 60 us
+  // (SCK HIGH terlalu lama membuat HX711 masuk power-down).
+  template <typename Pins>
+  inline int32_t readWord(Pins& pins, Gain gain = GAIN_128_A) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < 24; i++) {
+      pins.writeSck(true);
+      pins.delayUs(1);
+      value = (value << 1) | (pins.readDout() ? 1u : 0u);
+      pins.writeSck(false);
+      pins.delayUs(1);
+    }
+    for (uint8_t i = 0; i < static_cast<uint8_t>(gain); i++) {
+      pins.writeSck(true);
+      pins.delayUs(1);
+      pins.writeSck(false);
+      pins.delayUs(1);
+    }
+
+    // Sign-extend dari 24 bit two's complement
+    if (value & 0x800000u) value |= 0xFF000000u;
+    return static_cast<int32_t>(value);
+  }
+
+  // Masuk power-down: SCK ditahan HIGH lebih dari POWER_DOWN_US
+  template <typename Pins>
+  inline void powerDown(Pins& pins) {
+    pins.writeSck(true);
+    pins.delayUs(POWER_DOWN_US + 1);
+  }
+
+  // Bangun: SCK LOW. Chip reset (gain kembali 128/A), DOUT LOW lagi setelah
+  // WAKE_SETTLE_US; konversi pertama setelahnya sudah settle.
+  template <typename Pins>
+  inline void powerUp(Pins& pins) {
+    pins.writeSck(false);
+  }
+}
+
+#endif
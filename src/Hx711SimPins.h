@@ -0,0 +1,90 @@
+#ifndef HX711_SIM_PINS_H
+#define HX711_SIM_PINS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Hx711Reader.h"
+
+// ==================== MODEL PIN HX711 SIMULASI ====================
+// Model perilaku pin DOUT/SCK HX711 untuk menjalankan Hx711::readWord()
+// di host. Meniru: DOUT LOW saat konversi siap, bit digeser keluar pada
+// tepi naik SCK, DOUT kembali HIGH setelah pulsa ke-25, power-down jika
+// SCK ditahan HIGH lebih dari POWER_DOWN_US, dan bangun (reset, gain 128)
+// saat SCK turun lagi dengan DOUT baru LOW setelah WAKE_SETTLE_US.
+// Waktu hanya maju lewat delayUs().
+
+class SimHx711Pins {
+public:
+  // Antrekan konversi berikutnya (nilai 24-bit two's complement). Selama
+  // power-down / settling setelah bangun, DOUT tetap HIGH.
+  void setConversion(int32_t raw) {
+    word_ = static_cast<uint32_t>(raw) & 0xFFFFFFu;
+    ready_ = true;
+    bitIndex_ = 0;
+    pulses_ = 0;
+  }
+
+  // ---- Antarmuka Pins ----
+  bool readDout() const {
+    if (!ready_ || poweredDown_ || elapsedUs_ < readyAtUs_) return true;
+    if (bitIndex_ == 0) return false;             // siap, belum di-clock
+    if (bitIndex_ > 24) return true;              // sudah selesai dibaca
+    return (word_ >> (24 - bitIndex_)) & 1u;      // bit yang sedang dipresentasikan
+  }
+
+  void writeSck(bool high) {
+    if (high && !sck_) {
+      sckHighUs_ = 0;
+      if (!poweredDown_) {
+        pulses_++;
+        if (ready_ && bitIndex_ <= 24) bitIndex_++;
+      }
+    } else if (!high && sck_) {
+      if (poweredDown_) {
+        // Bangun: reset chip, gain kembali 128/A, konversi baru setelah settling
+        poweredDown_ = false;
+        ready_ = false;
+        gainPulses_ = Hx711::GAIN_128_A;
+        readyAtUs_ = elapsedUs_ + Hx711::WAKE_SETTLE_US;
+      } else if (pulses_ >= 25) {
+        ready_ = false;                           // konversi habis dibaca
+        lastPulses_ = pulses_;
+        gainPulses_ = static_cast<uint8_t>(pulses_ - 24);
+      }
+    }
+    sck_ = high;
+  }
+
+  void delayUs(uint32_t us) {
+    elapsedUs_ += us;
+    if (sck_) {
+      sckHighUs_ += us;
+      if (sckHighUs_ > maxSckHighUs_) maxSckHighUs_ = sckHighUs_;
+      if (sckHighUs_ > Hx711::POWER_DOWN_US) poweredDown_ = true;
+    }
+  }
+
+  // ---- Inspeksi untuk host ----
+  bool poweredDown() const { return poweredDown_; }
+  // Pulsa SCK pada pembacaan terakhir (25/26/27) dan gain yang dipilihnya
+  uint8_t lastPulses() const { return lastPulses_; }
+  uint8_t gainPulses() const { return gainPulses_; }
+  uint32_t elapsedUs() const { return elapsedUs_; }
+  uint32_t maxSckHighUs() const { return maxSckHighUs_; }
+
+private:
+  uint32_t word_ = 0;
+  bool ready_ = false;
+  bool sck_ = false;
+  bool poweredDown_ = false;
+  uint8_t bitIndex_ = 0;
+  uint8_t pulses_ = 0;
+  uint8_t lastPulses_ = 0;
+  uint8_t gainPulses_ = Hx711::GAIN_128_A;
+  uint32_t sckHighUs_ = 0;
+  uint32_t maxSckHighUs_ = 0;
+  uint32_t elapsedUs_ = 0;
+  uint32_t readyAtUs_ = 0;
+};
+
+#endif
@@ -0,0 +1,275 @@
+#include "MqttPublisher.h"
+#include <string.h>
+
+namespace {
+  // Tipe paket MQTT 3.1.1 (4 bit atas fixed header)
+  constexpr uint8_t CONNECT = 1;
+  constexpr uint8_t CONNACK = 2;
+  constexpr uint8_t PUBLISH = 3;
+  constexpr uint8_t PUBACK = 4;
+  constexpr uint8_t PINGREQ = 12;
+  constexpr uint8_t PINGRESP = 13;
+  constexpr uint8_t DISCONNECT = 14;
+
+  constexpr uint8_t FLAG_DUP = 0x08;
+  constexpr uint8_t FLAG_QOS1 = 0x02;
+  constexpr size_t MAX_TOPIC = 64;
+
+  // Fixed header: tipe + panjang sisa (varint 1..4 byte). Return jumlah byte.
+  size_t putHeader(uint8_t* out, uint8_t header, uint32_t remaining) {
+    size_t n = 0;
+    out[n++] = header;
+    do {
+      uint8_t digit = remaining & 0x7F;
+      remaining >>= 7;
+      out[n++] = remaining > 0 ? (digit | 0x80) : digit;
+    } while (remaining > 0);
+    return n;
+  }
+
+  size_t putString(uint8_t* out, const char* s, size_t len) {
+    out[0] = static_cast<uint8_t>(len >> 8);
+    out[1] = static_cast<uint8_t>(len);
+    memcpy(out + 2, s, len);
+    return len + 2;
+  }
+}
+
+// ==================== IMPLEMENTASI ====================
+
+MqttPublisher::MqttPublisher(Hal::Socket& socket, uint16_t window)
+  : socket_(socket), window_(window == 0 ? 1 : (window > QUEUE ? QUEUE : window)),
+    retryMs_(Config::MQTT_RETRY_INTERVAL) {}
+
+void MqttPublisher::setServer(const char* host, uint16_t port) {
+  copyText(host_, host);
+  port_ = port;
+}
+
+void MqttPublisher::setClientId(const char* clientId) {
+  copyText(clientId_, clientId);
+}
+
+bool MqttPublisher::publish(const char* topic, const char* payload) {
+  return publish(topic, reinterpret_cast<const uint8_t*>(payload), strlen(payload));
+}
+
+bool MqttPublisher::publish(const char* topic, const uint8_t* payload, size_t length) {
+  if (length > Config::MQTT_MAX_PAYLOAD || strlen(topic) > MAX_TOPIC || head_ - tail_ >= QUEUE) {
+    stats_.dropped++;
+    return false;
+  }
+  Message& m = slot(head_);
+  m.topic = topic;
+  m.length = static_cast<uint16_t>(length);
+  m.sent = false;
+  m.acked = false;
+  memcpy(m.payload, payload, length);
+  head_++;
+  stats_.published++;
+  return true;
+}
+
+void MqttPublisher::loop(uint32_t now) {
+  if (state_ == State::DISCONNECTED) {
+    if (!attempted_ || now - lastAttempt_ >= retryMs_) startSession(now);
+    return;
+  }
+  if (state_ == State::CONNECTING) {
+    // DNS + TCP connect berjalan di stack; loop tidak pernah menunggu
+    const Hal::Connector::Status status = socket_.poll();
+    if (status == Hal::Connector::Status::CONNECTED) {
+      sendConnect(now);
+    } else if (status == Hal::Connector::Status::FAILED || now - lastAttempt_ > Config::MQTT_CONNECT_TIMEOUT) {
+      // Belum pernah ada sesi: bukan 'disconnect', coba lagi setelah retryMs_
+      socket_.stop();
+      state_ = State::DISCONNECTED;
+    }
+    return;
+  }
+  if (!socket_.connected()) {
+    drop(now, "socket tertutup");
+    return;
+  }
+  receive(now);
+  if (state_ == State::DISCONNECTED) return;
+  if (state_ == State::AWAIT_CONNACK) {
+    if (now - lastAttempt_ > Config::MQTT_CONNECT_TIMEOUT) drop(now, "CONNACK timeout");
+    return;
+  }
+
+  // Broker tidak lagi membalas meski TCP terlihat hidup (half-open)
+  if (tail_ != next_ && now - slot(tail_).sentMs > Config::MQTT_ACK_TIMEOUT) {
+    drop(now, "PUBACK timeout");
+    return;
+  }
+  if (now - lastRx_ > Config::MQTT_KEEPALIVE_S * 1500UL) {
+    drop(now, "keepalive timeout");
+    return;
+  }
+  if (!transmit(now)) {
+    drop(now, "tulis gagal");
+    return;
+  }
+  if (now - lastTx_ >= Config::MQTT_KEEPALIVE_S * 1000UL) sendPacket(PINGREQ << 4, nullptr, 0, now);
+}
+
+void MqttPublisher::disconnect() {
+  if (state_ == State::AWAIT_CONNACK || state_ == State::CONNECTED) sendPacket(DISCONNECT << 4, nullptr, 0, lastTx_);
+  socket_.stop();
+  state_ = State::DISCONNECTED;
+}
+
+void MqttPublisher::startSession(uint32_t now) {
+  attempted_ = true;
+  lastAttempt_ = now;
+  rxLen_ = 0;
+  rxSkip_ = 0;
+  if (host_[0] == '\0' || !socket_.connect(host_, port_)) return;
+  state_ = State::CONNECTING;
+}
+
+void MqttPublisher::sendConnect(uint32_t now) {
+  // Timeout CONNACK dihitung dari CONNECT terkirim, bukan dari awal DNS
+  lastAttempt_ = now;
+
+  // Clean session 0: broker menyimpan sesi, pesan yang dikirim ulang
+  // setelah reconnect dikenali sebagai DUP dari packet ID yang sama
+  uint8_t body[10 + 2 + sizeof(clientId_)];
+  size_t n = putString(body, "MQTT", 4);
+  body[n++] = 4;                                   // protocol level 3.1.1
+  body[n++] = 0x00;                                // connect flags
+  body[n++] = static_cast<uint8_t>(Config::MQTT_KEEPALIVE_S >> 8);
+  body[n++] = static_cast<uint8_t>(Config::MQTT_KEEPALIVE_S);
+  n += putString(body + n, clientId_, strlen(clientId_));
+  lastRx_ = now;
+  state_ = State::AWAIT_CONNACK;
+  if (!sendPacket(CONNECT << 4, body, n, now)) drop(now, "CONNECT gagal");
+}
+
+void MqttPublisher::drop(uint32_t now, const char* reason) {
+  socket_.stop();
+  if (state_ == State::AWAIT_CONNACK || state_ == State::CONNECTED) stats_.disconnects++;
+  state_ = State::DISCONNECTED;
+  lastAttempt_ = now;
+  logPrintf("MQTT: putus (%s), %u pesan belum di-ack\n", reason, (unsigned)queued());
+}
+
+void MqttPublisher::receive(uint32_t now) {
+  uint8_t buf[32];
+  size_t n;
+  while ((n = socket_.read(buf, sizeof(buf))) > 0) {
+    lastRx_ = now;
+    for (size_t i = 0; i < n; i++) {
+      if (rxSkip_ > 0) {
+        rxSkip_--;
+        continue;
+      }
+      rx_[rxLen_++] = buf[i];
+      if (rxLen_ < 2) continue;
+
+      // Panjang sisa: varint mulai byte ke-2, bit 7 = masih ada byte berikutnya
+      uint32_t remaining = 0;
+      size_t header = 1;
+      bool complete = false;
+      for (uint32_t mult = 1; header < rxLen_ && header <= 4; header++, mult <<= 7) {
+        remaining += (rx_[header] & 0x7F) * mult;
+        if ((rx_[header] & 0x80) == 0) {
+          complete = true;
+          header++;
+          break;
+        }
+      }
+      if (!complete) {
+        if (rxLen_ > 4) {
+          drop(now, "paket rusak");
+          return;
+        }
+        continue;
+      }
+      if (rxLen_ == header && remaining > sizeof(rx_) - header) {
+        // Paket besar (mis. PUBLISH dari broker): tidak dipakai, lewati isinya
+        rxSkip_ = remaining;
+        rxLen_ = 0;
+        continue;
+      }
+      if (rxLen_ < header + remaining) continue;
+
+      handlePacket(rx_[0] >> 4, rx_ + header, remaining, now);
+      rxLen_ = 0;
+      if (state_ == State::DISCONNECTED) return;
+    }
+  }
+}
+
+void MqttPublisher::handlePacket(uint8_t type, const uint8_t* body, size_t len, uint32_t now) {
+  if (type == CONNACK) {
+    if (len < 2 || body[1] != 0) {
+      drop(now, "CONNACK ditolak");
+      return;
+    }
+    state_ = State::CONNECTED;
+    stats_.connects++;
+    // Semua yang belum di-ack dikirim ulang dari awal jendela
+    next_ = tail_;
+    logPrintf("MQTT: tersambung (sesi %s), %u pesan antri\n", (body[0] & 1) ? "lanjut" : "baru",
+              (unsigned)queued());
+  } else if (type == PUBACK && len >= 2) {
+    uint16_t id = static_cast<uint16_t>((body[0] << 8) | body[1]);
+    for (uint32_t i = tail_; i != next_; i++) {
+      Message& m = slot(i);
+      if (m.acked || m.packetId != id) continue;
+      m.acked = true;
+      stats_.acked++;
+      uint32_t elapsed = now - m.sentMs;
+      stats_.ackMsTotal += elapsed;
+      if (elapsed > stats_.ackMsMax) stats_.ackMsMax = elapsed;
+      break;
+    }
+    while (tail_ != next_ && slot(tail_).acked) tail_++;
+  }
+  // PINGRESP & paket lain: cukup memperbarui lastRx_
+}
+
+bool MqttPublisher::transmit(uint32_t now) {
+  while (next_ != head_ && next_ - tail_ < window_) {
+    Message& m = slot(next_);
+    if (m.acked) {
+      next_++;
+      continue;
+    }
+    const bool dup = m.sent;
+    if (!dup) {
+      m.packetId = nextPacketId_++;
+      if (nextPacketId_ == 0) nextPacketId_ = 1;
+    }
+    if (!sendPublish(m, dup, now)) return false;
+    if (dup) stats_.retransmits++;
+    m.sent = true;
+    next_++;
+  }
+  return true;
+}
+
+bool MqttPublisher::sendPublish(Message& m, bool dup, uint32_t now) {
+  size_t topicLen = strlen(m.topic);
+  uint32_t remaining = 2 + topicLen + 2 + m.length;
+  size_t n = putHeader(tx_, (PUBLISH << 4) | FLAG_QOS1 | (dup ? FLAG_DUP : 0), remaining);
+  n += putString(tx_ + n, m.topic, topicLen);
+  tx_[n++] = static_cast<uint8_t>(m.packetId >> 8);
+  tx_[n++] = static_cast<uint8_t>(m.packetId);
+  memcpy(tx_ + n, m.payload, m.length);
+  n += m.length;
+  m.sentMs = now;
+  if (!socket_.write(tx_, n)) return false;
+  lastTx_ = now;
+  return true;
+}
+
+bool MqttPublisher::sendPacket(uint8_t header, const uint8_t* body, size_t len, uint32_t now) {
+  size_t n = putHeader(tx_, header, len);
+  if (len > 0) memcpy(tx_ + n, body, len);
+  if (!socket_.write(tx_, n + len)) return false;
+  lastTx_ = now;
+  return true;
+}
@@ -0,0 +1,115 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "Hal.h"
+
+// ==================== PUBLISHER MQTT QOS 1 ====================
+// Pengganti PubSubClient untuk jalur kirim (PubSubClient hanya bisa publish
+// QoS 0: pesan hilang tanpa tanda). MQTT 3.1.1, hanya yang dibutuhkan
+// timbangan: CONNECT (sesi persisten), PUBLISH QoS 1, PUBACK, PINGREQ.
+//
+//   - publish() menyalin pesan ke antrean tetap (tanpa heap)
+//   - sampai 'window' PUBLISH menunggu PUBACK sekaligus (bukan stop-and-wait)
+//   - pesan dibuang dari antrean hanya setelah PUBACK
+//   - setelah reconnect, semua yang belum di-ack dikirim ulang dengan flag
+//     DUP dan packet ID yang sama
+//   - PUBACK yang tidak datang dalam MQTT_ACK_TIMEOUT dianggap koneksi mati
+//   - DNS + TCP connect tidak blok (Hal::Socket::poll), dibatasi
+//     MQTT_CONNECT_TIMEOUT; loop() tidak pernah menunggu jaringan
+//
+// Single-thread: publish() dan loop() dari task yang sama (loop() Arduino).
+
+struct MqttStats {
+  uint32_t published = 0;     // pesan diterima publish()
+  uint32_t acked = 0;         // PUBACK diterima
+  uint32_t retransmits = 0;   // PUBLISH dikirim ulang (DUP) setelah reconnect
+  uint32_t dropped = 0;       // antrean penuh / payload terlalu panjang
+  uint32_t connects = 0;      // sesi terbentuk (CONNACK diterima)
+  uint32_t disconnects = 0;   // koneksi putus atau diputus (timeout)
+  uint32_t ackMsTotal = 0;    // PUBLISH -> PUBACK
+  uint32_t ackMsMax = 0;
+};
+
+class MqttPublisher {
+public:
+  explicit MqttPublisher(Hal::Socket& socket, uint16_t window = Config::MQTT_INFLIGHT_WINDOW);
+
+  // 'host' dan 'clientId' disalin. Client ID harus stabil antar reconnect
+  // agar broker mengenali sesi persisten.
+  void setServer(const char* host, uint16_t port);
+  void setClientId(const char* clientId);
+  void setRetryInterval(uint32_t ms) { retryMs_ = ms; }
+
+  // Terima PUBACK, kirim yang antri, keepalive, reconnect. Panggil sesering mungkin.
+  void loop(uint32_t now);
+
+  // Antri PUBLISH QoS 1. 'topic' harus tetap hidup sampai di-ack (string literal).
+  // Return false jika antrean penuh (dihitung di stats().dropped).
+  bool publish(const char* topic, const char* payload);
+  // Payload biner (mis. RecordCodec), maksimal MQTT_MAX_PAYLOAD byte
+  bool publish(const char* topic, const uint8_t* payload, size_t length);
+
+  // Kirim DISCONNECT dan tutup socket (pesan belum di-ack tetap antri)
+  void disconnect();
+
+  bool connected() const { return state_ == State::CONNECTED; }
+  size_t queued() const { return head_ - tail_; }
+  size_t inFlight() const { return next_ - tail_; }
+  const MqttStats& stats() const { return stats_; }
+
+private:
+  enum class State : uint8_t { DISCONNECTED, CONNECTING, AWAIT_CONNACK, CONNECTED };
+
+  struct Message {
+    const char* topic;
+    uint16_t length;
+    uint16_t packetId;
+    uint32_t sentMs;
+    bool sent;
+    bool acked;
+    uint8_t payload[Config::MQTT_MAX_PAYLOAD];
+  };
+
+  static constexpr size_t QUEUE = Config::MQTT_QUEUE_SIZE;
+  static_assert((QUEUE & (QUEUE - 1)) == 0, "MQTT_QUEUE_SIZE harus pangkat dua");
+
+  Message& slot(uint32_t index) { return queue_[index & (QUEUE - 1)]; }
+  void startSession(uint32_t now);
+  void sendConnect(uint32_t now);
+  void drop(uint32_t now, const char* reason);
+  void receive(uint32_t now);
+  void handlePacket(uint8_t type, const uint8_t* body, size_t len, uint32_t now);
+  bool transmit(uint32_t now);
+  bool sendPublish(Message& m, bool dup, uint32_t now);
+  bool sendPacket(uint8_t header, const uint8_t* body, size_t len, uint32_t now);
+
+  Hal::Socket& socket_;
+  uint16_t window_;
+  char host_[64] = "";
+  uint16_t port_ = 1883;
+  char clientId_[32] = "ecoscale";
+  uint32_t retryMs_;
+  State state_ = State::DISCONNECTED;
+  bool attempted_ = false;
+  uint32_t lastAttempt_ = 0;
+  uint32_t lastTx_ = 0;
+  uint32_t lastRx_ = 0;
+  uint16_t nextPacketId_ = 1;
+
+  // [tail_, next_) terkirim menunggu PUBACK, [next_, head_) belum dikirim
+  Message queue_[QUEUE];
+  uint32_t head_ = 0;
+  uint32_t next_ = 0;
+  uint32_t tail_ = 0;
+
+  uint8_t rx_[16];
+  size_t rxLen_ = 0;
+  uint32_t rxSkip_ = 0;       // sisa byte paket masuk yang tidak dipakai (terlalu besar)
+  uint8_t tx_[Config::MQTT_MAX_PAYLOAD + 80];
+  MqttStats stats_;
+};
+
+#endif
@@ -1,151 +1,245 @@
 #include "NetworkHandler.h"
 
 // ==================== DEFINISI KONSTANTA ====================
+// Server uji lokal (tools/laravel_standin.py) lewat build flag, mis.
+//   build_flags = -D LARAVEL_URL=\"https://192.168.1.50:8443/api/receive-sampah\"
+#ifdef LARAVEL_URL
+const char* SERVER_URL = LARAVEL_URL;
+#else
 const char* SERVER_URL = "https://ecoscale.undip.us/api/receive-sampah";
+#endif
 const char* MQTT_SERVER = "broker.hivemq.com";
 const int MQTT_PORT = 1883;
 const char* MQTT_TOPIC = "undip/scale/new";
-const char* PING_HOST = "8.8.8.8";
+const char* MQTT_BOOT_TOPIC = "undip/scale/boot";
+const char* MQTT_BIN_TOPIC = "undip/scale/new/bin";
 
 // ==================== IMPLEMENTASI FUNGSI ====================
 
-bool connectWiFi(LiquidCrystal_I2C* lcd) {
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-  
-  if (lcd != nullptr) {
-    lcd->clear();
-    lcd->setCursor(0, 1);
-    lcd->print("Connecting WiFi...");
-  }
-  
-  for (int i = 0; i < Config::WIFI_RETRY_COUNT; i++) {
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("\nWiFi Connected");
-      Serial.print("IP: ");
-      Serial.println(WiFi.localIP());
-      return true;
-    }
-    
-    if (lcd != nullptr) {
-      lcd->setCursor(i % 20, 2);
-      lcd->print(".");
-    }
-    
-    delay(500);
-    esp_task_wdt_reset(); // Mencegah Watchdog Timer reset otomatis
-  }
-  
-  return false;
+bool laravelEndpoint(char* host, size_t hostLen, uint16_t& port) {
+  // "https://host[:port]/path" -> host, port (default dari skema)
+  const char* p = strstr(SERVER_URL, "://");
+  if (p == nullptr) return false;
+  port = strncmp(SERVER_URL, "https", 5) == 0 ? 443 : 80;
+  p += 3;
+  size_t len = strcspn(p, ":/");
+  if (len == 0 || len >= hostLen) return false;
+  memcpy(host, p, len);
+  host[len] = '\0';
+  if (p[len] == ':') port = static_cast<uint16_t>(atoi(p + len + 1));
+  return port != 0;
 }
 
-void connectMQTT(PubSubClient& client) {
-  if (client.connected()) return;
-  
-  Serial.print("Connecting MQTT...");
-  // Buat Client ID Random agar tidak tabrakan sesi
-  String clientId = "ESP32Scale-" + String(random(0xFFFF), HEX);
-  
-  if (client.connect(clientId.c_str())) {
-    Serial.println(" Success!");
-  } else {
-    Serial.print(" Failed, rc=");
-    Serial.println(client.state());
+// ==================== SESI HTTPS LARAVEL ====================
+// Satu koneksi TLS dipakai ulang lintas POST (HTTP/1.1 keep-alive), jadi
+// DNS + handshake hanya dibayar pada POST pertama / setelah koneksi putus.
+// Koneksi ulang melanjutkan sesi TLS terakhir (TlsSessionClient).
+static TlsSessionClient laravelTls;
+static HTTPClient laravelHttp;
+static unsigned long laravelLastUse = 0;
+static HttpSessionStats laravelStats;
+
+static bool batchUnsupported = false;
+
+// Return true jika koneksi lama masih dipakai
+static bool openLaravelSession(const char* url, const char* contentType, unsigned long now) {
+  // Tutup sendiri sebelum server menutup koneksi idle, supaya POST tidak
+  // ditulis ke socket yang sedang ditutup di sisi server
+  if (laravelTls.connected() && now - laravelLastUse > Config::HTTPS_IDLE_TIMEOUT) {
+    laravelTls.stop();
+  }
+  bool reused = laravelTls.connected();
+  if (!reused) {
+    laravelTls.stop();
+    laravelStats.connects++;
   }
+  laravelHttp.setReuse(true);
+  laravelHttp.begin(laravelTls, url);
+  laravelHttp.setTimeout(Config::HTTP_TIMEOUT);
+  laravelHttp.addHeader("Content-Type", contentType);
+  return reused;
 }
 
-bool checkNetworkHealth() {
-  return Ping.ping(PING_HOST, 1);
+// Error yang terjadi sebelum request sampai ke server: aman diulang sekali
+static bool isStaleSocketError(int httpCode) {
+  return httpCode == HTTPC_ERROR_CONNECTION_LOST ||
+         httpCode == HTTPC_ERROR_SEND_HEADER_FAILED ||
+         httpCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+         httpCode == HTTPC_ERROR_NOT_CONNECTED;
 }
 
-void manageWiFiConnection(SystemState& state, unsigned long& lastWifiCheckTime) {
-  if (millis() - lastWifiCheckTime < Config::WIFI_CHECK_INTERVAL) return;
-  
-  if (WiFi.status() != WL_CONNECTED) {
-    WiFi.reconnect();
-    state.offlineMode = true;
-    state.isOnline = false;
-  } else if (state.offlineMode) {
-    // Jika sebelumnya offline, cek apakah sekarang sudah ada internet
-    if (checkNetworkHealth()) {
-      state.offlineMode = false;
-      Serial.println("Reconnected! Ready to send.");
+// Satu POST lewat sesi keep-alive. Return kode HTTP (> 0) dengan body di
+// 'response', atau kode error HTTPClient (<= 0) jika tidak ada respons.
+static int postLaravel(const char* url, const char* contentType, const char* body, String& response) {
+  int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+  for (int attempt = 0; attempt < 2; attempt++) {
+    unsigned long start = millis();
+    bool reused = openLaravelSession(url, contentType, start);
+    httpCode = laravelHttp.POST(body);
+    
+    if (httpCode > 0) {
+      // Body harus dibaca habis agar koneksi bisa dipakai request berikutnya
+      response = laravelHttp.getString();
+      laravelHttp.end();   // dengan setReuse(true) socket tetap terbuka
+      laravelLastUse = millis();
+      
+      unsigned long elapsed = laravelLastUse - start;
+      laravelStats.requests++;
+      if (reused) {
+        laravelStats.reused++;
+        laravelStats.reusedMsTotal += elapsed;
+        if (elapsed > laravelStats.reusedMsMax) laravelStats.reusedMsMax = elapsed;
+      } else {
+        laravelStats.freshMsTotal += elapsed;
+        if (elapsed > laravelStats.freshMsMax) laravelStats.freshMsMax = elapsed;
+      }
+      Serial.printf("HTTP Code: %d (%lums, %s)\n", httpCode, elapsed, reused ? "reuse" : "koneksi baru");
+      return httpCode;
     }
+    
+    Serial.printf("HTTP Error: %d - %s\n", httpCode, laravelHttp.errorToString(httpCode).c_str());
+    laravelHttp.end();
+    laravelTls.stop();
+    laravelStats.failures++;
+    // Socket basi (server menutup keep-alive): ulang sekali dengan koneksi baru.
+    // Timeout baca diserahkan ke jurnal (kirim ulang setelah JOURNAL_RETRY_MS);
+    // jika server sudah menyimpan record, kunci (device_id, boot_id, seq) membuatnya
+    // dibalas duplikat, bukan disimpan dua kali.
+    if (!reused || !isStaleSocketError(httpCode)) break;
+    laravelStats.staleRetries++;
   }
-  
-  lastWifiCheckTime = millis();
+  return httpCode;
 }
 
-bool sendToLaravel(const SystemState& state) {
+bool sendToLaravel(const WeighingRecord& record) {
   if (WiFi.status() != WL_CONNECTED) return false;
   
-  WiFiClientSecure clientSecure;
-  clientSecure.setInsecure(); // Bypass SSL Certificate check (development only)
-  
-  HTTPClient http;
   Serial.println("\n--- LARAVEL POST ---");
   
-  if (!http.begin(clientSecure, SERVER_URL)) {
-    Serial.println("HTTP init failed!");
-    return false;
-  }
-  
-  http.setTimeout(Config::HTTP_TIMEOUT);
-  http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-  http.addHeader("Connection", "close");
-  
   // Buat buffer char yang cukup besar (misal 256 karakter)
     char postData[256];
-
-    // Format data ke dalam buffer
-    // %.2f artinya float dengan 2 angka di belakang koma
-    // %s artinya string (char array)
-    snprintf(postData, sizeof(postData), 
-            "api_key=%s&berat=%.2f&fakultas=%s&jenis=%s", 
-            API_KEY, 
-            state.currentWeight, 
-            state.fakultas, 
-            state.waste.getDisplayName().c_str()); // .c_str() mengubah String jadi char*
+    // Berat sudah diformat integer ke "kg.xx" (RecordCodec::formatForm)
+    RecordCodec::formatForm(record, API_KEY, deviceId(), postData, sizeof(postData));
 
     Serial.print("Data: ");
     Serial.println(postData);
 
-    int httpCode = http.POST(postData);
-  bool success = false;
+  String response;
+  int httpCode = postLaravel(SERVER_URL, "application/x-www-form-urlencoded", postData, response);
+  if (httpCode <= 0) return false;
   
-  if (httpCode > 0) {
-    Serial.printf("HTTP Code: %d\n", httpCode);
-    String response = http.getString();
-    // Anggap sukses jika 200/201 atau ada kata "berhasil" di response body
-    success = (httpCode == 200 || httpCode == 201 || response.indexOf("berhasil") >= 0);
-    Serial.println(success ? "Database OK" : "Response unexpected");
-  } else {
-    Serial.printf("HTTP Error: %d - %s\n", httpCode, http.errorToString(httpCode).c_str());
-  }
-  
-  http.end();
-  clientSecure.stop();
+  // Anggap sukses jika 200/201 atau ada kata "berhasil" di response body
+  bool success = (httpCode == 200 || httpCode == 201 || response.indexOf("berhasil") >= 0);
+  Serial.println(success ? "Database OK" : "Response unexpected");
   return success;
 }
 
-bool sendToMQTT(PubSubClient& client, const SystemState& state) {
-  if (!client.connected()) {
-    connectMQTT(client);
-    if (!client.connected()) return false;
+// {"results":[true,false,...]} -> accepted[]. Return false jika jumlah tidak cocok.
+static bool parseBatchResults(const String& response, bool* accepted, size_t count) {
+  int pos = response.indexOf("\"results\"");
+  if (pos < 0) return false;
+  pos = response.indexOf('[', pos);
+  if (pos < 0) return false;
+  
+  size_t n = 0;
+  for (int i = pos + 1; i < (int)response.length() && response[i] != ']'; i++) {
+    char c = response[i];
+    if (c == ',' || isspace(static_cast<unsigned char>(c))) continue;
+    if (n >= count) return false;
+    accepted[n++] = (c == 't' || c == '1');
+    // Lewati sisa token (true / false / angka)
+    while (i + 1 < (int)response.length() && response[i + 1] != ',' && response[i + 1] != ']') i++;
+  }
+  return n == count;
+}
+
+bool sendBatchToLaravel(const WeighingRecord* records, size_t count, bool* accepted) {
+  for (size_t i = 0; i < count; i++) accepted[i] = false;
+  if (WiFi.status() != WL_CONNECTED || count == 0) return false;
+  
+  // Server lama tanpa endpoint batch: satu POST per record
+  if (count == 1 || batchUnsupported) {
+    bool any = false;
+    for (size_t i = 0; i < count; i++) {
+      accepted[i] = sendToLaravel(records[i]);
+      any = any || accepted[i];
+    }
+    return any;
   }
   
-    char payload[200];
+  // Body ~85 byte per record; statis karena stack worker dipakai handshake TLS
+  static char body[128 + Config::BATCH_MAX_RECORDS * 112];
+  static char batchUrl[160];
+  if (batchUrl[0] == '\0') snprintf(batchUrl, sizeof(batchUrl), "%s/batch", SERVER_URL);
+  
+  int n = snprintf(body, sizeof(body), "{\"api_key\":\"%s\",\"device_id\":\"%012llX\",\"records\":[", API_KEY,
+                   (unsigned long long)deviceId());
+  for (size_t i = 0; i < count && n > 0 && static_cast<size_t>(n) < sizeof(body); i++) {
+    n += RecordCodec::formatBatchEntry(records[i], i == 0, body + n, sizeof(body) - n);
+  }
+  if (n > 0 && static_cast<size_t>(n) < sizeof(body)) n += snprintf(body + n, sizeof(body) - n, "]}");
+  if (n <= 0 || static_cast<size_t>(n) >= sizeof(body)) return false;
+  
+  Serial.printf("\n--- LARAVEL BATCH POST (%u record, %d byte) ---\n", (unsigned)count, n);
+  String response;
+  int httpCode = postLaravel(batchUrl, "application/json", body, response);
+  if (httpCode == 404 || httpCode == 405) {
+    Serial.println("Endpoint batch tidak ada, kembali ke POST per record");
+    batchUnsupported = true;
+    return sendBatchToLaravel(records, count, accepted);
+  }
+  if (httpCode <= 0) return false;
+  
+  laravelStats.batches++;
+  laravelStats.batchRecords += count;
+  if ((httpCode != 200 && httpCode != 201) || !parseBatchResults(response, accepted, count)) {
+    for (size_t i = 0; i < count; i++) accepted[i] = false;
+    Serial.println("Response batch unexpected");
+    return false;
+  }
+  return true;
+}
 
-    snprintf(payload, sizeof(payload), 
-            "{\"weight\":%.2f,\"fakultas\":\"%s\",\"jenis\":\"%s\"}", 
-            state.currentWeight, 
-            state.fakultas, 
-            state.waste.getDisplayName().c_str());
+HttpSessionStats getHttpSessionStats() {
+  return laravelStats;
+}
+
+TlsHandshakeStats getTlsHandshakeStats() {
+  return laravelTls.handshakeStats();
+}
+
+uint64_t deviceId() {
+  // MAC WiFi 48-bit utuh: OUI saja tidak membedakan perangkat, dan memotong
+  // byte mana pun membuka peluang dua timbangan berbagi kunci idempoten.
+  // getEfuseMac() menyimpan oktet pertama MAC di byte terendah, jadi teks
+  // %012llX = MAC dengan urutan byte terbalik (sama dengan client ID MQTT).
+  return ESP.getEfuseMac() & 0xFFFFFFFFFFFFull;
+}
+
+bool sendToMQTT(MqttPublisher& mqtt, uint32_t seq, const WeighingRecord& record) {
+    if (Config::MQTT_BINARY_RECORDS) {
+      uint8_t frame[RecordCodec::MAX_SIZE];
+      size_t len = RecordCodec::encode(record, deviceId(), frame, sizeof(frame));
+      bool success = len > 0 && mqtt.publish(MQTT_BIN_TOPIC, frame, len);
+      Serial.printf("MQTT biner #%lu (%u byte): %s\n", (unsigned long)seq, (unsigned)len,
+                    success ? "antri" : "antrean penuh");
+      return success;
+    }
+
+    char payload[200];
+    RecordCodec::formatMqttJson(record, deviceId(), payload, sizeof(payload));
 
     Serial.print("📡 MQTT Publish: ");
     Serial.println(payload);
 
-    bool success = client.publish(MQTT_TOPIC, payload);
-    Serial.println(success ? "MQTT Sent" : "MQTT Failed");
+    // Hanya masuk antrean: PUBACK menyusul lewat MqttPublisher::loop()
+    bool success = mqtt.publish(MQTT_TOPIC, payload);
+    Serial.println(success ? "MQTT Antri" : "MQTT Antrean Penuh");
     return success;
-}
\ No newline at end of file
+}
+
+bool sendBootReport(MqttPublisher& mqtt, const char* payload) {
+  bool success = mqtt.publish(MQTT_BOOT_TOPIC, payload);
+  Serial.println(success ? "Boot report antri" : "Boot report gagal");
+  return success;
+}
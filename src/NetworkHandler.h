@@ -4,14 +4,15 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <PubSubClient.h>
 #include <WiFiClientSecure.h>
-#include <ESP32Ping.h>
 #include <LiquidCrystal_I2C.h>
 #include <esp_task_wdt.h>
 
 #include "Config.h"
 #include "Types.h"
+#include "TlsSessionClient.h"
+#include "MqttPublisher.h"
+#include "RecordCodec.h"
 #include "credentials.h" // Pastikan file ini berisi WIFI_SSID, WIFI_PASSWORD, API_KEY
 
 // ==================== KONSTANTA SERVER ====================
@@ -19,28 +20,61 @@ extern const char* SERVER_URL;
 extern const char* MQTT_SERVER;
 extern const int MQTT_PORT;
 extern const char* MQTT_TOPIC;
-extern const char* PING_HOST;
+extern const char* MQTT_BOOT_TOPIC;
+extern const char* MQTT_BIN_TOPIC;
+
+// Counter sesi HTTPS Laravel (console 'net'): latensi per POST dipisah antara
+// koneksi baru (DNS + handshake TLS) dan koneksi keep-alive yang dipakai ulang
+struct HttpSessionStats {
+  uint32_t requests = 0;        // POST yang mendapat respons HTTP
+  uint32_t reused = 0;          // ... lewat koneksi yang sudah terbuka
+  uint32_t connects = 0;        // koneksi TLS baru yang dibuka
+  uint32_t staleRetries = 0;    // socket keep-alive basi, diulang dengan koneksi baru
+  uint32_t failures = 0;        // POST tanpa respons HTTP
+  uint32_t freshMsTotal = 0;
+  uint32_t freshMsMax = 0;
+  uint32_t reusedMsTotal = 0;
+  uint32_t reusedMsMax = 0;
+  uint32_t batches = 0;         // POST batch yang mendapat respons valid
+  uint32_t batchRecords = 0;    // record yang dibawa POST batch
+};
 
 // ==================== FUNGSI NETWORK ====================
 
-// Menghubungkan ke WiFi. 
-// Parameter 'lcd' opsional (bisa nullptr jika tidak ingin update layar)
-bool connectWiFi(LiquidCrystal_I2C* lcd = nullptr);
+// Host & port server Laravel dari SERVER_URL (target ReachabilityProbe)
+bool laravelEndpoint(char* host, size_t hostLen, uint16_t& port);
 
-// Menghubungkan ke Broker MQTT
-void connectMQTT(PubSubClient& client);
+// Mengirim data ke Laravel lewat sesi HTTPS keep-alive (koneksi TLS dipakai
+// ulang, dibuka ulang otomatis jika putus / idle > HTTPS_IDLE_TIMEOUT):
+//   api_key=...&berat=5.20&fakultas=FT&jenis=Organik&device_id=A1B2C3D4E5F6&boot_id=3&seq=17
+// (device_id, boot_id, seq) adalah kunci idempoten: server menyimpan record
+// sekali dan membalas kiriman ulang dengan sukses ({"status":"berhasil",
+// "duplikat":true}), jadi timeout setelah server menyimpan aman dikirim ulang.
+bool sendToLaravel(const WeighingRecord& record);
+HttpSessionStats getHttpSessionStats();
 
-// Mengecek apakah internet benar-benar hidup (ping google)
-bool checkNetworkHealth();
+// Kirim beberapa record dalam satu POST JSON ke SERVER_URL + "/batch":
+//   {"api_key":"...","device_id":"A1B2C3D4E5F6","records":[{"boot_id":3,"seq":17,
+//    "berat":"5.20","fakultas":"FT","jenis":"Organik"},...]}
+// Server membalas hasil per record: {"results":[true,false,...]}; record yang
+// kuncinya sudah tersimpan dibalas true (idempoten, seperti sendToLaravel).
+// accepted[i] = record i disimpan. Return false jika tidak ada respons valid
+// (semua dianggap gagal). Server tanpa endpoint batch (404/405) -> satu POST
+// per record seperti sendToLaravel(), batch tidak dicoba lagi sampai reboot.
+bool sendBatchToLaravel(const WeighingRecord* records, size_t count, bool* accepted);
+// Handshake TLS penuh vs resumed (session ID / ticket) beserta durasinya
+TlsHandshakeStats getTlsHandshakeStats();
 
-// Mengelola koneksi WiFi (reconnect jika putus)
-// Memerlukan akses ke SystemState untuk update flag offlineMode
-void manageWiFiConnection(SystemState& state, unsigned long& lastWifiCheckTime);
+// ID perangkat (kunci idempoten & record biner): MAC WiFi 48-bit (efuse),
+// dikirim sebagai 12 digit hex
+uint64_t deviceId();
 
-// Mengirim data ke Laravel
-bool sendToLaravel(const SystemState& state);
+// Antri record ke MQTT_TOPIC sebagai JSON, atau ke MQTT_BIN_TOPIC sebagai
+// RecordCodec jika Config::MQTT_BINARY_RECORDS (QoS 1). Return false jika
+// antrean MQTT penuh.
+bool sendToMQTT(MqttPublisher& mqtt, uint32_t seq, const WeighingRecord& record);
 
-// Mengirim data ke MQTT
-bool sendToMQTT(PubSubClient& client, const SystemState& state);
+// Telemetri profil boot (JSON dari BootProfiler::toJson) ke MQTT_BOOT_TOPIC
+bool sendBootReport(MqttPublisher& mqtt, const char* payload);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "ReachabilityProbe.h"
+#include <string.h>
+
+// ==================== IMPLEMENTASI ====================
+
+ReachabilityProbe::ReachabilityProbe(Hal::Connector& connector) : connector_(connector) {}
+
+void ReachabilityProbe::setTarget(const char* host, uint16_t port) {
+  copyText(host_, host);
+  port_ = port;
+}
+
+void ReachabilityProbe::tick(uint32_t now) {
+  if (host_[0] == '\0') return;
+
+  if (!probing_) {
+    if (!due_ && static_cast<int32_t>(now - nextMs_) < 0) return;
+    due_ = false;
+    startedMs_ = now;
+    if (!connector_.start(host_, port_)) {
+      stats_.refused++;
+      finish(false, now);
+      return;
+    }
+    probing_ = true;
+  }
+
+  switch (connector_.poll()) {
+    case Hal::Connector::Status::CONNECTED:
+      connector_.close();
+      finish(true, now);
+      break;
+    case Hal::Connector::Status::FAILED:
+      connector_.close();
+      stats_.refused++;
+      finish(false, now);
+      break;
+    case Hal::Connector::Status::PENDING:
+      if (now - startedMs_ >= Config::PROBE_TIMEOUT) {
+        connector_.close();
+        stats_.timeouts++;
+        finish(false, now);
+      }
+      break;
+  }
+}
+
+void ReachabilityProbe::linkDown() {
+  if (probing_) connector_.close();
+  probing_ = false;
+  reachable_ = false;
+  rate_ = 0;
+  failStreak_ = 0;
+  due_ = true;
+}
+
+uint32_t ReachabilityProbe::nextProbeInMs(uint32_t now) const {
+  if (probing_ || due_ || static_cast<int32_t>(now - nextMs_) >= 0) return 0;
+  return nextMs_ - now;
+}
+
+void ReachabilityProbe::finish(bool ok, uint32_t now) {
+  probing_ = false;
+  stats_.probes++;
+
+  // EWMA 1/2: satu sukses dari 0 langsung 500 (online), dua gagal dari 1000 -> 250
+  rate_ = static_cast<uint16_t>((rate_ + (ok ? 1000 : 0)) / 2);
+  if (ok) {
+    uint32_t rtt = now - startedMs_;
+    stats_.successes++;
+    if (rtt > stats_.rttMsMax) stats_.rttMsMax = rtt;
+    // EWMA 1/8 seperti SRTT TCP; sampel pertama langsung dipakai
+    srttMs_ = stats_.successes == 1 ? rtt : srttMs_ + ((static_cast<int32_t>(rtt) - static_cast<int32_t>(srttMs_)) >> 3);
+    failStreak_ = 0;
+  } else if (failStreak_ < 31) {
+    failStreak_++;
+  }
+
+  if (rate_ >= Config::PROBE_ONLINE_PERMILLE) reachable_ = true;
+  else if (rate_ < Config::PROBE_OFFLINE_PERMILLE) reachable_ = false;
+
+  uint32_t delay = Config::PROBE_INTERVAL;
+  if (!ok) {
+    delay = Config::PROBE_BACKOFF_MAX;
+    if (failStreak_ <= 16 && (Config::PROBE_BACKOFF_MIN << (failStreak_ - 1)) < Config::PROBE_BACKOFF_MAX) {
+      delay = Config::PROBE_BACKOFF_MIN << (failStreak_ - 1);
+    }
+  }
+  nextMs_ = now + delay;
+}
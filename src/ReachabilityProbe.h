@@ -0,0 +1,70 @@
+#ifndef REACHABILITY_PROBE_H
+#define REACHABILITY_PROBE_H
+
+#include <stdint.h>
+#include "Config.h"
+#include "Hal.h"
+
+// ==================== PROBE KETERJANGKAUAN SERVER ====================
+// Pengganti ping ICMP ke 8.8.8.8 (blocking, dan yang dicek Google, bukan
+// server upload): connect TCP non-blocking ke host:port server Laravel,
+// langsung ditutup begitu tersambung. tick() hanya memulai / memeriksa
+// connect, tidak pernah menunggu.
+//
+//   - hasil probe masuk EWMA 1/2 tingkat sukses (permil) + EWMA 1/8 RTT
+//   - reachable() pakai histeresis: naik di >= PROBE_ONLINE_PERMILLE,
+//     turun di < PROBE_OFFLINE_PERMILLE (dua gagal beruntun dari 100%)
+//   - terjangkau: probe tiap PROBE_INTERVAL; gagal: backoff eksponensial
+//     PROBE_BACKOFF_MIN x2 .. PROBE_BACKOFF_MAX
+//   - connect yang tidak selesai dalam PROBE_TIMEOUT dihitung gagal
+
+struct ProbeStats {
+  uint32_t probes = 0;          // probe yang selesai (sukses + gagal)
+  uint32_t successes = 0;
+  uint32_t refused = 0;         // gagal cepat: RST, DNS gagal, socket habis
+  uint32_t timeouts = 0;        // tidak ada jawaban dalam PROBE_TIMEOUT
+  uint32_t rttMsMax = 0;
+};
+
+class ReachabilityProbe {
+public:
+  explicit ReachabilityProbe(Hal::Connector& connector);
+
+  // 'host' disalin
+  void setTarget(const char* host, uint16_t port);
+
+  // Mulai / periksa probe. Panggil tiap loop selama WiFi tersambung.
+  void tick(uint32_t now);
+
+  // WiFi putus: batalkan probe, anggap tidak terjangkau, dan probe langsung
+  // begitu tick() dipanggil lagi (setelah WiFi tersambung)
+  void linkDown();
+
+  bool reachable() const { return reachable_; }
+  uint16_t successPermille() const { return rate_; }
+  uint32_t smoothedRttMs() const { return srttMs_; }
+  bool probing() const { return probing_; }
+  // Sisa waktu sampai probe berikutnya (0 = sedang / segera probe)
+  uint32_t nextProbeInMs(uint32_t now) const;
+  const char* host() const { return host_; }
+  uint16_t port() const { return port_; }
+  const ProbeStats& stats() const { return stats_; }
+
+private:
+  void finish(bool ok, uint32_t now);
+
+  Hal::Connector& connector_;
+  char host_[64] = "";
+  uint16_t port_ = 443;
+  bool probing_ = false;
+  bool reachable_ = false;
+  uint32_t startedMs_ = 0;
+  uint32_t nextMs_ = 0;
+  bool due_ = true;             // probe segera, tanpa menunggu nextMs_
+  uint16_t rate_ = 0;           // permil
+  uint32_t srttMs_ = 0;
+  uint8_t failStreak_ = 0;
+  ProbeStats stats_;
+};
+
+#endif
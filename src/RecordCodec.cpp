@@ -0,0 +1,121 @@
+#include "RecordCodec.h"
+#include <stdio.h>
+#include <string.h>
+#include "CaptureFrame.h"
+#include "DeviceProfile.h"
+#include "FixedWeight.h"
+
+using Capture::crc16;
+using Capture::getLe;
+using Capture::putLe;
+
+namespace {
+  // Indeks = ID Category
+  constexpr const char* CATEGORY_NAMES[] = { "--", "Organik", "Anorganik", "Botol", "Kertas", "Residu" };
+  constexpr size_t CATEGORY_COUNT = sizeof(CATEGORY_NAMES) / sizeof(CATEGORY_NAMES[0]);
+
+  constexpr size_t nameLength(const char* name) { return *name ? 1 + nameLength(name + 1) : 0; }
+  constexpr size_t longestName(size_t i) {
+    return i == CATEGORY_COUNT ? 0
+         : nameLength(CATEGORY_NAMES[i]) > longestName(i + 1) ? nameLength(CATEGORY_NAMES[i]) : longestName(i + 1);
+  }
+  static_assert(longestName(0) == RecordCodec::CATEGORY_NAME_MAX, "CATEGORY_NAME_MAX tidak sesuai tabel jenis");
+  constexpr size_t NAME_LEN = sizeof(WeighingRecord().fakultas);
+
+  // ID preset hanya jika namanya persis sama (huruf besar/kecil ikut), agar
+  // decode menghasilkan string yang identik dengan yang dikirim
+  uint8_t fakultasId(const char* fakultas) {
+    for (size_t i = 0; i < profilePresetCount(); i++) {
+      if (strcmp(profilePresetName(i), fakultas) == 0) return static_cast<uint8_t>(i);
+    }
+    return RecordCodec::CUSTOM_FAKULTAS;
+  }
+}
+
+namespace RecordCodec {
+
+  Category categoryFromName(const char* jenis) {
+    for (size_t i = 1; i < CATEGORY_COUNT; i++) {
+      if (strcmp(jenis, CATEGORY_NAMES[i]) == 0) return static_cast<Category>(i);
+    }
+    return Category::UNKNOWN;
+  }
+
+  const char* categoryName(Category id) {
+    size_t index = static_cast<size_t>(id);
+    return index < CATEGORY_COUNT ? CATEGORY_NAMES[index] : CATEGORY_NAMES[0];
+  }
+
+  size_t encode(const WeighingRecord& record, uint64_t deviceId, uint8_t* out, size_t capacity) {
+    const uint8_t id = fakultasId(record.fakultas);
+    const bool withName = id == CUSTOM_FAKULTAS;
+    const size_t size = withName ? MAX_SIZE : BASE_SIZE;
+    if (capacity < size) return 0;
+
+    out[0] = VERSION;
+    out[1] = static_cast<uint8_t>(categoryFromName(record.jenis));
+    out[2] = id;
+    out[3] = withName ? FLAG_FAKULTAS_NAME : 0;
+    putLe(out + 4, static_cast<uint32_t>(deviceId), 4);
+    putLe(out + 8, static_cast<uint32_t>(deviceId >> 32), 2);
+    putLe(out + 10, record.bootId, 4);
+    putLe(out + 14, record.seq, 4);
+    putLe(out + 18, static_cast<uint32_t>(record.weightMg), 4);
+    if (withName) strncpy(reinterpret_cast<char*>(out + 22), record.fakultas, NAME_LEN);
+    putLe(out + size - 2, crc16(out, size - 2), 2);
+    return size;
+  }
+
+  bool decode(const uint8_t* in, size_t len, Decoded& out) {
+    if (len < BASE_SIZE || in[0] != VERSION) return false;
+    const bool withName = (in[3] & FLAG_FAKULTAS_NAME) != 0;
+    const size_t size = withName ? MAX_SIZE : BASE_SIZE;
+    if (len != size || crc16(in, size - 2) != getLe(in + size - 2, 2)) return false;
+
+    out.version = in[0];
+    out.category = static_cast<Category>(in[1]);
+    out.fakultasId = in[2];
+    out.deviceId = getLe(in + 4, 4) | (static_cast<uint64_t>(getLe(in + 8, 2)) << 32);
+    out.record = WeighingRecord();
+    out.record.bootId = getLe(in + 10, 4);
+    out.record.seq = getLe(in + 14, 4);
+    out.record.weightMg = static_cast<int32_t>(getLe(in + 18, 4));
+    copyText(out.record.jenis, categoryName(out.category));
+
+    if (withName) {
+      memcpy(out.record.fakultas, in + 22, NAME_LEN - 1);
+      out.record.fakultas[NAME_LEN - 1] = '\0';
+      return true;
+    }
+    const char* name = profilePresetName(out.fakultasId);
+    if (name == nullptr) return false;
+    copyText(out.record.fakultas, name);
+    return true;
+  }
+
+  int formatForm(const WeighingRecord& record, const char* apiKey, uint64_t deviceId,
+                 char* out, size_t capacity) {
+    char weightText[12];
+    FixedWeight::formatKg(weightText, sizeof(weightText), record.weightMg);
+    return snprintf(out, capacity, "api_key=%s&berat=%s&fakultas=%s&jenis=%s&device_id=%012llX&boot_id=%lu&seq=%lu",
+                    apiKey, weightText, record.fakultas, record.jenis, (unsigned long long)deviceId,
+                    (unsigned long)record.bootId, (unsigned long)record.seq);
+  }
+
+  int formatBatchEntry(const WeighingRecord& record, bool first, char* out, size_t capacity) {
+    char weightText[12];
+    FixedWeight::formatKg(weightText, sizeof(weightText), record.weightMg);
+    return snprintf(out, capacity, "%s{\"boot_id\":%lu,\"seq\":%lu,\"berat\":\"%s\",\"fakultas\":\"%s\",\"jenis\":\"%s\"}",
+                    first ? "" : ",", (unsigned long)record.bootId, (unsigned long)record.seq, weightText,
+                    record.fakultas, record.jenis);
+  }
+
+  int formatMqttJson(const WeighingRecord& record, uint64_t deviceId, char* out, size_t capacity) {
+    char weightText[12];
+    FixedWeight::formatKg(weightText, sizeof(weightText), record.weightMg);
+    return snprintf(out, capacity,
+                    "{\"device_id\":\"%012llX\",\"boot_id\":%lu,\"seq\":%lu,\"weight\":%s,\"fakultas\":\"%s\",\"jenis\":\"%s\"}",
+                    (unsigned long long)deviceId, (unsigned long)record.bootId, (unsigned long)record.seq,
+                    weightText, record.fakultas, record.jenis);
+  }
+}
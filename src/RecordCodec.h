@@ -0,0 +1,85 @@
+#ifndef RECORD_CODEC_H
+#define RECORD_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Types.h"
+
+// ==================== RECORD BINER (UPLINK) ====================
+// Pengganti teks JSON / form untuk satu penimbangan. Struct tetap
+// little-endian, nama diganti ID kecil:
+//
+//   off  ukuran  isi
+//   0    1       versi format (VERSION)
+//   1    1       ID jenis (Category, 0 = tidak dikenal)
+//   2    1       ID fakultas = indeks preset DeviceProfile, 0xFF = kustom
+//   3    1       flag: bit 0 = nama fakultas ikut di akhir (kustom)
+//   4    6       device ID = MAC 48-bit (little-endian, lihat deviceId())
+//   10   4       boot ID jurnal (little-endian)
+//   14   4       seq jurnal (little-endian)
+//   18   4       berat mg (little-endian, two's complement)
+//   22   8       [flag bit 0] nama fakultas (nul-padded)
+//   22/30 2      CRC-16/CCITT-FALSE atas semua byte sebelumnya (little-endian)
+//
+// 24 byte untuk fakultas preset, 32 byte untuk kustom. (device ID, boot ID,
+// seq) = kunci idempoten yang sama dengan form Laravel, jadi subscriber bisa
+// membuang duplikat kiriman ulang. v1 (device ID 4 byte, tanpa boot ID) tidak
+// lagi dikirim; decoder menolak versi yang tidak dikenalnya.
+// Decoder host: tools/record_codec.py (juga membaca v1).
+
+namespace RecordCodec {
+
+  constexpr uint8_t VERSION = 2;
+  constexpr size_t BASE_SIZE = 24;
+  constexpr size_t MAX_SIZE = 32;
+  constexpr uint8_t CUSTOM_FAKULTAS = 0xFF;
+  constexpr uint8_t FLAG_FAKULTAS_NAME = 0x01;
+
+  // ID tetap: nilai tidak boleh diubah, hanya ditambah di belakang
+  enum class Category : uint8_t {
+    UNKNOWN = 0,
+    ORGANIK = 1,
+    ANORGANIK = 2,
+    BOTOL = 3,
+    KERTAS = 4,
+    RESIDU = 5
+  };
+
+  // Panjang nama jenis terpanjang ("Anorganik", tanpa nul); format yang
+  // menyimpan nama jenis (RecordJournal) mengukur field-nya dari sini
+  constexpr size_t CATEGORY_NAME_MAX = 9;
+
+  Category categoryFromName(const char* jenis);
+  // Nama seperti WeighingRecord::jenis, "--" untuk UNKNOWN / ID asing
+  const char* categoryName(Category id);
+
+  struct Decoded {
+    uint8_t version = 0;
+    uint64_t deviceId = 0;
+    Category category = Category::UNKNOWN;
+    uint8_t fakultasId = CUSTOM_FAKULTAS;
+    WeighingRecord record;      // termasuk bootId & seq
+  };
+
+  // Tulis ke 'out' (tanpa heap); bootId & seq diambil dari record.
+  // Return jumlah byte, 0 jika 'capacity' kurang.
+  size_t encode(const WeighingRecord& record, uint64_t deviceId, uint8_t* out, size_t capacity);
+
+  // Return false jika versi asing, panjang tidak cocok, atau CRC salah
+  bool decode(const uint8_t* in, size_t len, Decoded& out);
+
+  // ==================== TEKS (FORM / JSON) ====================
+  // Payload teks yang dikirim firmware (NetworkHandler) dan diukur runner
+  // native. Return seperti snprintf: panjang penuh, >= capacity jika terpotong.
+
+  // Form POST Laravel: api_key=..&berat=..&fakultas=..&jenis=..&device_id=..&boot_id=..&seq=..
+  int formatForm(const WeighingRecord& record, const char* apiKey, uint64_t deviceId,
+                 char* out, size_t capacity);
+  // Satu elemen array "records" batch JSON, diawali ',' jika bukan yang pertama
+  int formatBatchEntry(const WeighingRecord& record, bool first, char* out, size_t capacity);
+  // Payload MQTT teks dengan kunci idempoten yang sama:
+  // {"device_id":"..","boot_id":..,"seq":..,"weight":..,"fakultas":"..","jenis":".."}
+  int formatMqttJson(const WeighingRecord& record, uint64_t deviceId, char* out, size_t capacity);
+}
+
+#endif
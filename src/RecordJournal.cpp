@@ -0,0 +1,220 @@
+#include "RecordJournal.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "Config.h"
+#include "CaptureFrame.h"
+#include "RecordCodec.h"
+#include "Settings.h"
+
+namespace {
+  constexpr uint8_t MAGIC_0 = 0x4A;
+  constexpr uint8_t MAGIC_1 = 0x53;
+  constexpr uint8_t MAGIC_1_V1 = 0x52;    // "JR": jenis 16 byte, tanpa boot ID
+  constexpr size_t FAKULTAS_LEN = 8;
+  constexpr size_t JENIS_LEN = 12;
+  constexpr size_t JENIS_LEN_V1 = 16;
+  constexpr size_t BOOT_OFFSET = 30;
+  constexpr size_t CRC_OFFSET = RecordJournal::ENTRY_SIZE - 2;
+  static_assert(sizeof(WeighingRecord().fakultas) == FAKULTAS_LEN &&
+                sizeof(WeighingRecord().jenis) == JENIS_LEN_V1, "format entri jurnal berubah");
+  static_assert(RecordCodec::CATEGORY_NAME_MAX < JENIS_LEN, "nama jenis terpanjang tidak muat di entri jurnal");
+  // append() membandingkan byte: batas harus jatuh tepat di akhir entri
+  static_assert(Config::JOURNAL_MAX_BYTES % RecordJournal::ENTRY_SIZE == 0,
+                "JOURNAL_MAX_BYTES harus kelipatan RecordJournal::ENTRY_SIZE");
+
+  // 'out' sudah di-nol-kan: salin maksimal 'cap' byte teks, sisanya tetap nul
+  void putText(uint8_t* out, const char* text, size_t cap) {
+    memcpy(out, text, strnlen(text, cap));
+  }
+}
+
+// ==================== FORMAT ENTRI ====================
+
+void RecordJournal::encode(uint32_t seq, const WeighingRecord& record, uint8_t out[ENTRY_SIZE]) {
+  memset(out, 0, ENTRY_SIZE);
+  out[0] = MAGIC_0;
+  out[1] = MAGIC_1;
+  Capture::putLe(out + 2, seq, 4);
+  Capture::putLe(out + 6, static_cast<uint32_t>(record.weightMg), 4);
+  putText(out + 10, record.fakultas, FAKULTAS_LEN - 1);
+  putText(out + 18, record.jenis, JENIS_LEN - 1);
+  Capture::putLe(out + BOOT_OFFSET, record.bootId, 4);
+  Capture::putLe(out + CRC_OFFSET, Capture::crc16(out + 2, CRC_OFFSET - 2), 2);
+}
+
+bool RecordJournal::decode(const uint8_t in[ENTRY_SIZE], uint32_t& seq, WeighingRecord& out) {
+  const bool v1 = in[1] == MAGIC_1_V1;
+  if (in[0] != MAGIC_0 || (in[1] != MAGIC_1 && !v1)) return false;
+  if (Capture::crc16(in + 2, CRC_OFFSET - 2) != Capture::getLe(in + CRC_OFFSET, 2)) return false;
+  seq = Capture::getLe(in + 2, 4);
+  out.weightMg = static_cast<int32_t>(Capture::getLe(in + 6, 4));
+  memcpy(out.fakultas, in + 10, FAKULTAS_LEN);
+  out.fakultas[FAKULTAS_LEN - 1] = '\0';
+  const size_t jenisLen = v1 ? JENIS_LEN_V1 : JENIS_LEN;
+  memcpy(out.jenis, in + 18, jenisLen);
+  out.jenis[jenisLen - 1] = '\0';
+  out.bootId = v1 ? 0 : Capture::getLe(in + BOOT_OFFSET, 4);
+  out.seq = seq;
+  return true;
+}
+
+// ==================== IMPLEMENTASI ====================
+
+RecordJournal::RecordJournal(Hal::FileStore& files, const char* name) : files_(files) {
+  snprintf(path_, sizeof(path_), "/%s.bin", name);
+  snprintf(ackKey_, sizeof(ackKey_), "%s_ack", name);
+  snprintf(seqKey_, sizeof(seqKey_), "%s_seq", name);
+  snprintf(bootKey_, sizeof(bootKey_), "%s_boot", name);
+}
+
+uint32_t RecordJournal::open() {
+  int32_t size = files_.size(path_);
+  uint32_t fileBytes = size > 0 ? static_cast<uint32_t>(size) : 0;
+  ackOffset_ = static_cast<uint32_t>(loadPersistedInt(ackKey_, 0));
+  nextSeq_ = static_cast<uint32_t>(loadPersistedInt(seqKey_, 1));
+  droppedTail_ = 0;
+  corrupt_ = 0;
+  bootId_ = static_cast<uint32_t>(loadPersistedInt(bootKey_, 0)) + 1;
+  savePersistedInt(bootKey_, static_cast<int32_t>(bootId_));
+
+  // ack > ukuran: reboot di antara hapus file dan simpan ack 0 saat compaction
+  // Langsung disimpan: ack lama tidak boleh berlaku untuk entri baru di file berikutnya
+  if (ackOffset_ > fileBytes || ackOffset_ % ENTRY_SIZE != 0) {
+    ackOffset_ = 0;
+    savePersistedInt(ackKey_, 0);
+  }
+
+  uint8_t entry[ENTRY_SIZE];
+  WeighingRecord record;
+  uint32_t seq = 0;
+  uint32_t lastSeq = 0;
+  // Entri ter-ack terakhir ikut dibaca: seq tersimpan hanya diperbarui saat compaction
+  if (ackOffset_ >= ENTRY_SIZE && files_.read(path_, ackOffset_ - ENTRY_SIZE, entry, ENTRY_SIZE) &&
+      decode(entry, seq, record)) {
+    lastSeq = seq;
+  }
+  // Entri rusak di tengah (bit flip flash) dilewati dan dihitung, bukan alasan
+  // membuang semua record sesudahnya; peek() melompatinya saat dikirim.
+  // Yang dipotong hanya sisa entri yang tidak lengkap di ujung file.
+  uint32_t offset = ackOffset_;
+  for (; offset + ENTRY_SIZE <= fileBytes; offset += ENTRY_SIZE) {
+    if (files_.read(path_, offset, entry, ENTRY_SIZE) && decode(entry, seq, record)) {
+      lastSeq = seq;
+    } else {
+      corrupt_++;
+      logPrintf("JURNAL: entri rusak @%lu dilewati\n", (unsigned long)offset);
+    }
+  }
+  endOffset_ = offset;
+  if (lastSeq >= nextSeq_) nextSeq_ = lastSeq + 1;
+
+  if (endOffset_ < fileBytes) {
+    droppedTail_ = 1;
+    files_.truncate(path_, endOffset_);
+    logPrintf("JURNAL: ekor tidak lengkap %lu byte dipotong\n", (unsigned long)(fileBytes - endOffset_));
+  }
+  if (endOffset_ > 0 && ackOffset_ == endOffset_) compact();
+  return unacked();
+}
+
+uint32_t RecordJournal::append(const WeighingRecord& record) {
+  if (endOffset_ + ENTRY_SIZE > Config::JOURNAL_MAX_BYTES) return 0;
+
+  uint8_t entry[ENTRY_SIZE];
+  WeighingRecord stamped = record;
+  stamped.bootId = bootId_;
+  encode(nextSeq_, stamped, entry);
+  if (!files_.append(path_, entry, sizeof(entry))) {
+    // Tulisan sebagian akan menggeser semua entri berikutnya
+    files_.truncate(path_, endOffset_);
+    return 0;
+  }
+  endOffset_ += ENTRY_SIZE;
+  return nextSeq_++;
+}
+
+bool RecordJournal::peek(uint32_t index, WeighingRecord& out, uint32_t& seq) {
+  uint8_t entry[ENTRY_SIZE];
+  if (index > 0) {
+    return index < unacked() && files_.read(path_, ackOffset_ + index * ENTRY_SIZE, entry, ENTRY_SIZE) &&
+           decode(entry, seq, out);
+  }
+  while (unacked() > 0) {
+    if (files_.read(path_, ackOffset_, entry, ENTRY_SIZE) && decode(entry, seq, out)) return true;
+    // Sudah divalidasi open(); rusak setelahnya (flash) dilewati agar antrean tidak macet
+    logPrintf("JURNAL: entri rusak @%lu dilewati\n", (unsigned long)ackOffset_);
+    ack();
+  }
+  return false;
+}
+
+bool RecordJournal::peekSeq(uint32_t seq, WeighingRecord& out) {
+  // Entri sejak open() berurutan tanpa celah di ujung file
+  if (seq >= nextSeq_ || nextSeq_ - seq > unacked()) return false;
+  uint8_t entry[ENTRY_SIZE];
+  uint32_t found = 0;
+  return files_.read(path_, endOffset_ - (nextSeq_ - seq) * ENTRY_SIZE, entry, ENTRY_SIZE) &&
+         decode(entry, found, out) && found == seq;
+}
+
+bool RecordJournal::ack() {
+  if (unacked() == 0) return false;
+  ackOffset_ += ENTRY_SIZE;
+  if (ackOffset_ < endOffset_) return savePersistedInt(ackKey_, static_cast<int32_t>(ackOffset_));
+  return compact();
+}
+
+bool RecordJournal::compact() {
+  // Semua terkirim: file dibuang. seq disimpan sebelum file dihapus (seq tidak
+  // boleh dipakai ulang), ack 0 sesudahnya (open() menangani ack > ukuran).
+  bool ok = savePersistedInt(seqKey_, static_cast<int32_t>(nextSeq_));
+  ok = files_.remove(path_) && ok;
+  ackOffset_ = 0;
+  endOffset_ = 0;
+  return savePersistedInt(ackKey_, 0) && ok;
+}
+
+void RecordJournal::clear() {
+  files_.remove(path_);
+  erasePersisted(ackKey_);
+  erasePersisted(seqKey_);
+  // seq mulai dari 1 lagi: boot ID baru (disimpan sebelum append berikutnya)
+  // supaya (boot ID, seq) record sesudah clear() tidak sama dengan yang sebelumnya
+  bootId_++;
+  savePersistedInt(bootKey_, static_cast<int32_t>(bootId_));
+  ackOffset_ = 0;
+  endOffset_ = 0;
+  nextSeq_ = 1;
+  droppedTail_ = 0;
+  corrupt_ = 0;
+}
+
+// ==================== BENCHMARK ====================
+
+JournalBench benchmarkJournal(Hal::FileStore& files, uint32_t count, uint32_t (*nowUs)()) {
+  JournalBench result = { count, 0, 0, false };
+  RecordJournal journal(files, "jb");
+  journal.clear();
+  journal.open();
+
+  WeighingRecord record;
+  record.weightMg = 5200000;
+  copyText(record.fakultas, "BENCH");
+  copyText(record.jenis, "Organik");
+
+  uint32_t appended = 0;
+  uint32_t start = nowUs();
+  while (appended < count && journal.append(record) != 0) appended++;
+  result.appendUs = nowUs() - start;
+
+  uint32_t replayed = 0;
+  uint32_t seq = 0;
+  start = nowUs();
+  while (journal.peek(0, record, seq) && journal.ack()) replayed++;
+  result.replayUs = nowUs() - start;
+
+  result.ok = appended == count && replayed == count;
+  journal.clear();
+  return result;
+}
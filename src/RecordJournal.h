@@ -0,0 +1,113 @@
+#ifndef RECORD_JOURNAL_H
+#define RECORD_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Types.h"
+
+// ==================== JURNAL RECORD (STORE-AND-FORWARD) ====================
+// Setiap penimbangan yang dikonfirmasi ditulis dulu ke file append-only
+// (LittleFS), baru dikirim ke server dari urutan terdepan. Entri ukuran tetap:
+//
+//   off  ukuran  isi
+//   0    2       magic 0x4A 0x53 ("JS")
+//   2    4       seq (little-endian, naik terus, juga setelah reboot)
+//   6    4       berat mg (little-endian, two's complement)
+//   10   8       fakultas (nul-padded)
+//   18   12      jenis (nul-padded)
+//   30   4       boot ID saat record dibuat (little-endian)
+//   34   2       CRC-16/CCITT-FALSE atas byte 2..33 (little-endian)
+//
+// Entri format lama ("JR", jenis 16 byte, tanpa boot ID) tetap dibaca
+// dengan boot ID 0, jadi jurnal yang belum terkirim saat update tidak hilang.
+//
+// (deviceId, boot ID, seq) adalah kunci idempoten record di server: seq
+// disimpan di NVS dan tidak pernah dipakai ulang, kecuali clear() yang
+// mengulang seq dari 1. Boot ID (counter NVS) naik setiap open() dan juga
+// setiap clear(), jadi kunci tetap unik meski jurnal dihapus di tengah boot.
+//
+// Offset ack (byte pertama yang belum diterima server) disimpan di NVS,
+// jadi record yang sudah terkirim tidak dikirim ulang setelah reboot.
+// Ekor tidak lengkap (listrik mati di tengah append) dipotong saat open();
+// entri utuh yang CRC-nya salah dilewati dan dihitung, entri sesudahnya tetap
+// dikirim.
+// Begitu semua entri di-ack, file dihapus dan jurnal mulai dari offset 0.
+
+class RecordJournal {
+public:
+  static constexpr size_t ENTRY_SIZE = 36;
+
+  // 'name' menentukan file ("/<name>.bin") dan key NVS ("<name>_ack",
+  // "<name>_seq"); maksimal 8 karakter (batas key NVS 15 karakter)
+  explicit RecordJournal(Hal::FileStore& files, const char* name = "jr");
+
+  // Naikkan boot ID, muat offset ack, validasi entri belum ter-ack (yang
+  // rusak dihitung di corruptEntries()), potong ekor tidak lengkap.
+  // Panggil sekali per boot. Return jumlah record yang menunggu (termasuk
+  // entri rusak, yang dilewati peek()).
+  uint32_t open();
+
+  // Tulis record di akhir jurnal dengan boot ID sekarang (record.bootId/seq
+  // diabaikan). Return seq, 0 jika jurnal penuh / gagal tulis.
+  uint32_t append(const WeighingRecord& record);
+
+  // Record ke-'index' yang belum di-ack (0 = terdepan). Return false jika
+  // tidak ada. out.bootId/seq berisi kunci idempoten entri.
+  // Entri terdepan yang rusak dilewati (di-ack) agar antrean tidak macet.
+  bool peek(uint32_t index, WeighingRecord& out, uint32_t& seq);
+
+  // Record 'seq' yang di-append sejak open() / clear() terakhir, dibaca
+  // langsung tanpa melewati / meng-ack entri lain. Return false jika sudah
+  // di-ack, rusak, atau bukan dari boot ini.
+  bool peekSeq(uint32_t seq, WeighingRecord& out);
+
+  // Server menerima record terdepan: majukan offset ack (tersimpan di NVS)
+  bool ack();
+
+  // Hapus file dan offset tersimpan (record yang belum terkirim hilang),
+  // seq mulai dari 1 dengan boot ID baru
+  void clear();
+
+  uint32_t unacked() const { return (endOffset_ - ackOffset_) / ENTRY_SIZE; }
+  uint32_t bytes() const { return endOffset_; }
+  uint32_t nextSeq() const { return nextSeq_; }
+  uint32_t bootId() const { return bootId_; }
+  // Entri tidak lengkap di ujung file yang dipotong open() (0 / 1)
+  uint32_t droppedTail() const { return droppedTail_; }
+  // Entri utuh dengan CRC / magic salah yang ditemukan open()
+  uint32_t corruptEntries() const { return corrupt_; }
+
+  // Boot ID diambil dari record.bootId
+  static void encode(uint32_t seq, const WeighingRecord& record, uint8_t out[ENTRY_SIZE]);
+  static bool decode(const uint8_t in[ENTRY_SIZE], uint32_t& seq, WeighingRecord& out);
+
+private:
+  bool compact();
+
+  Hal::FileStore& files_;
+  char path_[16];
+  char ackKey_[16];
+  char seqKey_[16];
+  char bootKey_[16];
+  uint32_t ackOffset_ = 0;
+  uint32_t endOffset_ = 0;
+  uint32_t nextSeq_ = 1;
+  uint32_t bootId_ = 0;
+  uint32_t droppedTail_ = 0;
+  uint32_t corrupt_ = 0;
+};
+
+// Ukur laju jurnal pada FileStore sebenarnya: 'count' append lalu replay
+// (peek + ack) sampai kosong, di jurnal terpisah ("jb") yang dihapus lagi.
+// nowUs: micros() di perangkat, jam host di native.
+struct JournalBench {
+  uint32_t count;
+  uint32_t appendUs;
+  uint32_t replayUs;
+  bool ok;
+};
+
+JournalBench benchmarkJournal(Hal::FileStore& files, uint32_t count, uint32_t (*nowUs)());
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// ==================== SPSC RING BUFFER ====================
+// Antrian lock-free satu produsen / satu konsumen.
+// Produsen (task akuisisi) hanya menulis 'head', konsumen (loop utama)
+// hanya menulis 'tail', sehingga tidak perlu mutex maupun critical section.
+// N harus pangkat dua agar indeks cukup di-mask.
+
+template <typename T, size_t N>
+class SampleRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Kapasitas harus pangkat dua");
+
+public:
+  // Dipanggil HANYA dari sisi produsen. Return false jika penuh (sampel dibuang).
+  bool push(const T& item) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail >= N) return false;
+
+    buffer_[head & (N - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Dipanggil HANYA dari sisi konsumen. Return false jika kosong.
+  bool pop(T& out) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) return false;
+
+    out = buffer_[tail & (N - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+private:
+  T buffer_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
+
+#endif
@@ -0,0 +1,591 @@
+#include "ScaleApp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ==================== IMPLEMENTASI ====================
+
+namespace {
+  // Angka untuk baris LCD 20 kolom dibatasi, supaya lebar terburuknya
+  // (dan panjang baris) tetap di dalam buffer
+  inline unsigned long lcdCap(uint32_t value, uint32_t max) { return value < max ? value : max; }
+}
+
+ScaleApp::ScaleApp(Hal::Display& display, Hal::Buttons& buttons, Hal::Buzzer& buzzer,
+                   Hal::SampleSource& source, Hal::Uplink& uplink, Hal::FileStore& files,
+                   RuntimeSettings& params)
+  : display_(display), buttons_(buttons), buzzer_(buzzer),
+    source_(source), uplink_(uplink), params_(params), pipeline_(params), journal_(files) {}
+
+void ScaleApp::begin(uint32_t now) {
+  // Profil memberi fakultas + faktor dasar; tabel multi-titik (jika ada) menimpanya.
+  // Keduanya dimuat dulu: batas drift re-tare dihitung dalam mg.
+  loadDeviceProfile(profile_);
+  copyText(state_.fakultas, profile_.fakultas);
+  pipeline_.calibration().setSingleFactor(profile_.mgPerCountQ16);
+  logPrintf("Profil: %s\n", profile_.fakultas);
+  if (loadCalibration(pipeline_.calibration())) {
+    logPrintf("Kalibrasi: %u titik dari NVS\n", (unsigned)pipeline_.calibration().pointCount());
+  }
+  pipeline_.restoreZeroPoint();
+  uint32_t unsent = journal_.open();
+  if (unsent > 0) logPrintf("Jurnal: %lu record belum terkirim\n", (unsigned long)unsent);
+  timers_.lastWeightRead = now;
+  timers_.lastLCDUpdate = now;
+  timers_.lastAcqReport = now;
+  timers_.lastZeroPersist = now;
+
+  buttons_.update();
+  if (buttons_.isDown(3)) {
+    state_.appState = AppState::MAINTENANCE;
+    menuIndex_ = profile_.preset < profilePresetCount() ? profile_.preset : 0;
+  }
+}
+
+void ScaleApp::showMainScreen() {
+  if (state_.appState == AppState::MAINTENANCE) {
+    showMaintenanceMenu();
+    return;
+  }
+  display_.showDefault(state_);
+  display_.showWeight(0);
+}
+
+void ScaleApp::tick(uint32_t now) {
+  lastTick_ = now;
+
+  // 1. Update Buttons
+  buttons_.update();
+
+  // 2. Network Maintenance
+  uplink_.maintain(state_, now);
+
+  // 3. Kuras ring buffer sampel di semua state agar tidak pernah penuh
+  drainSamples();
+  reportAcquisition(now);
+  persistZeroOffset(now);
+  processSendResults(now);
+  forwardJournal(now);
+  replayMqtt(now);
+
+  // 4. State Machine Logic
+  switch (state_.appState) {
+    case AppState::IDLE: {
+      // Read Weight (sampel sudah difilter oleh drainSamples)
+      if (state_.newDataReady && now - timers_.lastWeightRead >= Config::WEIGHT_READ_INTERVAL) {
+        state_.currentWeightMg = state_.filteredMg;
+        timers_.lastWeightRead = now;
+        state_.newDataReady = false;
+      }
+
+      // Update Display Weight
+      if (now - timers_.lastLCDUpdate >= Config::LCD_UPDATE_INTERVAL) {
+        if (abs(state_.currentWeightMg - state_.lastDisplayedWeightMg) > Config::MIN_WEIGHT_THRESHOLD_MG ||
+            state_.lastDisplayedWeightMg < 0) {
+          display_.showWeight(state_.currentWeightMg);
+          state_.lastDisplayedWeightMg = state_.currentWeightMg;
+        }
+        display_.showStability(state_.isStable);
+        timers_.lastLCDUpdate = now;
+      }
+
+      // Pesan status di baris atas hilang sendiri, kembali ke "Jenis: ..."
+      if (statusOverlay_ && now - timers_.statusMsgTimestamp > Config::STATUS_MSG_DURATION) {
+        statusOverlay_ = false;
+        restoreMainScreen();
+      }
+
+      // Update Status Icons (WiFi/MQTT) di baris bawah
+      if (now - timers_.lastStatusDisplay >= Config::STATUS_DISPLAY_INTERVAL) {
+        display_.showStatusIndicators(state_.offlineMode, uplink_.mqttConnected());
+        timers_.lastStatusDisplay = now;
+      }
+
+      processButtons();
+      handleSendData(now);
+      checkCalibrationChord(now);
+      break;
+    }
+
+    case AppState::SELECTING_SUBTYPE:
+      processButtons();
+      break;
+
+    case AppState::MAINTENANCE:
+      processMaintenance();
+      break;
+
+    case AppState::CALIBRATING:
+      processCalibration(now);
+      break;
+
+    case AppState::SHOWING_STATUS:
+      // Kembali ke tampilan awal setelah durasi tertentu
+      if (now - timers_.statusMsgTimestamp > Config::STATUS_MSG_DURATION) {
+        restoreMainScreen();
+        state_.appState = AppState::IDLE;
+      }
+      break;
+  }
+}
+
+void ScaleApp::selectType(const char* type, const char* subtype) {
+  state_.waste.setType(type, subtype);
+  buzzer_.tone(2500, 100);
+  restoreMainScreen();
+  state_.appState = AppState::IDLE;
+}
+
+void ScaleApp::restoreMainScreen() {
+  // showDefault() menghapus baris berat: paksa ditulis ulang di update berikutnya
+  display_.showDefault(state_);
+  state_.lastDisplayedWeightMg = -1;
+}
+
+void ScaleApp::processButtons() {
+  // Tombol 1: Organik / Anorganik (Umum)
+  if (buttons_.isPressed(0)) {
+    if (state_.appState == AppState::IDLE) {
+      selectType("Organik");
+    } else if (state_.appState == AppState::SELECTING_SUBTYPE) {
+      selectType("Anorganik", "Umum");
+    }
+  }
+  // Tombol 2: Menu Subtype / Botol
+  else if (buttons_.isPressed(1)) {
+    if (state_.appState == AppState::IDLE) {
+      state_.appState = AppState::SELECTING_SUBTYPE;
+      display_.showSubtypeSelection();
+    } else if (state_.appState == AppState::SELECTING_SUBTYPE) {
+      selectType("Anorganik", "Botol");
+    }
+  }
+  // Tombol 3: Residu / Kertas
+  else if (buttons_.isPressed(2)) {
+    if (state_.appState == AppState::IDLE) {
+      selectType("Residu");
+    } else if (state_.appState == AppState::SELECTING_SUBTYPE) {
+      selectType("Anorganik", "Kertas");
+    }
+  }
+}
+
+void ScaleApp::handleSendData(uint32_t now) {
+  // Tombol 4: Kirim Data
+  if (state_.appState != AppState::IDLE || !buttons_.isPressed(3)) return;
+
+  buzzer_.tone(2000, 100);
+
+  if (strcmp(state_.waste.jenis, "--") == 0) {
+    showStatus("Error: Pilih Jenis!", now);
+    return;
+  }
+
+  // Jangan kirim selama kantong masih berayun
+  if (!state_.isStable) {
+    showStatus("Tunggu: Blm Stabil", now);
+    return;
+  }
+
+  // Kunci nilai stabil saat tombol ditekan, bukan berat sesaat
+  WeighingRecord record;
+  record.weightMg = state_.stableWeightMg;
+  copyText(record.fakultas, state_.fakultas);
+  copyText(record.jenis, state_.waste.getDisplayName());
+
+  // Tulis ke jurnal flash dulu, online atau tidak: forwardJournal() yang
+  // mengirim berurutan, jadi operator langsung bisa menimbang kantong berikutnya
+  uint32_t seq = journal_.append(record);
+  if (seq == 0) {
+    showStatus("Gagal: Jurnal Penuh", now);
+    return;
+  }
+  record.bootId = journal_.bootId();
+  record.seq = seq;
+  // Feed MQTT sekali per penimbangan (bukan per kirim ulang jurnal). Antrean
+  // penuh: record ini dan sesudahnya diulang dari jurnal, urutan tetap
+  if (mqttReplaySeq_ == 0 && !uplink_.publish(seq, record)) {
+    mqttReplaySeq_ = seq;
+    mqttReplayBoot_ = journal_.bootId();
+    timers_.lastMqttReplay = now;
+    logPrintf("MQTT: antrean penuh, record #%lu diulang dari jurnal\n", (unsigned long)seq);
+  }
+  char msg[32];   // teks lengkap, layar memotong ke 20 kolom
+  snprintf(msg, sizeof(msg), "Simpan #%lu (%lu)", (unsigned long)seq, (unsigned long)journal_.unacked());
+  showStatus(msg, now);
+  state_.waste.reset(); // Record sudah dikunci, jenis untuk kantong berikutnya
+}
+
+void ScaleApp::showStatus(const char* msg, uint32_t now) {
+  // Hanya baris atas: berat di baris 1-3 tetap diperbarui selama pesan tampil
+  display_.showStatusMessage(msg);
+  timers_.statusMsgTimestamp = now;
+  statusOverlay_ = true;
+}
+
+void ScaleApp::processSendResults(uint32_t now) {
+  SendResult result;
+  // Teks lengkap (seq bisa 10 digit); layar memotong ke 20 kolom
+  char msg[40] = "";
+  while (uplink_.pollResult(result)) {
+    // Sisa jendela yang sudah dibatalkan (gagal sebelumnya) diabaikan
+    if (inFlight_ == 0 || result.id != nextResultId_) continue;
+    const uint32_t seq = inFlightSeqs_[result.id % Config::SEND_QUEUE_SIZE];
+    if (result.ok) {
+      journal_.ack();
+      inFlight_--;
+      nextResultId_++;
+    } else {
+      // Ack jurnal harus berurutan: kirim ulang dari record ini setelah jeda
+      inFlight_ = 0;
+    }
+
+    char weight[12];
+    FixedWeight::formatKg(weight, sizeof(weight), result.record.weightMg);
+    logPrintf("Upload #%lu %s: %s kg %s (%lums), sisa %lu\n", (unsigned long)seq,
+              result.ok ? "sukses" : "GAGAL", weight, result.record.jenis,
+              (unsigned long)result.elapsedMs, (unsigned long)journal_.unacked());
+
+    // Gagal beruntun (server down) cukup diberitahu sekali; record tetap di jurnal
+    const bool firstFailure = !result.ok && !sendFailed_;
+    sendFailed_ = !result.ok;
+    if (!result.ok) timers_.lastSendFailure = now;
+    if (firstFailure) buzzer_.tone(500, 300);
+    if (!result.ok && !firstFailure) continue;
+    snprintf(msg, sizeof(msg), "%s #%lu %skg", result.ok ? "Terkirim" : "GAGAL",
+             (unsigned long)seq, weight);
+  }
+  // Satu batch bisa berisi banyak record: LCD cukup menampilkan yang terakhir
+  if (msg[0] != '\0' && state_.appState == AppState::IDLE) showStatus(msg, now);
+}
+
+void ScaleApp::forwardJournal(uint32_t now) {
+  if (state_.offlineMode) return;
+  if (sendFailed_ && now - timers_.lastSendFailure < Config::JOURNAL_RETRY_MS) return;
+  // Jendela baru menunggu sisa jendela yang dibatalkan selesai, agar record
+  // yang sama tidak antri dua kali
+  if (inFlight_ == 0 && uplink_.pending() > 0) return;
+
+  // Isi antrean Uplink dengan record berikutnya; worker menggabungnya jadi batch.
+  // Ack tetap berurutan karena hasil kembali sesuai urutan antri.
+  for (uint32_t n = 0; n < Config::JOURNAL_FORWARD_PER_TICK && inFlight_ < Config::SEND_QUEUE_SIZE; n++) {
+    WeighingRecord record;
+    uint32_t seq = 0;
+    if (!journal_.peek(inFlight_, record, seq)) return;
+    uint32_t id = uplink_.enqueue(record);
+    if (id == 0) return;
+    if (inFlight_ == 0) nextResultId_ = id;
+    inFlightSeqs_[id % Config::SEND_QUEUE_SIZE] = seq;
+    inFlight_++;
+  }
+}
+
+void ScaleApp::replayMqtt(uint32_t now) {
+  if (mqttReplaySeq_ == 0 || now - timers_.lastMqttReplay < Config::MQTT_REPLAY_INTERVAL) return;
+  timers_.lastMqttReplay = now;
+  // Jurnal dihapus (boot ID baru): record yang belum di-publish ikut dibuang
+  if (journal_.bootId() != mqttReplayBoot_) {
+    mqttReplaySeq_ = 0;
+    return;
+  }
+
+  uint32_t lost = 0;
+  for (; mqttReplaySeq_ < journal_.nextSeq(); mqttReplaySeq_++) {
+    WeighingRecord record;
+    // Sudah di-ack Laravel (keluar dari jurnal) sebelum antrean MQTT lega
+    if (!journal_.peekSeq(mqttReplaySeq_, record)) {
+      lost++;
+      continue;
+    }
+    if (!uplink_.publish(mqttReplaySeq_, record)) break;
+  }
+  if (mqttReplaySeq_ >= journal_.nextSeq()) mqttReplaySeq_ = 0;
+  if (lost == 0) return;
+
+  mqttLost_ += lost;
+  logPrintf("MQTT: %lu record tidak ter-publish (sudah keluar dari jurnal)\n", (unsigned long)lost);
+  char msg[32];
+  snprintf(msg, sizeof(msg), "MQTT: %lu hilang", (unsigned long)mqttLost_);
+  if (state_.appState == AppState::IDLE) showStatus(msg, now);
+}
+
+void ScaleApp::printJournal(const char*) {
+  logPrintf("Jurnal: %lu record belum terkirim (%lu sedang dikirim), %lu/%lu byte, seq berikut %lu, boot %lu\n",
+            (unsigned long)journal_.unacked(), (unsigned long)inFlight_, (unsigned long)journal_.bytes(),
+            (unsigned long)Config::JOURNAL_MAX_BYTES, (unsigned long)journal_.nextSeq(),
+            (unsigned long)journal_.bootId());
+  if (journal_.droppedTail() > 0 || journal_.corruptEntries() > 0) {
+    logPrintf("Jurnal saat boot: %lu entri rusak dilewati, %lu ekor tidak lengkap dipotong\n",
+              (unsigned long)journal_.corruptEntries(), (unsigned long)journal_.droppedTail());
+  }
+  if (mqttReplaySeq_ != 0 || mqttLost_ > 0) {
+    logPrintf("MQTT: antre ulang mulai #%lu, %lu record tidak ter-publish\n",
+              (unsigned long)mqttReplaySeq_, (unsigned long)mqttLost_);
+  }
+}
+
+void ScaleApp::drainSamples() {
+  RawSample sample;
+  while (source_.pop(sample)) {
+    if (tap_ != nullptr) tap_->onSample(sample);
+    pipeline_.process(sample);
+    if (state_.appState == AppState::CALIBRATING) {
+      // Tare dikunci saat kalibrasi dimulai: re-tare latar belakang / console
+      // di tengah kalibrasi tidak boleh menggeser net count antar fase
+      calibrator_.add(sample.raw - calTare_, pipeline_.isStable());
+    }
+    state_.filteredMg = pipeline_.filteredMg();
+    state_.newDataReady = true;
+  }
+  state_.isStable = pipeline_.isStable();
+  state_.stableWeightMg = pipeline_.stableWeightMg();
+}
+
+void ScaleApp::persistZeroOffset(uint32_t now) {
+  if (now - timers_.lastZeroPersist < Config::AZT_PERSIST_INTERVAL) return;
+  timers_.lastZeroPersist = now;
+  pipeline_.persistZeroOffset();
+}
+
+void ScaleApp::reportAcquisition(uint32_t now) {
+  if (now - timers_.lastAcqReport < Config::ACQ_REPORT_INTERVAL) return;
+
+  // Laporan berkala untuk membuktikan 80 SPS tanpa sampel hilang
+  AcquisitionStats s = source_.stats();
+  float sps = (s.produced - lastProduced_) * 1000.0f / (now - timers_.lastAcqReport);
+  logPrintf("ACQ: %.1f SPS, total=%lu dropped=%lu missed=%lu maxGap=%luus\n",
+            sps, (unsigned long)s.produced, (unsigned long)s.dropped,
+            (unsigned long)s.missed, (unsigned long)s.maxGapUs);
+  lastProduced_ = s.produced;
+  timers_.lastAcqReport = now;
+  pipeline_.printStats(false);
+}
+
+void ScaleApp::printStats(const char* args) {
+  AcquisitionStats s = source_.stats();
+  logPrintf("ACQ: total=%lu dropped=%lu missed=%lu maxGap=%luus\n",
+            (unsigned long)s.produced, (unsigned long)s.dropped,
+            (unsigned long)s.missed, (unsigned long)s.maxGapUs);
+  pipeline_.printStats(args != nullptr && strcmp(args, "reset") == 0);
+}
+
+void ScaleApp::tare(const char*) {
+  pipeline_.requestTare();
+  logPrintf("Re-tare saat timbangan kosong & stabil (tanpa batas drift)\n");
+}
+
+void ScaleApp::calibrate(const char* args) {
+  CalibrationTable& table = pipeline_.calibration();
+  long grams = 0;
+
+  if (strcmp(args, "auto") == 0) {
+    // Seperti chord tombol 1+3: hanya dari layar utama, bukan di tengah
+    // menu maintenance, pilih sub-jenis, pesan status atau kalibrasi lain
+    if (state_.appState != AppState::IDLE) {
+      logPrintf("Gagal: kalibrasi hanya dari layar utama\n");
+      return;
+    }
+    startCalibration(lastTick_);
+    return;
+  } else if (sscanf(args, "add %ld", &grams) == 1) {
+    // Titik acuan diambil dari rata-rata window stabil; offset auto-zero
+    // dikembalikan ke count supaya titik relatif ke nol yang sebenarnya
+    if (!pipeline_.isStable()) {
+      logPrintf("Gagal: beban belum stabil\n");
+      return;
+    }
+    CalibrationTable::Point p;
+    p.net = pipeline_.averageNet() - table.toNet(pipeline_.zeroTracker().offset());
+    p.mg = static_cast<int32_t>(grams * 1000);
+    logPrintf(table.insertPoint(p) ? "OK (belum disimpan, ketik 'cal save')\n"
+                                   : "Gagal: tabel penuh / titik tidak naik monoton\n");
+  } else if (strcmp(args, "save") == 0) {
+    logPrintf(saveCalibration(table) ? "Kalibrasi tersimpan\n" : "Gagal menyimpan\n");
+    return;
+  } else if (strcmp(args, "reset") == 0) {
+    // Kembali ke faktor profil aktif (preset lokasi / hasil kalibrasi tersimpan)
+    table.setSingleFactor(profile_.mgPerCountQ16);
+    clearCalibration();
+  } else if (args[0] != '\0') {
+    logPrintf("Format: cal | cal add <gram> | cal auto | cal save | cal reset\n");
+    return;
+  }
+
+  logPrintf("Kalibrasi %s%s, %u titik:\n", table.isCustom() ? "multi-titik" : "faktor tunggal profil ",
+            table.isCustom() ? "" : profile_.fakultas, (unsigned)table.pointCount());
+  for (size_t i = 0; i < table.pointCount(); i++) {
+    logPrintf("  %ld count = %ld mg\n", (long)table.point(i).net, (long)table.point(i).mg);
+  }
+}
+
+// ==================== PROFIL & MENU MAINTENANCE ====================
+
+void ScaleApp::switchProfile(const DeviceProfile& profile) {
+  // Tabel multi-titik milik faktor lama tidak berlaku lagi untuk faktor baru
+  profile_ = profile;
+  saveDeviceProfile(profile_);
+  copyText(state_.fakultas, profile_.fakultas);
+  pipeline_.calibration().setSingleFactor(profile_.mgPerCountQ16);
+  clearCalibration();
+  logPrintf("Profil diganti: %s\n", profile_.fakultas);
+}
+
+void ScaleApp::showMaintenanceMenu() {
+  DeviceProfile candidate;
+  profileFromPreset(menuIndex_, candidate);
+  char item[21];
+  char active[21];
+  snprintf(item, sizeof(item), "> %-6s %9.4f", candidate.fakultas, profilePresetFactor(menuIndex_));
+  snprintf(active, sizeof(active), "Aktif: %s", profile_.fakultas);
+  display_.showLines("MAINTENANCE: PROFIL", item, active, "1:< 2:> 3:OK 4:Batal");
+}
+
+void ScaleApp::processMaintenance() {
+  const size_t count = profilePresetCount();
+
+  if (buttons_.isPressed(0)) {
+    menuIndex_ = (menuIndex_ + count - 1) % count;
+    showMaintenanceMenu();
+  } else if (buttons_.isPressed(1)) {
+    menuIndex_ = (menuIndex_ + 1) % count;
+    showMaintenanceMenu();
+  } else if (buttons_.isPressed(2)) {
+    DeviceProfile profile;
+    profileFromPreset(menuIndex_, profile);
+    switchProfile(profile);
+    buzzer_.tone(2500, 100);
+    state_.appState = AppState::IDLE;
+    showMainScreen();
+  } else if (buttons_.isPressed(3)) {
+    state_.appState = AppState::IDLE;
+    showMainScreen();
+  }
+}
+
+void ScaleApp::configureProfile(const char* args) {
+  char name[16];
+  double factor = 0.0;
+  DeviceProfile profile;
+
+  if (sscanf(args, "use %15s", name) == 1) {
+    int index = findProfilePreset(name);
+    if (index < 0 || !profileFromPreset(index, profile)) {
+      logPrintf("Preset tidak dikenal\n");
+      return;
+    }
+    switchProfile(profile);
+  } else if (sscanf(args, "set %7s %lf", name, &factor) == 2) {
+    if (!makeCustomProfile(name, factor, profile)) {
+      logPrintf("Faktor di luar batas (count per gram)\n");
+      return;
+    }
+    switchProfile(profile);
+  } else if (args[0] != '\0') {
+    logPrintf("Format: profile | profile use <fakultas> | profile set <nama> <count/gram>\n");
+    return;
+  }
+
+  logPrintf("Profil aktif: %s (%s), %ld mg/count Q16\n", profile_.fakultas,
+            profile_.preset == DeviceProfile::CUSTOM ? "kustom" : "preset", (long)profile_.mgPerCountQ16);
+  for (size_t i = 0; i < profilePresetCount(); i++) {
+    profileFromPreset(i, profile);
+    logPrintf("  %-6s %.7f\n", profile.fakultas, profilePresetFactor(i));
+  }
+}
+
+// ==================== KALIBRASI SEKUENSIAL ====================
+
+void ScaleApp::checkCalibrationChord(uint32_t now) {
+  // Tombol 1 + 3 ditahan bersama. Edge masing-masing tombol sempat memilih
+  // jenis sampah, jadi pilihan itu dibatalkan saat mode kalibrasi dimulai.
+  if (!buttons_.isDown(0) || !buttons_.isDown(2)) {
+    chordHeld_ = false;
+    return;
+  }
+  if (!chordHeld_) {
+    chordHeld_ = true;
+    chordSince_ = now;
+  } else if (now - chordSince_ >= Config::CAL_CHORD_HOLD_MS) {
+    chordHeld_ = false;
+    startCalibration(now);
+  }
+}
+
+void ScaleApp::startCalibration(uint32_t now) {
+  const CalibrationParams& params = params_.calibration;
+  double expected = static_cast<double>(pipeline_.calibration().toNet(params.referenceGrams * 1000)) /
+                    params.referenceGrams;
+  calibrator_.start(params, expected, Config::CAL_MIN_SAMPLES, Config::CAL_MAX_SAMPLES);
+  calTare_ = pipeline_.tareOffset();
+  state_.waste.reset();
+  state_.appState = AppState::CALIBRATING;
+  calStartMs_ = now;
+  lastCalDisplay_ = now - Config::LCD_UPDATE_INTERVAL;
+  calReported_ = false;
+  buzzer_.tone(2500, 100);
+  logPrintf("CAL: mulai, acuan %ld g, toleransi %ld ppm\n",
+            (long)params.referenceGrams, (long)params.tolerancePpm);
+}
+
+void ScaleApp::processCalibration(uint32_t now) {
+  const SequentialCalibrator::Phase phase = calibrator_.phase();
+  const bool finished = phase == SequentialCalibrator::Phase::DONE ||
+                        phase == SequentialCalibrator::Phase::FAILED;
+
+  if (finished && !calReported_) {
+    calReported_ = true;
+    buzzer_.tone(phase == SequentialCalibrator::Phase::DONE ? 2500 : 500, 300);
+    logPrintf("CAL: %s faktor=%.6f count/g u95=%.4f%% sampel=%lu waktu=%lums\n",
+              phase == SequentialCalibrator::Phase::DONE ? "selesai" : "gagal",
+              calibrator_.countsPerGram(), calibrator_.relativeUncertainty() * 100.0,
+              (unsigned long)calibrator_.samplesUsed(), (unsigned long)(now - calStartMs_));
+    lastCalDisplay_ = now - Config::LCD_UPDATE_INTERVAL;
+  }
+
+  if (buttons_.isPressed(3)) {
+    state_.appState = AppState::IDLE;
+    restoreMainScreen();
+    return;
+  }
+  if (phase == SequentialCalibrator::Phase::DONE && buttons_.isPressed(2)) {
+    DeviceProfile profile;
+    if (makeCustomProfile(profile_.fakultas, calibrator_.countsPerGram(), profile)) {
+      switchProfile(profile);
+      display_.showStatusMessage("Kalibrasi Tersimpan");
+    } else {
+      display_.showStatusMessage("Faktor Tdk Wajar!");
+    }
+    timers_.statusMsgTimestamp = now;
+    state_.appState = AppState::SHOWING_STATUS;
+    return;
+  }
+
+  if (now - lastCalDisplay_ < Config::LCD_UPDATE_INTERVAL) return;
+  lastCalDisplay_ = now;
+
+  char r1[21], r2[21];
+  switch (phase) {
+    case SequentialCalibrator::Phase::ZERO:
+      snprintf(r2, sizeof(r2), "n=%lu", (unsigned long)calibrator_.phaseSamples());
+      display_.showLines("KALIBRASI 1/2", "Kosongkan timbangan", r2, "4:Batal");
+      break;
+    case SequentialCalibrator::Phase::LOAD:
+      snprintf(r1, sizeof(r1), "Beban acuan %lu g",
+               lcdCap(static_cast<uint32_t>(params_.calibration.referenceGrams), 999999));
+      snprintf(r2, sizeof(r2), "n=%lu u=%.3f%%", lcdCap(calibrator_.phaseSamples(), 99999),
+               calibrator_.relativeUncertainty() * 100.0);
+      display_.showLines("KALIBRASI 2/2", r1, r2, "4:Batal");
+      break;
+    case SequentialCalibrator::Phase::DONE:
+      snprintf(r1, sizeof(r1), "f=%.5f cnt/g", calibrator_.countsPerGram());
+      snprintf(r2, sizeof(r2), "u=%.3f%% n=%lu", calibrator_.relativeUncertainty() * 100.0,
+               lcdCap(calibrator_.samplesUsed(), 99999));
+      display_.showLines("KALIBRASI SELESAI", r1, r2, "3:Simpan 4:Batal");
+      break;
+    case SequentialCalibrator::Phase::FAILED:
+      snprintf(r2, sizeof(r2), "u=%.3f%% n=%lu", calibrator_.relativeUncertainty() * 100.0,
+               lcdCap(calibrator_.samplesUsed(), 99999));
+      display_.showLines("KALIBRASI GAGAL", "Beban tidak stabil", r2, "4:Keluar");
+      break;
+  }
+}
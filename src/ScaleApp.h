@@ -0,0 +1,123 @@
+#ifndef SCALE_APP_H
+#define SCALE_APP_H
+
+#include "Config.h"
+#include "Types.h"
+#include "Hal.h"
+#include "WeighingPipeline.h"
+#include "DeviceProfile.h"
+#include "RecordJournal.h"
+
+// ==================== APLIKASI TIMBANGAN ====================
+// State machine (pilih jenis -> tunggu stabil -> simpan ke jurnal -> kirim)
+// dan jalur berat, hanya lewat antarmuka Hal. main.cpp merangkai implementasi ESP32,
+// sim/main_native.cpp merangkai implementasi simulasi.
+
+class ScaleApp {
+public:
+  ScaleApp(Hal::Display& display, Hal::Buttons& buttons, Hal::Buzzer& buzzer,
+           Hal::SampleSource& source, Hal::Uplink& uplink, Hal::FileStore& files,
+           RuntimeSettings& params);
+
+  // Muat profil, kalibrasi, titik nol & jurnal tersimpan, mulai timer.
+  // Tombol 4 yang ditahan saat ini membuka menu maintenance.
+  void begin(uint32_t now);
+
+  // Tampilkan layar utama (setelah pesan startup), atau menu maintenance
+  void showMainScreen();
+
+  // Satu iterasi loop utama. 'now' dalam ms (millis() di perangkat,
+  // waktu virtual di simulasi) agar bisa dijalankan secepat mungkin di host.
+  void tick(uint32_t now);
+
+  // Perintah console 'stats' (args "reset" mengosongkan statistik noise)
+  void printStats(const char* args);
+
+  // Perintah console 'cal': tampilkan | add <gram> | auto | save | reset
+  void calibrate(const char* args);
+
+  // Perintah console 'tare': re-tare paksa saat kosong & stabil berikutnya
+  void tare(const char* args);
+
+  // Perintah console 'profile': tampilkan | use <fakultas> | set <nama> <count/gram>
+  void configureProfile(const char* args);
+
+  // Perintah console 'journal': record belum terkirim & ukuran jurnal
+  void printJournal(const char* args);
+
+  // Pasang/lepas penyadap sampel mentah (nullptr = capture mati)
+  void setSampleTap(Hal::SampleTap* tap) { tap_ = tap; }
+
+  SystemState& state() { return state_; }
+  WeighingPipeline& pipeline() { return pipeline_; }
+  RecordJournal& journal() { return journal_; }
+
+private:
+  // Timer lokal loop utama
+  struct Timers {
+    uint32_t lastWeightRead = 0;
+    uint32_t lastLCDUpdate = 0;
+    uint32_t lastStatusDisplay = 0;
+    uint32_t statusMsgTimestamp = 0;
+    uint32_t lastAcqReport = 0;
+    uint32_t lastZeroPersist = 0;
+    uint32_t lastSendFailure = 0;
+    uint32_t lastMqttReplay = 0;
+  };
+
+  void processButtons();
+  void handleSendData(uint32_t now);
+  void showStatus(const char* msg, uint32_t now);
+  void restoreMainScreen();
+  void processSendResults(uint32_t now);
+  void forwardJournal(uint32_t now);
+  void replayMqtt(uint32_t now);
+  void drainSamples();
+  void reportAcquisition(uint32_t now);
+  void persistZeroOffset(uint32_t now);
+  void selectType(const char* type, const char* subtype = "--");
+  void switchProfile(const DeviceProfile& profile);
+  void showMaintenanceMenu();
+  void processMaintenance();
+  void checkCalibrationChord(uint32_t now);
+  void startCalibration(uint32_t now);
+  void processCalibration(uint32_t now);
+
+  Hal::Display& display_;
+  Hal::Buttons& buttons_;
+  Hal::Buzzer& buzzer_;
+  Hal::SampleSource& source_;
+  Hal::Uplink& uplink_;
+  Hal::SampleTap* tap_ = nullptr;
+  RuntimeSettings& params_;
+  WeighingPipeline pipeline_;
+  RecordJournal journal_;
+  // Jendela kirim: inFlight_ record terdepan jurnal sudah antri di Uplink dengan
+  // id berurutan mulai nextResultId_; seq-nya di inFlightSeqs_[id % SEND_QUEUE_SIZE]
+  uint32_t inFlight_ = 0;
+  uint32_t nextResultId_ = 0;
+  // Feed MQTT: record mulai seq ini ditolak antrean MQTT yang penuh dan
+  // diulang dari jurnal oleh replayMqtt() (0 = semua sudah antri). Record yang
+  // keburu di-ack Laravel sebelum sempat diulang dihitung di mqttLost_.
+  uint32_t mqttReplaySeq_ = 0;
+  uint32_t mqttReplayBoot_ = 0;
+  uint32_t mqttLost_ = 0;
+  uint32_t inFlightSeqs_[Config::SEND_QUEUE_SIZE] = {};
+  bool sendFailed_ = false;     // upload terakhir gagal, tunggu JOURNAL_RETRY_MS
+  SystemState state_;
+  Timers timers_;
+  uint32_t lastProduced_ = 0;
+  uint32_t lastTick_ = 0;
+  bool statusOverlay_ = false;
+  DeviceProfile profile_;
+  size_t menuIndex_ = 0;
+  SequentialCalibrator calibrator_;
+  uint32_t chordSince_ = 0;
+  bool chordHeld_ = false;
+  uint32_t calStartMs_ = 0;
+  int32_t calTare_ = 0;
+  uint32_t lastCalDisplay_ = 0;
+  bool calReported_ = false;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SEQUENTIAL_CALIBRATOR_H
+#define SEQUENTIAL_CALIBRATOR_H
+
+#include <math.h>
+#include <stdint.h>
+#include "StreamingStats.h"
+
+// ==================== KALIBRASI SEKUENSIAL ====================
+// Pengganti kalibrasi-baru.cpp (500 + 500 sampel tetap, ~90 detik, flash
+// terpisah). Dua fase, masing-masing rata-rata berjalan (Welford) atas net
+// count selama timbangan stabil:
+//   ZERO : timbangan kosong
+//   LOAD : beban acuan terpasang (terdeteksi dari pergeseran > 1/2 span
+//          yang diharapkan)
+// Berhenti begitu interval kepercayaan 95% faktor (count per gram) lebih
+// sempit dari toleransi relatif, bukan setelah jumlah sampel tetap.
+// Gerakan (detektor stabilitas) mengulang fase yang sedang berjalan.
+
+struct CalibrationParams {
+  int32_t referenceGrams;   // berat beban acuan
+  int32_t tolerancePpm;     // target setengah-lebar CI 95% faktor, relatif (ppm)
+};
+
+class SequentialCalibrator {
+public:
+  enum class Phase : uint8_t { ZERO, LOAD, DONE, FAILED };
+
+  static constexpr double Z95 = 1.96;
+
+  // expectedCountsPerGram dipakai untuk mendeteksi beban acuan terpasang
+  // dan menetapkan target fase ZERO sebelum span sebenarnya diketahui
+  void start(const CalibrationParams& params, double expectedCountsPerGram,
+             uint32_t minSamples, uint32_t maxSamples) {
+    params_ = params;
+    expectedSpan_ = expectedCountsPerGram * params.referenceGrams;
+    minSamples_ = minSamples;
+    maxSamples_ = maxSamples;
+    zero_.reset();
+    load_.reset();
+    used_ = 0;
+    phase_ = Phase::ZERO;
+  }
+
+  void add(int32_t net, bool stable) {
+    if (phase_ == Phase::DONE || phase_ == Phase::FAILED) return;
+    RunningStats& current = (phase_ == Phase::ZERO) ? zero_ : load_;
+
+    if (!stable) {
+      // Beban bergerak: sampel fase ini tidak lagi mewakili satu titik
+      current.reset();
+      return;
+    }
+    if (phase_ == Phase::LOAD && fabs(net - zero_.mean()) < expectedSpan_ / 2) return;
+
+    current.add(net);
+    used_++;
+
+    if (phase_ == Phase::ZERO) {
+      // Target nol: separuh anggaran ketidakpastian terhadap span yang diharapkan
+      if (current.count() >= minSamples_ && halfWidth(zero_) <= tolerance() * expectedSpan_ / sqrt(2.0)) {
+        phase_ = Phase::LOAD;
+      }
+    } else if (current.count() >= minSamples_ && relativeUncertainty() <= tolerance()) {
+      phase_ = Phase::DONE;
+    }
+    if (phase_ != Phase::DONE && current.count() >= maxSamples_) phase_ = Phase::FAILED;
+  }
+
+  Phase phase() const { return phase_; }
+  uint32_t samplesUsed() const { return used_; }
+  uint32_t phaseSamples() const { return phase_ == Phase::ZERO ? zero_.count() : load_.count(); }
+
+  double span() const { return load_.mean() - zero_.mean(); }
+  double countsPerGram() const { return span() / params_.referenceGrams; }
+
+  // Setengah-lebar CI 95% faktor relatif terhadap faktornya
+  double relativeUncertainty() const {
+    double s = span();
+    if (load_.count() < 2 || s <= 0) return 1.0;
+    return sqrt(halfWidth(zero_) * halfWidth(zero_) + halfWidth(load_) * halfWidth(load_)) / s;
+  }
+
+private:
+  static double halfWidth(const RunningStats& stats) {
+    return stats.count() < 2 ? 1e9 : Z95 * stats.stddev() / sqrt(static_cast<double>(stats.count()));
+  }
+  double tolerance() const { return params_.tolerancePpm * 1e-6; }
+
+  CalibrationParams params_ = { 0, 0 };
+  double expectedSpan_ = 0;
+  uint32_t minSamples_ = 0;
+  uint32_t maxSamples_ = 0;
+  RunningStats zero_;
+  RunningStats load_;
+  uint32_t used_ = 0;
+  Phase phase_ = Phase::DONE;
+};
+
+#endif
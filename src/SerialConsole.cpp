@@ -0,0 +1,83 @@
+#include "SerialConsole.h"
+#include "Settings.h"
+
+// ==================== STATE PRIVATE ====================
+struct ConsoleCommand {
+  const char* name;
+  ConsoleHandler handler;
+  const char* help;
+};
+
+static constexpr size_t MAX_COMMANDS = 16;
+static ConsoleCommand commands[MAX_COMMANDS];
+static size_t commandCount = 0;
+
+static char lineBuffer[96];
+static size_t lineLength = 0;
+
+// ==================== PERINTAH BAWAAN ====================
+
+static void cmdHelp(const char*) {
+  Serial.println("help | get | set <key> <nilai> | save");
+  for (size_t i = 0; i < commandCount; i++) {
+    Serial.printf("%s - %s\n", commands[i].name, commands[i].help);
+  }
+}
+
+static void cmdSet(const char* args) {
+  char key[16];
+  long value;
+  if (sscanf(args, "%15s %ld", key, &value) != 2) {
+    Serial.println("Format: set <key> <nilai>");
+    return;
+  }
+  Serial.println(setSetting(key, value) ? "OK (belum disimpan, ketik 'save')"
+                                        : "Key tidak dikenal / di luar batas");
+}
+
+static void executeLine(char* line) {
+  // Pisahkan nama perintah dan argumen
+  char* args = line;
+  while (*args && *args != ' ') args++;
+  if (*args) *args++ = '\0';
+  while (*args == ' ') args++;
+
+  if (strcmp(line, "help") == 0) { cmdHelp(args); return; }
+  if (strcmp(line, "get") == 0) { printSettings(); return; }
+  if (strcmp(line, "set") == 0) { cmdSet(args); return; }
+  if (strcmp(line, "save") == 0) {
+    Serial.println(saveSettings() ? "Tersimpan di NVS" : "Gagal menyimpan");
+    return;
+  }
+
+  for (size_t i = 0; i < commandCount; i++) {
+    if (strcmp(line, commands[i].name) == 0) {
+      commands[i].handler(args);
+      return;
+    }
+  }
+  Serial.println("Perintah tidak dikenal, ketik 'help'");
+}
+
+// ==================== IMPLEMENTASI FUNGSI ====================
+
+bool registerConsoleCommand(const char* name, ConsoleHandler handler, const char* help) {
+  if (commandCount >= MAX_COMMANDS) return false;
+  commands[commandCount++] = { name, handler, help };
+  return true;
+}
+
+void pollSerialConsole() {
+  while (Serial.available() > 0) {
+    char c = static_cast<char>(Serial.read());
+    if (c == '\r') continue;
+
+    if (c == '\n') {
+      lineBuffer[lineLength] = '\0';
+      if (lineLength > 0) executeLine(lineBuffer);
+      lineLength = 0;
+    } else if (lineLength < sizeof(lineBuffer) - 1) {
+      lineBuffer[lineLength++] = c;
+    }
+  }
+}
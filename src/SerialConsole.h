@@ -0,0 +1,20 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+
+// ==================== CONSOLE SERIAL ====================
+// Perintah baris sederhana lewat Serial (115200, akhiri dengan newline).
+// Bawaan: help, get, set <key> <nilai>, save.
+// Modul lain bisa menambah perintah lewat registerConsoleCommand().
+
+// 'args' berisi sisa baris setelah nama perintah (bisa string kosong)
+typedef void (*ConsoleHandler)(const char* args);
+
+// Daftarkan perintah tambahan. Return false jika tabel penuh.
+bool registerConsoleCommand(const char* name, ConsoleHandler handler, const char* help);
+
+// Baca karakter yang tersedia tanpa blocking, eksekusi jika sudah satu baris
+void pollSerialConsole();
+
+#endif
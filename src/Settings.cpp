@@ -0,0 +1,90 @@
+#include "Settings.h"
+#include <string.h>
+
+RuntimeSettings settings;
+
+// ==================== TABEL KEY ====================
+// Key dipakai sama untuk NVS dan console (maks 15 karakter, batas NVS)
+struct SettingDef {
+  const char* key;
+  int32_t* value;
+  int32_t minValue;
+  int32_t maxValue;
+};
+
+static const SettingDef SETTING_TABLE[] = {
+  { "ad_step",   &settings.adaptive.stepThreshold, 1000, 1000000 },
+  { "ad_min",    &settings.adaptive.minShift,      0,    8 },
+  { "ad_max",    &settings.adaptive.maxShift,      0,    8 },
+  { "ad_settle", &settings.adaptive.settleSamples, 1,    400 },
+  { "st_range",  &settings.stability.rangeLimit,   1000, 500000 },
+  { "st_std",    &settings.stability.stdLimit,     500,  200000 },
+  { "az_band",   &settings.zeroTrack.zeroBand,      0,    50000 },
+  { "az_step",   &settings.zeroTrack.maxStep,       0,    1000 },
+  { "az_max",    &settings.zeroTrack.maxCorrection, 0,    2000000 },
+  { "cb_ref_g",  &settings.calibration.referenceGrams, 100, 100000 },
+  { "cb_tol",    &settings.calibration.tolerancePpm,   50,  20000 },
+};
+
+static Hal::Storage* storage = nullptr;
+
+// ==================== IMPLEMENTASI FUNGSI ====================
+
+void initSettings(Hal::Storage& target) {
+  storage = &target;
+  for (const SettingDef& def : SETTING_TABLE) {
+    int32_t v = storage->getInt(def.key, *def.value);
+    if (v >= def.minValue && v <= def.maxValue) *def.value = v;
+  }
+}
+
+bool saveSettings() {
+  if (storage == nullptr) return false;
+  bool ok = true;
+  for (const SettingDef& def : SETTING_TABLE) {
+    ok = storage->putInt(def.key, *def.value) && ok;
+  }
+  return ok;
+}
+
+bool setSetting(const char* key, int32_t value) {
+  for (const SettingDef& def : SETTING_TABLE) {
+    if (strcmp(def.key, key) != 0) continue;
+    if (value < def.minValue || value > def.maxValue) return false;
+    *def.value = value;
+    return true;
+  }
+  return false;
+}
+
+void printSettings() {
+  for (const SettingDef& def : SETTING_TABLE) {
+    logPrintf("%s=%ld (%ld..%ld)\n", def.key, (long)*def.value,
+              (long)def.minValue, (long)def.maxValue);
+  }
+}
+
+int32_t loadPersistedInt(const char* key, int32_t defaultValue) {
+  if (storage == nullptr) return defaultValue;
+  return storage->getInt(key, defaultValue);
+}
+
+bool savePersistedInt(const char* key, int32_t value) {
+  if (storage == nullptr) return false;
+  return storage->putInt(key, value);
+}
+
+bool loadPersistedBlob(const char* key, void* out, size_t len) {
+  if (storage == nullptr) return false;
+  return storage->getBlob(key, out, len);
+}
+
+bool savePersistedBlob(const char* key, const void* data, size_t len) {
+  if (storage == nullptr) return false;
+  return storage->putBlob(key, data, len);
+}
+
+bool erasePersisted(const char* key) {
+  if (storage == nullptr) return false;
+  return storage->remove(key);
+}
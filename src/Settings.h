@@ -0,0 +1,64 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include "Config.h"
+#include "Hal.h"
+#include "WeightFilters.h"
+#include "StabilityDetector.h"
+#include "ZeroTracker.h"
+#include "SequentialCalibrator.h"
+
+// ==================== PENGATURAN RUNTIME ====================
+// Parameter yang bisa diubah tanpa flash ulang (lewat console serial),
+// disimpan di Hal::Storage (NVS di perangkat). Nilai default diambil dari Config.
+
+struct RuntimeSettings {
+  Filter::AdaptiveParams adaptive = {
+    Config::ADAPT_STEP_THRESHOLD_MG,
+    Config::ADAPT_MIN_SHIFT,
+    Config::ADAPT_MAX_SHIFT,
+    Config::ADAPT_SETTLE_SAMPLES
+  };
+  StabilityParams stability = {
+    Config::STABLE_RANGE_MG,
+    Config::STABLE_STD_MG
+  };
+  ZeroTrackParams zeroTrack = {
+    Config::AZT_ZERO_BAND_MG,
+    Config::AZT_MAX_STEP_MG,
+    Config::AZT_MAX_CORRECTION_MG
+  };
+  CalibrationParams calibration = {
+    Config::CAL_REFERENCE_G,
+    Config::CAL_TOLERANCE_PPM
+  };
+};
+
+// Satu-satunya instance; modul lain membaca langsung dari sini
+extern RuntimeSettings settings;
+
+// ==================== FUNGSI PENGATURAN ====================
+
+// Pasang storage (dipakai semua fungsi di bawah) lalu muat nilai
+// tersimpan (key yang belum ada tetap bernilai default)
+void initSettings(Hal::Storage& storage);
+
+// Simpan semua nilai. Return false jika storage gagal ditulis.
+bool saveSettings();
+
+// Ubah satu nilai berdasarkan key. Return false jika key tidak dikenal
+// atau nilai di luar batas yang diizinkan.
+bool setSetting(const char* key, int32_t value);
+
+// Cetak semua key=value lewat logPrintf
+void printSettings();
+
+// Nilai state (bukan pengaturan) yang harus bertahan setelah reboot,
+// mis. offset auto-zero. Disimpan di storage yang sama.
+int32_t loadPersistedInt(const char* key, int32_t defaultValue);
+bool savePersistedInt(const char* key, int32_t value);
+bool loadPersistedBlob(const char* key, void* out, size_t len);
+bool savePersistedBlob(const char* key, const void* data, size_t len);
+bool erasePersisted(const char* key);
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef STABILITY_DETECTOR_H
+#define STABILITY_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ==================== DETEKSI GERAK / STABILITAS ====================
+// Sliding window N sampel dengan biaya O(1) per sampel:
+//  - min/max lewat monotonic deque (setiap sampel masuk & keluar deque sekali)
+//  - mean/varians lewat running sum dan sum kuadrat
+// Dianggap stabil jika window penuh, rentang (max-min) <= rangeLimit dan
+// simpangan baku <= stdLimit. Nilai stabil dikunci saat pertama kali stabil
+// dan dipertahankan sampai gerak terdeteksi lagi.
+
+struct StabilityParams {
+  int32_t rangeLimit;   // maks (max - min) dalam window (satuan sampel, mg)
+  int32_t stdLimit;     // maks simpangan baku dalam window
+};
+
+template <size_t N>
+class StabilityDetector {
+  static_assert(N >= 4, "Window stabilitas terlalu kecil");
+
+public:
+  // Sampel disimpan relatif terhadap 'base' agar sum kuadrat tidak overflow
+  // int64. Lompatan > REBASE_LIMIT dari base pasti tidak stabil, jadi
+  // window cukup dimulai ulang dengan base baru.
+  static constexpr int32_t REBASE_LIMIT = 1 << 20;
+
+  // 'params' wajib (dibaca setiap update), tanpa konstruktor default
+  explicit StabilityDetector(const StabilityParams* params) : params_(params) {}
+
+  void push(int32_t x) {
+    int32_t rel = x - base_;
+    if (count_ == 0 || rel > REBASE_LIMIT || rel < -REBASE_LIMIT) {
+      reset(x);
+      rel = 0;
+    }
+
+    // Keluarkan sampel tertua dari window
+    if (count_ == N) {
+      int32_t old = window_[head_];
+      sum_ -= old;
+      sumSq_ -= static_cast<int64_t>(old) * old;
+    } else {
+      count_++;
+    }
+    window_[head_] = rel;
+    head_ = (head_ + 1) % N;
+    sum_ += rel;
+    sumSq_ += static_cast<int64_t>(rel) * rel;
+
+    // Monotonic deque: pertama buang elemen yang sudah keluar window,
+    // lalu buang dari belakang elemen yang tidak mungkin lagi jadi min/max
+    const uint32_t idx = index_++;
+    const uint32_t oldest = idx + 1 - static_cast<uint32_t>(count_);
+    while (minLen_ > 0 && static_cast<int32_t>(minQ_[minHead_].index - oldest) < 0) { minHead_ = (minHead_ + 1) % N; minLen_--; }
+    while (maxLen_ > 0 && static_cast<int32_t>(maxQ_[maxHead_].index - oldest) < 0) { maxHead_ = (maxHead_ + 1) % N; maxLen_--; }
+
+    while (minLen_ > 0 && minQ_[(minHead_ + minLen_ - 1) % N].value >= rel) minLen_--;
+    minQ_[(minHead_ + minLen_) % N] = { idx, rel };
+    minLen_++;
+    while (maxLen_ > 0 && maxQ_[(maxHead_ + maxLen_ - 1) % N].value <= rel) maxLen_--;
+    maxQ_[(maxHead_ + maxLen_) % N] = { idx, rel };
+    maxLen_++;
+
+    evaluate();
+  }
+
+  void reset(int32_t base = 0) {
+    base_ = base;
+    count_ = 0;
+    head_ = 0;
+    sum_ = 0;
+    sumSq_ = 0;
+    minHead_ = minLen_ = 0;
+    maxHead_ = maxLen_ = 0;
+    stable_ = false;
+  }
+
+  bool isStable() const { return stable_; }
+  int32_t stableValue() const { return lockedValue_; }
+  int32_t range() const { return count_ ? maxQ_[maxHead_].value - minQ_[minHead_].value : 0; }
+  int32_t mean() const { return base_ + static_cast<int32_t>(sum_ / static_cast<int64_t>(count_ ? count_ : 1)); }
+
+  // Varians populasi window (satuan^2)
+  int64_t variance() const {
+    if (count_ == 0) return 0;
+    const int64_t n = static_cast<int64_t>(count_);
+    return (n * sumSq_ - sum_ * sum_) / (n * n);
+  }
+
+private:
+  struct Entry {
+    uint32_t index;
+    int32_t value;
+  };
+
+  void evaluate() {
+    const int64_t stdLimit = params_->stdLimit;
+    bool nowStable = count_ == N &&
+                     range() <= params_->rangeLimit &&
+                     variance() <= stdLimit * stdLimit;
+    if (nowStable && !stable_) lockedValue_ = mean();
+    stable_ = nowStable;
+  }
+
+  const StabilityParams* params_;
+  int32_t window_[N];
+  Entry minQ_[N];
+  Entry maxQ_[N];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  size_t minHead_ = 0, minLen_ = 0;
+  size_t maxHead_ = 0, maxLen_ = 0;
+  uint32_t index_ = 0;
+  int32_t base_ = 0;
+  int64_t sum_ = 0;
+  int64_t sumSq_ = 0;
+  int32_t lockedValue_ = 0;
+  bool stable_ = false;
+};
+
+#endif
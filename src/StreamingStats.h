@@ -0,0 +1,158 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ==================== STATISTIK STREAMING (MEMORI KONSTAN) ====================
+// Pengganti array float weightReadings[500] di statistik.cpp dan
+// kompensasi-suhu.cpp. Semua statistik di-update satu kali per sampel,
+// memori tetap berapa pun jumlah sampel:
+//  - RunningStats : mean & varians (Welford), min, max, aproksimasi mean
+//                   absolute deviation (lihat approxMeanAbsDeviation())
+//  - P2Quantile   : estimasi kuantil tanpa menyimpan sampel (algoritma P^2,
+//                   Jain & Chlamtac 1985), 5 marker per kuantil
+//  - StreamingStats: gabungan keduanya untuk median / p95 / p99
+
+class RunningStats {
+public:
+  void add(double x) {
+    count_++;
+    double delta = x - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (x - mean_);
+
+    runningAbsDevSum_ += fabs(x - mean_);
+
+    if (count_ == 1 || x < min_) min_ = x;
+    if (count_ == 1 || x > max_) max_ = x;
+  }
+
+  void reset() { *this = RunningStats(); }
+
+  uint32_t count() const { return count_; }
+  double mean() const { return mean_; }
+  double variance() const { return count_ > 1 ? m2_ / (count_ - 1) : 0.0; }   // sampel (n-1)
+  double stddev() const { return sqrt(variance()); }
+  double minValue() const { return min_; }
+  double maxValue() const { return max_; }
+  // Bukan MAD eksak: tiap |x - mean| diukur terhadap mean berjalan saat x
+  // masuk, bukan mean akhir (MAD eksak butuh pass kedua atas semua sampel).
+  // Dekat dengan MAD eksak untuk noise stasioner setelah puluhan sampel;
+  // bias membesar jika mean bergeser selama pengukuran (drift, beban berubah).
+  double approxMeanAbsDeviation() const { return count_ ? runningAbsDevSum_ / count_ : 0.0; }
+
+private:
+  uint32_t count_ = 0;
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+  double runningAbsDevSum_ = 0.0;   // sum |x - mean berjalan|
+  double min_ = 0.0;
+  double max_ = 0.0;
+};
+
+class P2Quantile {
+public:
+  explicit P2Quantile(double p = 0.5) : p_(p) {}
+
+  void add(double x) {
+    if (count_ < 5) {
+      // Kumpulkan 5 sampel pertama secara terurut
+      int i = count_++;
+      while (i > 0 && q_[i - 1] > x) { q_[i] = q_[i - 1]; i--; }
+      q_[i] = x;
+      if (count_ == 5) {
+        for (int k = 0; k < 5; k++) n_[k] = k;
+        np_[0] = 0; np_[1] = 2 * p_; np_[2] = 4 * p_; np_[3] = 2 + 2 * p_; np_[4] = 4;
+        dn_[0] = 0; dn_[1] = p_ / 2; dn_[2] = p_; dn_[3] = (1 + p_) / 2; dn_[4] = 1;
+      }
+      return;
+    }
+    count_++;
+
+    // Cari sel tempat x jatuh, perbarui marker ekstrem
+    int k;
+    if (x < q_[0]) { q_[0] = x; k = 0; }
+    else if (x >= q_[4]) { q_[4] = x; k = 3; }
+    else { k = 0; while (k < 3 && x >= q_[k + 1]) k++; }
+
+    for (int i = k + 1; i < 5; i++) n_[i]++;
+    for (int i = 0; i < 5; i++) np_[i] += dn_[i];
+
+    // Geser marker tengah ke posisi idealnya
+    for (int i = 1; i <= 3; i++) {
+      double d = np_[i] - n_[i];
+      if ((d >= 1 && n_[i + 1] - n_[i] > 1) || (d <= -1 && n_[i - 1] - n_[i] < -1)) {
+        int s = d > 0 ? 1 : -1;
+        double qp = parabolic(i, s);
+        q_[i] = (q_[i - 1] < qp && qp < q_[i + 1]) ? qp : linear(i, s);
+        n_[i] += s;
+      }
+    }
+  }
+
+  void reset() { *this = P2Quantile(p_); }
+
+  double value() const {
+    if (count_ == 0) return 0.0;
+    if (count_ < 5) return q_[static_cast<int>(p_ * (count_ - 1) + 0.5)];
+    return q_[2];
+  }
+  uint32_t count() const { return count_; }
+
+private:
+  double parabolic(int i, int s) const {
+    double a = static_cast<double>(s) / (n_[i + 1] - n_[i - 1]);
+    double b = (n_[i] - n_[i - 1] + s) * (q_[i + 1] - q_[i]) / (n_[i + 1] - n_[i]);
+    double c = (n_[i + 1] - n_[i] - s) * (q_[i] - q_[i - 1]) / (n_[i] - n_[i - 1]);
+    return q_[i] + a * (b + c);
+  }
+  double linear(int i, int s) const {
+    return q_[i] + s * (q_[i + s] - q_[i]) / (n_[i + s] - n_[i]);
+  }
+
+  double p_;
+  uint32_t count_ = 0;
+  double q_[5] = {0, 0, 0, 0, 0};   // tinggi marker
+  int32_t n_[5] = {0, 0, 0, 0, 0};  // posisi aktual marker
+  double np_[5] = {0, 0, 0, 0, 0};  // posisi ideal marker
+  double dn_[5] = {0, 0, 0, 0, 0};  // increment posisi ideal
+};
+
+class StreamingStats {
+public:
+  StreamingStats() : median_(0.5), p95_(0.95), p99_(0.99) {}
+
+  void add(double x) {
+    basic_.add(x);
+    median_.add(x);
+    p95_.add(x);
+    p99_.add(x);
+  }
+
+  void reset() {
+    basic_.reset();
+    median_.reset();
+    p95_.reset();
+    p99_.reset();
+  }
+
+  uint32_t count() const { return basic_.count(); }
+  double mean() const { return basic_.mean(); }
+  double stddev() const { return basic_.stddev(); }
+  double variance() const { return basic_.variance(); }
+  double minValue() const { return basic_.minValue(); }
+  double maxValue() const { return basic_.maxValue(); }
+  double approxMeanAbsDeviation() const { return basic_.approxMeanAbsDeviation(); }
+  double median() const { return median_.value(); }
+  double p95() const { return p95_.value(); }
+  double p99() const { return p99_.value(); }
+
+private:
+  RunningStats basic_;
+  P2Quantile median_;
+  P2Quantile p95_;
+  P2Quantile p99_;
+};
+
+#endif
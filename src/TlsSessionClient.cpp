@@ -0,0 +1,231 @@
+#include "TlsSessionClient.h"
+#include <errno.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <mbedtls/net_sockets.h>
+#include <esp_attr.h>
+
+#include "Config.h"
+#include "Types.h"
+
+// ==================== CACHE DI RTC MEMORY ====================
+// Hanya jika Config::TLS_SESSION_RTC. Sesi ter-serialisasi
+// (mbedtls_ssl_session_save). Tidak di-nol-kan saat soft reset; magic + CRC
+// membedakan isi sah dari sisa power-on.
+struct RtcSessionCache {
+  uint32_t magic;
+  uint16_t port;
+  uint16_t length;
+  char host[64];
+  uint8_t data[Config::TLS_SESSION_RTC_BYTES];
+  uint32_t crc;
+};
+
+static constexpr uint32_t RTC_SESSION_MAGIC = 0x544c5331;   // "TLS1"
+RTC_NOINIT_ATTR static RtcSessionCache rtcSession;
+
+static uint32_t rtcChecksum(const RtcSessionCache& c) {
+  // FNV-1a cukup untuk mendeteksi isi RAM acak setelah power-on
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(&c);
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < offsetof(RtcSessionCache, crc); i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Server melanjutkan sesi yang ditawarkan? Resume via session ID: server
+// membalas ID yang sama. Resume via ticket: klien mengarang session ID baru
+// di ClientHello, jadi yang tersisa sama hanya master secret. Handshake penuh
+// selalu menghasilkan master secret baru.
+static bool sameSession(const mbedtls_ssl_session& offered, const mbedtls_ssl_session& negotiated) {
+  if (offered.id_len > 0 && offered.id_len == negotiated.id_len &&
+      memcmp(offered.id, negotiated.id, offered.id_len) == 0) {
+    return true;
+  }
+  return memcmp(offered.master, negotiated.master, sizeof(offered.master)) == 0;
+}
+
+// ==================== IMPLEMENTASI ====================
+
+TlsSessionClient::TlsSessionClient() {
+  mbedtls_ssl_session_init(&session_);
+  if (Config::TLS_SESSION_RTC) restoreFromRtc();
+}
+
+TlsSessionClient::~TlsSessionClient() {
+  mbedtls_ssl_session_free(&session_);
+}
+
+void TlsSessionClient::restoreFromRtc() {
+  if (rtcSession.magic != RTC_SESSION_MAGIC || rtcSession.length > sizeof(rtcSession.data) ||
+      rtcSession.crc != rtcChecksum(rtcSession)) {
+    return;
+  }
+  if (mbedtls_ssl_session_load(&session_, rtcSession.data, rtcSession.length) != 0) {
+    mbedtls_ssl_session_free(&session_);
+    mbedtls_ssl_session_init(&session_);
+    return;
+  }
+  rtcSession.host[sizeof(rtcSession.host) - 1] = '\0';
+  copyText(sessionHost_, rtcSession.host);
+  sessionPort_ = rtcSession.port;
+  haveSession_ = true;
+  stats_.restoredAtBoot = true;
+}
+
+void TlsSessionClient::forgetSession() {
+  mbedtls_ssl_session_free(&session_);
+  mbedtls_ssl_session_init(&session_);
+  haveSession_ = false;
+  rtcSession.magic = 0;
+}
+
+int TlsSessionClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip, port, _timeout);
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port) {
+  return connect(host, port, _timeout);
+}
+
+int TlsSessionClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+  return handshake(ip, port, nullptr, timeout) ? 1 : 0;
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port, int32_t timeout) {
+  IPAddress ip;
+  if (!WiFi.hostByName(host, ip)) return 0;
+  return handshake(ip, port, host, timeout) ? 1 : 0;
+}
+
+bool TlsSessionClient::openSocket(const IPAddress& ip, uint16_t port, int32_t timeoutMs) {
+  sslclient->socket = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sslclient->socket < 0) return false;
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = static_cast<uint32_t>(ip);
+  addr.sin_port = htons(port);
+
+  // Socket tetap non-blocking setelah connect, seperti start_ssl_client():
+  // available() WiFiClientSecure mengandalkan mbedtls_net_recv yang tidak menunggu
+  fcntl(sslclient->socket, F_SETFL, fcntl(sslclient->socket, F_GETFL, 0) | O_NONBLOCK);
+  int res = lwip_connect(sslclient->socket, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  if (res < 0 && errno != EINPROGRESS) return false;
+
+  fd_set wset;
+  FD_ZERO(&wset);
+  FD_SET(sslclient->socket, &wset);
+  struct timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+  if (select(sslclient->socket + 1, nullptr, &wset, nullptr, timeoutMs > 0 ? &tv : nullptr) <= 0) return false;
+
+  int sockErr = 0;
+  socklen_t len = sizeof(sockErr);
+  getsockopt(sslclient->socket, SOL_SOCKET, SO_ERROR, &sockErr, &len);
+  if (sockErr != 0) return false;
+
+  int one = 1;
+  setsockopt(sslclient->socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return true;
+}
+
+bool TlsSessionClient::handshake(const IPAddress& ip, uint16_t port, const char* host, int32_t timeoutMs) {
+  stop();
+  ssl_init(sslclient);
+  mbedtls_entropy_init(&sslclient->entropy_ctx);
+  sslclient->socket = -1;
+  if (timeoutMs <= 0) timeoutMs = Config::HTTP_TIMEOUT;
+
+  unsigned long start = millis();
+  bool ok = openSocket(ip, port, timeoutMs) &&
+            mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func,
+                                  &sslclient->entropy_ctx, nullptr, 0) == 0 &&
+            mbedtls_ssl_config_defaults(&sslclient->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) == 0;
+  if (ok) {
+    mbedtls_ssl_conf_authmode(&sslclient->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&sslclient->ssl_conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+    mbedtls_ssl_conf_session_tickets(&sslclient->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    ok = mbedtls_ssl_setup(&sslclient->ssl_ctx, &sslclient->ssl_conf) == 0 &&
+         (host == nullptr || mbedtls_ssl_set_hostname(&sslclient->ssl_ctx, host) == 0);
+  }
+
+  // Tawarkan sesi lama hanya ke server yang sama
+  bool offered = false;
+  if (ok && haveSession_ && host != nullptr && sessionPort_ == port && strcmp(sessionHost_, host) == 0) {
+    offered = mbedtls_ssl_set_session(&sslclient->ssl_ctx, &session_) == 0;
+  }
+
+  if (ok) {
+    mbedtls_ssl_context& ssl = sslclient->ssl_ctx;
+    mbedtls_ssl_set_bio(&ssl, &sslclient->socket, mbedtls_net_send, mbedtls_net_recv, nullptr);
+    // Socket non-blocking: WANT_READ / WANT_WRITE = belum selesai, ulangi
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+      if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+          millis() - start > static_cast<unsigned long>(timeoutMs)) {
+        ok = false;
+        break;
+      }
+      vTaskDelay(2);
+    }
+  }
+
+  mbedtls_ssl_session negotiated;
+  mbedtls_ssl_session_init(&negotiated);
+  bool haveNegotiated = ok && mbedtls_ssl_get_session(&sslclient->ssl_ctx, &negotiated) == 0;
+  bool resumed = offered && haveNegotiated && sameSession(session_, negotiated);
+
+  uint32_t elapsed = millis() - start;
+  if (!ok) {
+    mbedtls_ssl_session_free(&negotiated);
+    stats_.failures++;
+    // Sesi yang ditolak dengan error (bukan sekadar handshake penuh) jangan ditawarkan lagi
+    if (offered) forgetSession();
+    stop();
+    return false;
+  }
+
+  if (offered) stats_.offered++;
+  if (resumed) {
+    stats_.resumed++;
+    stats_.resumedMsTotal += elapsed;
+    if (elapsed > stats_.resumedMsMax) stats_.resumedMsMax = elapsed;
+  } else {
+    stats_.full++;
+    stats_.fullMsTotal += elapsed;
+    if (elapsed > stats_.fullMsMax) stats_.fullMsMax = elapsed;
+  }
+  Serial.printf("TLS: handshake %s %lums\n", resumed ? "resumed" : "penuh", (unsigned long)elapsed);
+
+  if (host != nullptr && haveNegotiated) rememberSession(negotiated, host, port);
+  else mbedtls_ssl_session_free(&negotiated);
+  _connected = true;
+  return true;
+}
+
+void TlsSessionClient::rememberSession(mbedtls_ssl_session& negotiated, const char* host, uint16_t port) {
+  // Pindahkan kepemilikan (ticket / sertifikat peer) dari 'negotiated' ke cache
+  mbedtls_ssl_session_free(&session_);
+  session_ = negotiated;
+  mbedtls_ssl_session_init(&negotiated);
+  haveSession_ = true;
+  copyText(sessionHost_, host);
+  sessionPort_ = port;
+  if (Config::TLS_SESSION_RTC) saveToRtc(host, port);
+}
+
+void TlsSessionClient::saveToRtc(const char* host, uint16_t port) {
+  // Sesi dengan sertifikat server bisa lebih besar dari slot: tanpa salinan RTC
+  size_t length = 0;
+  if (mbedtls_ssl_session_save(&session_, rtcSession.data, sizeof(rtcSession.data), &length) != 0) {
+    rtcSession.magic = 0;
+    return;
+  }
+  rtcSession.magic = RTC_SESSION_MAGIC;
+  rtcSession.port = port;
+  rtcSession.length = static_cast<uint16_t>(length);
+  memset(rtcSession.host, 0, sizeof(rtcSession.host));
+  copyText(rtcSession.host, host);
+  rtcSession.crc = rtcChecksum(rtcSession);
+}
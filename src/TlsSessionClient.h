@@ -0,0 +1,66 @@
+#ifndef TLS_SESSION_CLIENT_H
+#define TLS_SESSION_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+// ==================== KLIEN TLS DENGAN RESUMPTION ====================
+// WiFiClientSecure selalu melakukan handshake penuh (ECDHE + tanda tangan
+// server), biaya CPU & latensi terbesar di ESP32. Kelas ini mengganti hanya
+// jalur connect(): sesi TLS terakhir (session ID / ticket) di-cache dan
+// ditawarkan lagi saat reconnect, jadi server yang mendukung cukup membalas
+// handshake singkat tanpa operasi asimetris. read/write/stop tetap milik
+// WiFiClientSecure (konteks sslclient yang sama).
+//
+// Cache ada di RAM. Dengan Config::TLS_SESSION_RTC ikut disalin ke RTC memory
+// (RTC_NOINIT) sehingga bertahan soft reset / WDT reset, tidak power-on --
+// opt-in karena salinan itu memuat master secret sesi (lihat Config.h).
+// Sertifikat server tidak diverifikasi, sama dengan setInsecure() sebelumnya.
+//
+// Hanya API publik mbedtls 2.28 (Arduino-ESP32 2.x, platform dipin di
+// platformio.ini): mbedtls_ssl_handshake / mbedtls_ssl_get_session dan field
+// publik mbedtls_ssl_session. mbedtls 3.x menyembunyikan field itu.
+
+struct TlsHandshakeStats {
+  uint32_t full = 0;             // handshake penuh
+  uint32_t resumed = 0;          // sesi dilanjutkan (session ID / ticket diterima server)
+  uint32_t offered = 0;          // handshake yang menawarkan sesi dari cache
+  uint32_t failures = 0;
+  uint32_t fullMsTotal = 0;
+  uint32_t fullMsMax = 0;
+  uint32_t resumedMsTotal = 0;
+  uint32_t resumedMsMax = 0;
+  bool restoredAtBoot = false;   // cache dipulihkan dari RTC memory saat boot (TLS_SESSION_RTC)
+};
+
+class TlsSessionClient : public WiFiClientSecure {
+public:
+  TlsSessionClient();
+  ~TlsSessionClient();
+
+  // Virtual di Client ESP32; HTTPClient memanggil connect(host, port, timeout)
+  int connect(IPAddress ip, uint16_t port);
+  int connect(const char* host, uint16_t port);
+  int connect(IPAddress ip, uint16_t port, int32_t timeout);
+  int connect(const char* host, uint16_t port, int32_t timeout);
+
+  // Buang sesi tersimpan (RAM + RTC jika dipakai), handshake berikutnya penuh
+  void forgetSession();
+
+  const TlsHandshakeStats& handshakeStats() const { return stats_; }
+
+private:
+  bool handshake(const IPAddress& ip, uint16_t port, const char* host, int32_t timeoutMs);
+  bool openSocket(const IPAddress& ip, uint16_t port, int32_t timeoutMs);
+  void rememberSession(mbedtls_ssl_session& negotiated, const char* host, uint16_t port);
+  void restoreFromRtc();
+  void saveToRtc(const char* host, uint16_t port);
+
+  mbedtls_ssl_session session_;
+  bool haveSession_ = false;
+  char sessionHost_[64] = "";
+  uint16_t sessionPort_ = 0;
+  TlsHandshakeStats stats_;
+};
+
+#endif
@@ -1,15 +1,26 @@
 #ifndef TYPES_H
 #define TYPES_H
 
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 enum class AppState : uint8_t {
   IDLE,
   SELECTING_SUBTYPE,
-  SENDING_DATA,
-  SHOWING_STATUS
+  SHOWING_STATUS,
+  MAINTENANCE,
+  CALIBRATING
 };
 
+// Salin teks ke array char berukuran tetap: selalu nul-terminated, dipotong
+// jika terlalu panjang (pengganti strncpy + nul manual)
+template <size_t N>
+inline void copyText(char (&dst)[N], const char* src) {
+  snprintf(dst, N, "%s", src);
+}
+
 struct WasteData {
   char jenis[16] = "--";
   char subJenis[16] = "--";
@@ -20,26 +31,62 @@ struct WasteData {
   }
   
   void setType(const char* type, const char* subtype = "--") {
-    strncpy(jenis, type, sizeof(jenis) - 1);
-    jenis[sizeof(jenis) - 1] = '\0';
-    strncpy(subJenis, subtype, sizeof(subJenis) - 1);
-    subJenis[sizeof(subJenis) - 1] = '\0';
+    copyText(jenis, type);
+    copyText(subJenis, subtype);
   }
   
-  String getDisplayName() const {
+  const char* getDisplayName() const {
     if (strcmp(jenis, "Anorganik") == 0 && strcmp(subJenis, "--") != 0) {
-      return (strcmp(subJenis, "Umum") == 0) ? "Anorganik" : String(subJenis);
+      return (strcmp(subJenis, "Umum") == 0) ? "Anorganik" : subJenis;
     }
-    return String(jenis);
+    return jenis;
   }
 };
 
+// Satu hasil konversi HX711, diberi cap waktu oleh task akuisisi
+struct RawSample {
+  uint32_t timestampUs;  // micros() saat konversi dibaca
+  uint32_t seq;          // nomor urut konversi (naik terus, untuk deteksi celah)
+  int32_t raw;           // word 24-bit HX711 (sign-extended), belum di-tare
+};
+
+// Counter untuk membuktikan tidak ada konversi yang hilang
+struct AcquisitionStats {
+  uint32_t produced;     // total sampel yang berhasil masuk ring buffer
+  uint32_t dropped;      // sampel dibuang karena ring buffer penuh (konsumen lambat)
+  uint32_t missed;       // konversi terlewat (jarak antar sampel > 1.5x periode)
+  uint32_t maxGapUs;     // jarak terbesar antar konversi yang pernah terlihat
+};
+
+// Satu hasil penimbangan yang dikirim ke server (berat sudah dikunci stabil)
+struct WeighingRecord {
+  int32_t weightMg = 0;
+  char fakultas[8] = "";
+  char jenis[16] = "";
+  // Kunci idempoten (deviceId(), bootId, seq): sama untuk setiap kirim ulang
+  // record ini, juga setelah reboot, jadi server bisa membuang duplikat.
+  // Diisi RecordJournal (0 = belum dijurnal).
+  uint32_t bootId = 0;
+  uint32_t seq = 0;
+};
+
+// Hasil upload satu record, dikirim balik dari worker jaringan ke state machine
+struct SendResult {
+  uint32_t id = 0;                      // nomor urut dari Uplink::enqueue()
+  WeighingRecord record;
+  bool ok = false;                      // server utama (Laravel) menerima record
+  uint32_t elapsedMs = 0;               // lama upload di worker
+};
+
 struct SystemState {
   AppState appState = AppState::IDLE;
   WasteData waste;
-  char fakultas[8] = "FPsi";
-  float currentWeight = 0.0f;
-  float lastDisplayedWeight = -1.0f;
+  char fakultas[8] = "FPsi";            // diisi dari DeviceProfile saat boot
+  int32_t currentWeightMg = 0;
+  int32_t filteredMg = 0;
+  int32_t lastDisplayedWeightMg = -1;   // -1 = belum pernah ditampilkan
+  int32_t stableWeightMg = 0;           // nilai terkunci dari StabilityDetector
+  bool isStable = false;
   bool offlineMode = false;
   bool isOnline = false;
   bool newDataReady = false;
@@ -0,0 +1,125 @@
+#include "WeighingPipeline.h"
+#include <stdlib.h>
+
+static const char* ZERO_TARE_KEY = "zero_tare";
+static const char* ZERO_OFFSET_KEY = "azt_offset";
+
+// ==================== IMPLEMENTASI ====================
+
+WeighingPipeline::WeighingPipeline(RuntimeSettings& params)
+  : calibration_(Config::MG_PER_COUNT_Q16),
+    adaptiveMetrics_(),
+    filter_(FilterPreset::make(Config::NOISE_GATE_THRESHOLD_MG, &params.adaptive, &adaptiveMetrics_)),
+    stability_(&params.stability),
+    zeroTracker_(&params.zeroTrack),
+    stableGate_(Filter::ClampNegative<int32_t>(), Filter::NoiseGate<int32_t>(Config::NOISE_GATE_THRESHOLD_MG)) {}
+
+bool WeighingPipeline::restoreZeroPoint() {
+  const int32_t NO_TARE = INT32_MIN;
+  int32_t savedTare = loadPersistedInt(ZERO_TARE_KEY, NO_TARE);
+  tarePending_ = true;
+  tareStableRun_ = 0;
+  tareRejectLogged_ = false;
+
+  if (savedTare == NO_TARE) {
+    tareKnown_ = false;
+    tareForced_ = true;
+    zeroTracker_.setOffset(0);
+    logPrintf("Tare: belum tersimpan, tunggu timbangan kosong & stabil\n");
+    return false;
+  }
+  tare_ = savedTare;
+  tareKnown_ = true;
+  tareForced_ = false;
+  zeroTracker_.setOffset(loadPersistedInt(ZERO_OFFSET_KEY, 0));
+  return true;
+}
+
+void WeighingPipeline::setTare(int32_t raw) {
+  tare_ = raw;
+  tareKnown_ = true;
+  tarePending_ = false;
+  zeroTracker_.setOffset(0);
+}
+
+void WeighingPipeline::requestTare() {
+  tarePending_ = true;
+  tareForced_ = true;
+  tareStableRun_ = 0;
+  tareRejectLogged_ = false;
+}
+
+void WeighingPipeline::updateTare() {
+  if (!tarePending_) return;
+  if (!stability_.isStable()) {
+    tareStableRun_ = 0;
+    return;
+  }
+  // Window rata-rata net harus seluruhnya berisi sampel stabil
+  if (++tareStableRun_ < Config::TARE_HOLD_SAMPLES) return;
+
+  int32_t driftMg = calibration_.toMg(averageNet_) - zeroTracker_.offset();
+  if (!tareForced_ && abs(driftMg) > Config::TARE_MAX_DRIFT_MG) {
+    // Ada beban di timbangan: titik nol tersimpan tetap dipakai, coba lagi
+    // setelah beban diangkat
+    if (!tareRejectLogged_) {
+      logPrintf("Tare: beban %ld mg di timbangan, pakai titik nol tersimpan\n", (long)driftMg);
+      tareRejectLogged_ = true;
+    }
+    tareStableRun_ = 0;
+    return;
+  }
+
+  tare_ += averageNet_;
+  zeroTracker_.setOffset(0);
+  netAverage_.reset(0);
+  averageNet_ = 0;
+  tarePending_ = false;
+  savePersistedInt(ZERO_TARE_KEY, tare_);
+  savePersistedInt(ZERO_OFFSET_KEY, 0);
+  logPrintf("Tare: diperbarui, titik nol bergeser %ld mg\n", (long)driftMg);
+}
+
+void WeighingPipeline::process(const RawSample& sample) {
+  if (!tareKnown_) {
+    tare_ = sample.raw;
+    tareKnown_ = true;
+  }
+  int32_t net = sample.raw - tare_;
+  averageNet_ = netAverage_.process(net);
+  int32_t mg = calibration_.toMg(net);
+  mg = zeroTracker_.apply(mg, stability_.isStable());
+  filteredMg_ = filter_.process(mg);
+  stability_.push(mg);
+  if (stability_.isStable()) noiseStats_.add(mg - stability_.stableValue());
+  updateTare();
+}
+
+void WeighingPipeline::persistZeroOffset() {
+  if (zeroTracker_.needsPersist(Config::AZT_PERSIST_DELTA_MG) &&
+      savePersistedInt(ZERO_OFFSET_KEY, zeroTracker_.offset())) {
+    zeroTracker_.markPersisted();
+  }
+}
+
+void WeighingPipeline::printStats(bool resetNoise) {
+  // Waktu settle = sampel sejak step sampai window paling lebar, dikonversi ke ms
+  unsigned long settleMs = adaptiveMetrics_.lastSettleSamples * 1000UL / Config::HX711_SPS;
+  logPrintf("ADAPT: steps=%lu settle=%lums noise=%ldmg shift=%ld\n",
+            (unsigned long)adaptiveMetrics_.steps, settleMs,
+            (long)adaptiveMetrics_.steadyNoise, (long)adaptiveMetrics_.currentShift);
+  logPrintf("ZERO: tare=%ld%s offset=%ldmg adjustments=%lu stable=%d\n",
+            (long)tare_, tarePending_ ? "(re-tare menunggu)" : "",
+            (long)zeroTracker_.offset(), (unsigned long)zeroTracker_.adjustments(),
+            stability_.isStable() ? 1 : 0);
+  logPrintf("NOISE: n=%lu sd=%.0fmg mad~%.0fmg p50=%.0f p95=%.0f p99=%.0f min=%.0f max=%.0f\n",
+            (unsigned long)noiseStats_.count(), noiseStats_.stddev(),
+            noiseStats_.approxMeanAbsDeviation(), noiseStats_.median(),
+            noiseStats_.p95(), noiseStats_.p99(),
+            noiseStats_.minValue(), noiseStats_.maxValue());
+
+  if (resetNoise) {
+    noiseStats_.reset();
+    logPrintf("Statistik noise direset\n");
+  }
+}
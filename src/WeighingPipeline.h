@@ -0,0 +1,87 @@
+#ifndef WEIGHING_PIPELINE_H
+#define WEIGHING_PIPELINE_H
+
+#include "Config.h"
+#include "Types.h"
+#include "Settings.h"
+#include "Calibration.h"
+#include "WeightFilters.h"
+#include "StabilityDetector.h"
+#include "ZeroTracker.h"
+#include "StreamingStats.h"
+
+// ==================== JALUR BERAT ====================
+// Raw count -> tare -> mg (tabel kalibrasi) -> auto-zero -> filter adaptif,
+// dengan detektor stabilitas & statistik noise di sampingnya.
+// Tidak bergantung pada Arduino: dipakai apa adanya di perangkat dan di env native.
+
+class WeighingPipeline {
+public:
+  // Pipeline filter per konversi (int32 mg): median 3 -> adaptive EMA -> clamp negatif -> noise gate.
+  // Parameter dibaca langsung dari 'params' sehingga 'set' di console langsung berlaku.
+  typedef Filter::Preset::Adaptive<int32_t> FilterPreset;
+  typedef Filter::Chain<int32_t, Filter::ClampNegative<int32_t>, Filter::NoiseGate<int32_t> > StableGate;
+
+  explicit WeighingPipeline(RuntimeSettings& params);
+
+  // Titik nol = tare (raw count) + offset auto-zero (mg), keduanya persisten.
+  // Dipakai langsung saat boot sehingga berat tersedia sejak sampel pertama;
+  // re-tare latar belakang menyusul begitu timbangan kosong & stabil.
+  // Return false jika belum ada tare tersimpan (boot pertama): tare sementara
+  // dari sampel pertama, re-tare pertama diterima tanpa batas drift.
+  bool restoreZeroPoint();
+
+  // Tare eksplisit tanpa NVS dan tanpa re-tare (replay trace di env native)
+  void setTare(int32_t raw);
+
+  // Paksa re-tare pada window kosong & stabil berikutnya, tanpa batas drift
+  // (console 'tare', mis. setelah sel beban dipasang ulang)
+  void requestTare();
+
+  // Proses satu konversi HX711
+  void process(const RawSample& sample);
+
+  // Simpan offset auto-zero jika sudah bergeser cukup jauh
+  void persistZeroOffset();
+
+  // Cetak metrik ADAPT / ZERO / NOISE; resetNoise mengosongkan statistik noise
+  void printStats(bool resetNoise);
+
+  int32_t filteredMg() const { return filteredMg_; }
+  bool isStable() const { return stability_.isStable(); }
+  int32_t stableWeightMg() { return stableGate_.process(stability_.stableValue()); }
+  int32_t tareOffset() const { return tare_; }
+  bool tarePending() const { return tarePending_; }
+  // Rata-rata net count (raw - tare) sepanjang window stabilitas, untuk menangkap titik kalibrasi
+  int32_t averageNet() const { return averageNet_; }
+  CalibrationTable& calibration() { return calibration_; }
+  const Filter::AdaptiveMetrics& adaptiveMetrics() const { return adaptiveMetrics_; }
+  const ZeroTracker& zeroTracker() const { return zeroTracker_; }
+  const StreamingStats& noiseStats() const { return noiseStats_; }
+
+private:
+  // Re-tare: titik nol baru = rata-rata window stabil, hanya jika bergeser
+  // <= TARE_MAX_DRIFT_MG dari titik nol tersimpan (kecuali dipaksa)
+  void updateTare();
+
+  CalibrationTable calibration_;
+  Filter::MovingAverage<int32_t, Config::STABILITY_WINDOW> netAverage_;
+  Filter::AdaptiveMetrics adaptiveMetrics_;
+  FilterPreset::type filter_;
+  // Deteksi gerak memakai sampel sebelum smoothing, supaya ayunan tidak tersamarkan filter
+  StabilityDetector<Config::STABILITY_WINDOW> stability_;
+  ZeroTracker zeroTracker_;
+  // Kualitas sinyal jangka panjang: sebaran sampel terhadap nilai terkunci selama stabil
+  StreamingStats noiseStats_;
+  StableGate stableGate_;
+  int32_t tare_ = 0;
+  bool tareKnown_ = false;
+  bool tarePending_ = false;
+  bool tareForced_ = false;
+  bool tareRejectLogged_ = false;
+  uint32_t tareStableRun_ = 0;
+  int32_t filteredMg_ = 0;
+  int32_t averageNet_ = 0;
+};
+
+#endif
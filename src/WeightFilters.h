@@ -0,0 +1,354 @@
+#ifndef WEIGHT_FILTERS_H
+#define WEIGHT_FILTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ==================== FILTER PIPELINE (HEADER-ONLY) ====================
+// Tahapan filter yang dirangkai saat compile time lewat Filter::Chain.
+// Semua ukuran window adalah parameter template, buffer ada di dalam objek,
+// sehingga tidak ada alokasi heap maupun virtual call per sampel.
+// Setiap tahap punya dua method:
+//   T process(T x);   // masukkan satu sampel, keluarkan hasil tahap ini
+//   void reset(T v);  // isi ulang state internal dengan nilai v
+// 'T' bisa float atau integer (mis. int32_t).
+
+namespace Filter {
+
+  // Tipe akumulator agar penjumlahan integer tidak overflow
+  template <typename T> struct Accum { typedef T type; };
+  template <> struct Accum<int32_t> { typedef int64_t type; };
+  template <> struct Accum<int16_t> { typedef int32_t type; };
+
+  template <typename T>
+  inline T absVal(T v) { return v < 0 ? -v : v; }
+
+  // Insertion sort untuk window kecil (N <= ~15), lebih cepat dari qsort
+  template <typename T>
+  inline void sortSmall(T* a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+      T key = a[i];
+      size_t j = i;
+      while (j > 0 && a[j - 1] > key) { a[j] = a[j - 1]; j--; }
+      a[j] = key;
+    }
+  }
+
+  // ---- Window sampel terakhir (dipakai Median & Hampel) ----
+  template <typename T, size_t N>
+  class Window {
+  public:
+    void push(T x) {
+      if (!primed_) { fill(x); return; }
+      data_[index_] = x;
+      index_ = (index_ + 1) % N;
+    }
+    void fill(T v) {
+      for (size_t i = 0; i < N; i++) data_[i] = v;
+      index_ = 0;
+      primed_ = true;
+    }
+    T median() const {
+      T tmp[N];
+      for (size_t i = 0; i < N; i++) tmp[i] = data_[i];
+      sortSmall(tmp, N);
+      return tmp[N / 2];
+    }
+    const T* data() const { return data_; }
+
+  private:
+    T data_[N];
+    size_t index_ = 0;
+    bool primed_ = false;
+  };
+
+  // ==================== TAHAPAN FILTER ====================
+
+  // Median N titik: membuang spike tunggal tanpa menggeser step
+  template <typename T, size_t N>
+  class Median {
+    static_assert(N % 2 == 1, "Window median harus ganjil");
+  public:
+    T process(T x) { window_.push(x); return window_.median(); }
+    void reset(T v) { window_.fill(v); }
+  private:
+    Window<T, N> window_;
+  };
+
+  // Rata-rata bergerak N titik dengan running sum (O(1) per sampel)
+  template <typename T, size_t N>
+  class MovingAverage {
+  public:
+    T process(T x) {
+      if (!primed_) reset(x);
+      sum_ += static_cast<typename Accum<T>::type>(x) - buffer_[index_];
+      buffer_[index_] = x;
+      index_ = (index_ + 1) % N;
+      return static_cast<T>(sum_ / static_cast<typename Accum<T>::type>(N));
+    }
+    void reset(T v) {
+      for (size_t i = 0; i < N; i++) buffer_[i] = v;
+      sum_ = static_cast<typename Accum<T>::type>(v) * N;
+      index_ = 0;
+      primed_ = true;
+    }
+  private:
+    T buffer_[N];
+    typename Accum<T>::type sum_ = 0;
+    size_t index_ = 0;
+    bool primed_ = false;
+  };
+
+  // EMA dengan alpha = 1 / 2^Shift. State disimpan dalam skala 2^Shift
+  // supaya versi integer tetap konvergen tepat ke input.
+  template <typename T, unsigned Shift>
+  class Ema {
+  public:
+    T process(T x) {
+      if (!primed_) reset(x);
+      acc_ += static_cast<Acc>(x) - acc_ / K;
+      return static_cast<T>(acc_ / K);
+    }
+    void reset(T v) { acc_ = static_cast<Acc>(v) * K; primed_ = true; }
+  private:
+    typedef typename Accum<T>::type Acc;
+    static constexpr Acc K = static_cast<Acc>(1u << Shift);
+    Acc acc_ = 0;
+    bool primed_ = false;
+  };
+
+  // ---- Adaptive EMA ----
+  // Parameter dibaca lewat pointer setiap sampel, sehingga bisa diubah saat
+  // runtime (console serial / NVS) tanpa membangun ulang chain.
+  struct AdaptiveParams {
+    int32_t stepThreshold;   // |x - y| di atas ini dianggap beban berubah (satuan T)
+    int32_t minShift;        // alpha = 1/2^minShift sesaat setelah step (0 = langsung ikut)
+    int32_t maxShift;        // alpha = 1/2^maxShift saat sinyal sudah tenang
+    int32_t settleSamples;   // jumlah sampel tenang sebelum shift dinaikkan satu tingkat
+  };
+
+  // Metrik yang ditulis stage untuk dipantau dari luar
+  struct AdaptiveMetrics {
+    uint32_t steps;               // jumlah step (perubahan beban) yang terdeteksi
+    uint32_t lastSettleSamples;   // sampel dari step sampai window kembali paling lebar
+    int32_t steadyNoise;          // rata-rata |x - y| saat tenang (satuan T)
+    int32_t currentShift;
+  };
+
+  // Saat step terdeteksi, output langsung melompat ke sampel baru (shift
+  // minimum), lalu alpha diperkecil bertahap selama sinyal tenang.
+  template <typename T>
+  class AdaptiveEma {
+  public:
+    // 'params' wajib (dibaca setiap sampel), jadi tidak ada konstruktor default
+    explicit AdaptiveEma(const AdaptiveParams* params, AdaptiveMetrics* metrics = nullptr)
+      : params_(params), metrics_(metrics) {}
+
+    T process(T x) {
+      if (!primed_) reset(x);
+
+      Acc xs = static_cast<Acc>(x) * FRAC;
+      T innovation = static_cast<T>(x - static_cast<T>(acc_ / FRAC));
+
+      if (absVal(innovation) > static_cast<T>(params_->stepThreshold)) {
+        // Beban berubah: ikuti secepatnya
+        shift_ = params_->minShift;
+        acc_ = xs;
+        calmCount_ = 0;
+        samplesSinceStep_ = 0;
+        settling_ = true;
+        if (metrics_) metrics_->steps++;
+      } else {
+        acc_ += (xs - acc_) / static_cast<Acc>(1L << shift_);
+        samplesSinceStep_++;
+
+        if (shift_ < params_->maxShift && ++calmCount_ >= params_->settleSamples) {
+          shift_++;
+          calmCount_ = 0;
+        }
+        if (shift_ >= params_->maxShift) {
+          if (settling_) {
+            settling_ = false;
+            if (metrics_) metrics_->lastSettleSamples = samplesSinceStep_;
+          }
+          // Noise steady-state: EMA 1/16 dari |innovation|
+          noise_ += absVal(static_cast<Acc>(innovation) * FRAC) / 16 - noise_ / 16;
+        }
+      }
+
+      if (metrics_) {
+        metrics_->steadyNoise = static_cast<int32_t>(noise_ / FRAC);
+        metrics_->currentShift = shift_;
+      }
+      return static_cast<T>(acc_ / FRAC);
+    }
+
+    void reset(T v) {
+      acc_ = static_cast<Acc>(v) * FRAC;
+      shift_ = params_->maxShift;
+      calmCount_ = 0;
+      settling_ = false;
+      primed_ = true;
+    }
+
+  private:
+    typedef typename Accum<T>::type Acc;
+    static constexpr Acc FRAC = static_cast<Acc>(256);   // 8 bit pecahan untuk versi integer
+
+    const AdaptiveParams* params_;
+    AdaptiveMetrics* metrics_;
+    Acc acc_ = 0;
+    Acc noise_ = 0;
+    int32_t shift_ = 0;
+    int32_t calmCount_ = 0;
+    uint32_t samplesSinceStep_ = 0;
+    bool settling_ = false;
+    bool primed_ = false;
+  };
+
+  // Hampel: ganti sampel outlier (|x - median| > k * 1.4826 * MAD) dengan median.
+  // k diberikan sebagai pecahan kNum/kDen, 1.4826 didekati 3/2.
+  template <typename T, size_t N>
+  class Hampel {
+    static_assert(N % 2 == 1, "Window Hampel harus ganjil");
+  public:
+    Hampel(T minThreshold = 0, uint8_t kNum = 3, uint8_t kDen = 1)
+      : minThreshold_(minThreshold), kNum_(kNum), kDen_(kDen) {}
+
+    T process(T x) {
+      window_.push(x);
+      T med = window_.median();
+
+      T dev[N];
+      const T* d = window_.data();
+      for (size_t i = 0; i < N; i++) dev[i] = absVal(static_cast<T>(d[i] - med));
+      sortSmall(dev, N);
+      T mad = dev[N / 2];
+
+      T threshold = static_cast<T>(mad * kNum_ * 3 / (2 * kDen_));
+      if (threshold < minThreshold_) threshold = minThreshold_;
+      return absVal(static_cast<T>(x - med)) > threshold ? med : x;
+    }
+    void reset(T v) { window_.fill(v); }
+  private:
+    Window<T, N> window_;
+    T minThreshold_;
+    uint8_t kNum_;
+    uint8_t kDen_;
+  };
+
+  // Deadband: output hanya bergerak jika input keluar dari pita +/- band
+  template <typename T>
+  class Deadband {
+  public:
+    explicit Deadband(T band = 0) : band_(band) {}
+    T process(T x) {
+      if (!primed_ || absVal(static_cast<T>(x - last_)) > band_) { last_ = x; primed_ = true; }
+      return last_;
+    }
+    void reset(T v) { last_ = v; primed_ = true; }
+  private:
+    T band_;
+    T last_ = 0;
+    bool primed_ = false;
+  };
+
+  // Noise gate: nilai di sekitar nol dipaksa tepat nol
+  template <typename T>
+  class NoiseGate {
+  public:
+    explicit NoiseGate(T threshold = 0) : threshold_(threshold) {}
+    T process(T x) { return absVal(x) < threshold_ ? static_cast<T>(0) : x; }
+    void reset(T) {}
+  private:
+    T threshold_;
+  };
+
+  // Potong nilai negatif ke nol (timbangan tidak menampilkan berat negatif)
+  template <typename T>
+  class ClampNegative {
+  public:
+    T process(T x) { return x < 0 ? static_cast<T>(0) : x; }
+    void reset(T) {}
+  };
+
+  // ==================== CHAIN ====================
+  // Chain<T, A, B, C>::process(x) == C.process(B.process(A.process(x)))
+
+  template <typename T, typename... Stages>
+  class Chain;
+
+  template <typename T>
+  class Chain<T> {
+  public:
+    T process(T x) { return x; }
+    void reset(T) {}
+  };
+
+  template <typename T, typename Head, typename... Tail>
+  class Chain<T, Head, Tail...> {
+  public:
+    Chain() {}
+    Chain(const Head& head, const Tail&... tail) : head_(head), tail_(tail...) {}
+
+    T process(T x) { return tail_.process(head_.process(x)); }
+    void reset(T v) { head_.reset(v); tail_.reset(v); }
+
+    Head& head() { return head_; }
+    Chain<T, Tail...>& tail() { return tail_; }
+
+  private:
+    Head head_;
+    Chain<T, Tail...> tail_;
+  };
+
+  // ==================== PRESET ====================
+  // Di WeighingPipeline T = int32_t miligram, jadi semua ambang (noiseGate, hampelMin,
+  // deadband, AdaptiveParams::stepThreshold) juga dalam mg, mis. Config::NOISE_GATE_THRESHOLD_MG
+  // = 10000 (10 g). make*() mengisi parameter runtime tiap tahap.
+  namespace Preset {
+
+    // Cepat: spike dibuang median 3, sisanya EMA ringan
+    template <typename T>
+    struct Responsive {
+      typedef Chain<T, Median<T, 3>, Ema<T, 1>, ClampNegative<T>, NoiseGate<T> > type;
+      static type make(T noiseGate) {
+        return type(Median<T, 3>(), Ema<T, 1>(), ClampNegative<T>(), NoiseGate<T>(noiseGate));
+      }
+    };
+
+    // Standar: setara perilaku lama (rata-rata AvgN konversi + noise gate) plus Hampel
+    template <typename T, size_t AvgN = 4>
+    struct Standard {
+      typedef Chain<T, Hampel<T, 7>, MovingAverage<T, AvgN>, ClampNegative<T>, NoiseGate<T> > type;
+      static type make(T noiseGate, T hampelMin) {
+        return type(Hampel<T, 7>(hampelMin), MovingAverage<T, AvgN>(), ClampNegative<T>(),
+                    NoiseGate<T>(noiseGate));
+      }
+    };
+
+    // Adaptif: cepat saat beban berubah, halus saat diam (parameter runtime).
+    // Median 3 dipakai (bukan Hampel 7) supaya step terlihat di konversi ke-2.
+    template <typename T>
+    struct Adaptive {
+      typedef Chain<T, Median<T, 3>, AdaptiveEma<T>, ClampNegative<T>, NoiseGate<T> > type;
+      static type make(T noiseGate, const AdaptiveParams* params, AdaptiveMetrics* metrics) {
+        return type(Median<T, 3>(), AdaptiveEma<T>(params, metrics), ClampNegative<T>(),
+                    NoiseGate<T>(noiseGate));
+      }
+    };
+
+    // Berat: untuk lokasi bergetar, lambat tapi sangat tenang
+    template <typename T>
+    struct Heavy {
+      typedef Chain<T, Hampel<T, 9>, MovingAverage<T, 16>, Ema<T, 2>, Deadband<T>,
+                    ClampNegative<T>, NoiseGate<T> > type;
+      static type make(T noiseGate, T hampelMin, T deadband) {
+        return type(Hampel<T, 9>(hampelMin), MovingAverage<T, 16>(), Ema<T, 2>(),
+                    Deadband<T>(deadband), ClampNegative<T>(), NoiseGate<T>(noiseGate));
+      }
+    };
+  }
+}
+
+#endif
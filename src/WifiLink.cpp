@@ -0,0 +1,144 @@
+#include "WifiLink.h"
+#include <string.h>
+#include "Settings.h"
+
+static const char* BSS_KEY = "wifi_bss";
+static constexpr uint8_t BSS_BLOB_VERSION = 1;
+
+// Layout cache AP di NVS (8 byte)
+struct BssBlob {
+  uint8_t version;
+  uint8_t channel;
+  uint8_t bssid[6];
+};
+
+static void recordDuration(uint32_t ms, uint32_t& last, uint32_t& max, uint32_t& total, uint32_t& count) {
+  last = ms;
+  if (ms > max) max = ms;
+  total += ms;
+  count++;
+}
+
+// ==================== IMPLEMENTASI ====================
+
+void WifiLink::begin(uint32_t now, uint32_t seed) {
+  rng_ = seed != 0 ? seed : 0x9E3779B9u;   // xorshift tidak boleh mulai dari 0
+  BssBlob blob;
+  if (loadPersistedBlob(BSS_KEY, &blob, sizeof(blob)) && blob.version == BSS_BLOB_VERSION &&
+      blob.channel >= 1 && blob.channel <= 14) {
+    memcpy(cache_.bssid, blob.bssid, sizeof(cache_.bssid));
+    cache_.channel = blob.channel;
+    cacheValid_ = true;
+  }
+  join(now);
+}
+
+void WifiLink::tick(uint32_t now) {
+  Hal::WifiRadio::Event ev;
+  while (radio_.pollEvent(ev)) {
+    switch (ev.type) {
+      case Hal::WifiRadio::EventType::ASSOCIATED:
+        associatedValid_ = radio_.currentBss(associated_);
+        break;
+      case Hal::WifiRadio::EventType::GOT_IP:
+        if (!up_) onGotIp(now);
+        break;
+      case Hal::WifiRadio::EventType::DISCONNECTED:
+        lastReason_ = ev.reason;
+        if (up_) {
+          // Outage baru: rejoin seketika ke AP yang sama, tanpa backoff
+          up_ = false;
+          inOutage_ = true;
+          awaitingOnline_ = true;
+          lostMs_ = now;
+          stats_.outages++;
+          failStreak_ = 0;
+          fastTries_ = 0;
+          join(now);
+        } else if (state_ == State::JOINING) {
+          onFailure(now);
+        }
+        break;
+    }
+  }
+
+  if (state_ == State::JOINING && now - stateMs_ >= Config::WIFI_JOIN_TIMEOUT) {
+    onFailure(now);
+  } else if (state_ == State::BACKOFF && static_cast<int32_t>(now - stateMs_) >= 0) {
+    join(now);
+  }
+}
+
+void WifiLink::markOnline(uint32_t now) {
+  if (!awaitingOnline_) return;
+  awaitingOnline_ = false;
+  recordDuration(now - lostMs_, stats_.onlineMsLast, stats_.onlineMsMax, stats_.onlineMsTotal,
+                 stats_.onlineRecovered);
+}
+
+uint32_t WifiLink::retryInMs(uint32_t now) const {
+  if (state_ != State::BACKOFF || static_cast<int32_t>(now - stateMs_) >= 0) return 0;
+  return stateMs_ - now;
+}
+
+void WifiLink::join(uint32_t now) {
+  const bool fast = cacheValid_ && fastTries_ < Config::WIFI_FAST_REJOIN_TRIES;
+  if (fast) {
+    fastTries_++;
+    stats_.fastJoins++;
+  } else {
+    // AP mati lama: setelah scan, coba cache lagi agar begitu AP hidup tidak menunggu scan
+    fastTries_ = 0;
+  }
+  stats_.joins++;
+  associatedValid_ = false;
+  state_ = State::JOINING;
+  stateMs_ = now;
+  radio_.join(fast ? &cache_ : nullptr);
+}
+
+void WifiLink::onFailure(uint32_t now) {
+  stats_.failures++;
+  if (failStreak_ < 31) failStreak_++;
+
+  uint32_t base = Config::WIFI_BACKOFF_MAX;
+  if (failStreak_ <= 16 && (Config::WIFI_BACKOFF_MIN << (failStreak_ - 1)) < Config::WIFI_BACKOFF_MAX) {
+    base = Config::WIFI_BACKOFF_MIN << (failStreak_ - 1);
+  }
+  // Equal jitter: [base/2, base]
+  uint32_t delay = base / 2 + nextRandom() % (base / 2 + 1);
+  state_ = State::BACKOFF;
+  stateMs_ = now + delay;
+}
+
+void WifiLink::onGotIp(uint32_t now) {
+  up_ = true;
+  everUp_ = true;
+  state_ = State::UP;
+  failStreak_ = 0;
+  fastTries_ = 0;
+  if (inOutage_) {
+    inOutage_ = false;
+    recordDuration(now - lostMs_, stats_.linkMsLast, stats_.linkMsMax, stats_.linkMsTotal, stats_.linkRecovered);
+  }
+
+  // Simpan AP hanya jika berubah: hemat tulis NVS
+  if (associatedValid_ && (!cacheValid_ || associated_.channel != cache_.channel ||
+                           memcmp(associated_.bssid, cache_.bssid, sizeof(cache_.bssid)) != 0)) {
+    cache_ = associated_;
+    cacheValid_ = true;
+    BssBlob blob;
+    blob.version = BSS_BLOB_VERSION;
+    blob.channel = cache_.channel;
+    memcpy(blob.bssid, cache_.bssid, sizeof(blob.bssid));
+    savePersistedBlob(BSS_KEY, &blob, sizeof(blob));
+  }
+}
+
+uint32_t WifiLink::nextRandom() {
+  // xorshift32: cukup untuk jitter, tanpa rand() global
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return rng_;
+}
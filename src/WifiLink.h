@@ -0,0 +1,90 @@
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include "Config.h"
+#include "Hal.h"
+
+// ==================== MANAJEMEN LINK WIFI ====================
+// Pengganti polling WiFi.status() tiap WIFI_CHECK_INTERVAL (15 s): reaksi
+// langsung ke event radio (Hal::WifiRadio), tick() hanya mengambil event
+// dan menjadwalkan join berikutnya, tidak pernah menunggu.
+//
+//   - link putus -> rejoin seketika ke BSSID/kanal terakhir (tanpa scan)
+//   - join gagal -> backoff eksponensial WIFI_BACKOFF_MIN..MAX dengan
+//     "equal jitter" (setengah tetap + setengah acak), agar timbangan
+//     satu gedung tidak menyerbu AP bersamaan setelah AP restart
+//   - WIFI_FAST_REJOIN_TRIES gagal dengan BSSID cache -> satu scan penuh
+//     (AP pindah kanal / diganti), lalu kembali coba cache
+//   - BSSID + kanal AP terakhir disimpan di NVS ("wifi_bss"), jadi join
+//     pertama setelah boot juga tanpa scan
+//   - join tanpa event dalam WIFI_JOIN_TIMEOUT dihitung gagal
+//
+// Time-to-online: dari link putus sampai dapat IP (link) dan sampai server
+// terjangkau lagi (markOnline(), dari ReachabilityProbe).
+
+struct LinkStats {
+  uint32_t joins = 0;           // join yang dimulai
+  uint32_t fastJoins = 0;       // ... dengan BSSID/kanal cache (tanpa scan)
+  uint32_t failures = 0;        // join gagal (event putus / timeout)
+  uint32_t outages = 0;         // link putus setelah sempat dapat IP
+  uint32_t linkRecovered = 0;   // outage yang sudah dapat IP lagi
+  uint32_t linkMsLast = 0;
+  uint32_t linkMsMax = 0;
+  uint32_t linkMsTotal = 0;
+  uint32_t onlineRecovered = 0; // outage yang servernya sudah terjangkau lagi
+  uint32_t onlineMsLast = 0;
+  uint32_t onlineMsMax = 0;
+  uint32_t onlineMsTotal = 0;
+};
+
+class WifiLink {
+public:
+  explicit WifiLink(Hal::WifiRadio& radio) : radio_(radio) {}
+
+  // Muat BSSID cache dari NVS (initSettings() harus sudah jalan), join pertama.
+  // 'seed' untuk jitter backoff; beda per perangkat (mis. dari MAC).
+  void begin(uint32_t now, uint32_t seed);
+  void tick(uint32_t now);
+  // Server terjangkau lagi setelah outage (catat time-to-online)
+  void markOnline(uint32_t now);
+
+  bool up() const { return up_; }
+  bool everUp() const { return everUp_; }
+  bool hasCachedBss() const { return cacheValid_; }
+  const Hal::WifiRadio::Bss& cachedBss() const { return cache_; }
+  uint8_t lastReason() const { return lastReason_; }
+  // Sisa backoff sebelum join berikutnya (0 = sedang join / tersambung)
+  uint32_t retryInMs(uint32_t now) const;
+  const LinkStats& stats() const { return stats_; }
+
+private:
+  enum class State : uint8_t { IDLE, JOINING, UP, BACKOFF };
+
+  void join(uint32_t now);
+  void onFailure(uint32_t now);
+  void onGotIp(uint32_t now);
+  uint32_t nextRandom();
+
+  Hal::WifiRadio& radio_;
+  State state_ = State::IDLE;
+  bool up_ = false;
+  bool everUp_ = false;
+  uint32_t stateMs_ = 0;        // join dimulai / backoff berakhir
+  uint8_t failStreak_ = 0;
+  uint8_t fastTries_ = 0;       // join dengan cache sejak terakhir dapat IP
+  uint8_t lastReason_ = 0;
+  uint32_t rng_ = 1;
+
+  Hal::WifiRadio::Bss cache_;
+  bool cacheValid_ = false;
+  Hal::WifiRadio::Bss associated_;
+  bool associatedValid_ = false;
+
+  bool inOutage_ = false;
+  bool awaitingOnline_ = false;
+  uint32_t lostMs_ = 0;
+  LinkStats stats_;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef ZERO_TRACKER_H
+#define ZERO_TRACKER_H
+
+#include <stdint.h>
+
+// ==================== AUTO-ZERO TRACKING ====================
+// Pengganti prototipe applySoftwareThermalCompensation() (kompensasi-suhu.cpp).
+// Offset nol hanya digeser saat timbangan KOSONG dan STABIL:
+//  - kosong  = |berat terkoreksi| <= zeroBand (mis. 8 g, di bawah 1 digit layar)
+//  - laju    = maks maxStep mg per sampel, jadi beban sungguhan (step cepat)
+//              tidak pernah ikut ter-nol-kan
+//  - batas   = total koreksi dibatasi +/- maxCorrection
+// Offset yang dihasilkan disimpan ke NVS oleh pemanggil (lihat needsPersist()).
+
+struct ZeroTrackParams {
+  int32_t zeroBand;        // mg, jendela di sekitar nol yang dianggap kosong
+  int32_t maxStep;         // mg per sampel, batas laju tracking
+  int32_t maxCorrection;   // mg, batas total offset
+};
+
+class ZeroTracker {
+public:
+  // 'params' wajib (dibaca setiap sampel), tanpa konstruktor default
+  explicit ZeroTracker(const ZeroTrackParams* params) : params_(params) {}
+
+  // Kurangi offset dari sampel. 'stable' adalah status detektor stabilitas
+  // untuk sampel sebelumnya (umpan balik satu sampel).
+  int32_t apply(int32_t mg, bool stable) {
+    int32_t corrected = mg - offset_;
+
+    if (stable && corrected <= params_->zeroBand && corrected >= -params_->zeroBand) {
+      int32_t step = corrected;
+      if (step > params_->maxStep) step = params_->maxStep;
+      if (step < -params_->maxStep) step = -params_->maxStep;
+
+      int32_t next = offset_ + step;
+      if (next > params_->maxCorrection) next = params_->maxCorrection;
+      if (next < -params_->maxCorrection) next = -params_->maxCorrection;
+      if (next != offset_) adjustments_++;
+      offset_ = next;
+    }
+    return corrected;
+  }
+
+  // Dipakai saat boot (offset tersimpan) atau setelah tare ulang (offset 0)
+  void setOffset(int32_t offset) {
+    offset_ = offset;
+    persistedOffset_ = offset;
+  }
+
+  int32_t offset() const { return offset_; }
+  uint32_t adjustments() const { return adjustments_; }
+
+  // True jika offset sudah bergeser cukup jauh dari nilai tersimpan,
+  // agar NVS tidak ditulis setiap sampel
+  bool needsPersist(int32_t minDelta) const {
+    int32_t delta = offset_ - persistedOffset_;
+    return delta >= minDelta || delta <= -minDelta;
+  }
+  void markPersisted() { persistedOffset_ = offset_; }
+
+private:
+  const ZeroTrackParams* params_;
+  int32_t offset_ = 0;
+  int32_t persistedOffset_ = 0;
+  uint32_t adjustments_ = 0;
+};
+
+#endif
@@ -1,10 +1,7 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <PubSubClient.h>
 #include <ezButton.h>
-#include <HX711_ADC.h>
-#include <EEPROM.h>
 #include <esp_task_wdt.h>
 
 // Include Modular Files
@@ -13,15 +10,21 @@
 #include "Types.h"
 #include "DisplayHandler.h"
 #include "NetworkHandler.h"
+#include "Acquisition.h"
+#include "Settings.h"
+#include "SerialConsole.h"
+#include "HalEsp32.h"
+#include "ScaleApp.h"
+#include "BootProfiler.h"
+#include "MqttPublisher.h"
 
 // ==================== GLOBAL OBJECTS ====================
 // Inisialisasi LCD dan BigNumbers
 LiquidCrystal_I2C lcd(0x27, 20, 4); 
 
-// Inisialisasi Load Cell & Network Client
-HX711_ADC loadCell(Config::HX711_DOUT, Config::HX711_SCK);
-WiFiClient wifiClient;
-PubSubClient mqttClient(wifiClient);
+// Inisialisasi Network Client (Load Cell dimiliki task akuisisi)
+LwipSocket mqttSocket;
+MqttPublisher mqtt(mqttSocket);
 
 // Inisialisasi Tombol
 ezButton buttons[] = {
@@ -31,245 +34,187 @@ ezButton buttons[] = {
   ezButton(Config::PIN_TOMBOL_4)
 };
 
-// Global State
-SystemState state;
+// Adapter HAL: logika aplikasi (ScaleApp) tidak menyentuh hardware langsung
+LcdDisplay display(lcd);
+EzButtonPanel buttonPanel(buttons);
+PinBuzzer buzzer;
+AcquisitionSource sampleSource;
+NetworkUplink uplink(mqtt);
+NvsStorage storage("ecoscale");
+LittleFsStore fileStore;
+SerialCaptureTap captureTap;
+BootProfiler bootProfiler;
 
-// Timer struct (Local untuk Main Loop)
-struct Timers {
-  unsigned long lastWeightRead = 0;
-  unsigned long lastLCDUpdate = 0;
-  unsigned long lastWifiCheck = 0;
-  unsigned long lastMqttRetry = 0;
-  unsigned long lastStatusDisplay = 0;
-  unsigned long statusMsgTimestamp = 0;
-} timers;
+ScaleApp app(display, buttonPanel, buzzer, sampleSource, uplink, fileStore, settings);
 
 // ==================== LOCAL FUNCTION DECLARATIONS ====================
-void processButtons();
-void handleSendData();
-float readSmoothedWeight();
-void playTone(uint16_t freq, uint16_t duration);
+void printFilterStats(const char* args);
+void setCaptureMode(const char* args);
+void calibrate(const char* args);
+void configureProfile(const char* args);
+void tare(const char* args);
+void printBootProfile(const char* args);
+void printNetStats(const char* args);
+void journal(const char* args);
 
 // ==================== SETUP ====================
 void setup() {
   Serial.begin(115200);
   Serial.println("\n=== EcoScale Modular Firmware ===");
-  
-  // 1. Init WDT
+  bootProfiler.mark("serial", millis());
+  
+  // Pengaturan runtime dari NVS (beberapa ms), sebelum WiFi: cache BSSID/kanal
+  // AP untuk join tanpa scan ada di NVS
+  initSettings(storage);
+  bootProfiler.mark("settings", millis());
+  
+  // 1. Network duluan, tanpa menunggu: asosiasi WiFi + DHCP berjalan di task
+  // WiFi selama LCD & sensor disiapkan. MQTT menyusul dari loop() (NetworkUplink).
+  mqtt.setServer(MQTT_SERVER, MQTT_PORT);
+  uplink.setBootProfiler(&bootProfiler);
+  if (!uplink.begin()) Serial.println("Worker jaringan gagal dibuat!");
+  bootProfiler.mark("wifi_begin", millis());
+  
+  // Console serial
+  registerConsoleCommand("stats", printFilterStats, "metrik akuisisi, smoothing & noise ('stats reset')");
+  registerConsoleCommand("cal", calibrate, "tabel kalibrasi ('cal add <gram>', 'cal auto', 'cal save', 'cal reset')");
+  registerConsoleCommand("tare", tare, "re-tare paksa saat timbangan kosong & stabil");
+  registerConsoleCommand("profile", configureProfile, "profil lokasi ('profile use <fakultas>', 'profile set <nama> <count/gram>')");
+  registerConsoleCommand("capture", setCaptureMode, "stream frame biner raw 80 SPS ('capture on|off')");
+  registerConsoleCommand("boot", printBootProfile, "cap waktu per fase startup");
+  registerConsoleCommand("net", printNetStats, "sesi HTTPS Laravel: reuse, batch, handshake TLS & latensi per POST; link WiFi & time-to-online; probe server; antrean MQTT QoS 1");
+  registerConsoleCommand("journal", journal, "jurnal record offline ('journal bench <n>' ukur append/replay)");
+  
+  // Jurnal record di LittleFS (format otomatis saat pertama kali)
+  if (!fileStore.begin()) Serial.println("LittleFS gagal di-mount, record tidak bisa disimpan!");
+  bootProfiler.mark("fs", millis());
+  
+  // 2. Init WDT
   esp_task_wdt_init(60, true);
   esp_task_wdt_add(NULL);
   
-  // 2. Init Hardware
+  // 3. Init Hardware
   pinMode(Config::PIN_BUZZER, OUTPUT);
   
   // Panggil fungsi dari DisplayHandler
   initializeLCD(lcd);
+  bootProfiler.mark("lcd", millis());
   
-  // Init LoadCell
-  loadCell.begin();
-  EEPROM.begin(512);
-  loadCell.start(2000, true);
-  if (loadCell.getTareTimeoutFlag()) {
+  // Init LoadCell + task akuisisi (HX711 dibaca terus di core terpisah)
+  if (!startAcquisition()) {
     lcd.clear();
     lcd.print("HX711 Error!");
     while (true) { esp_task_wdt_reset(); delay(100); }
   }
-  loadCell.setCalFactor(Config::CALIBRATION_VALUE);
-  loadCell.setSamplesInUse(Config::LOAD_CELL_SAMPLES);
-
-  // 3. Init Network (Panggil dari NetworkHandler)
-  mqttClient.setServer(MQTT_SERVER, MQTT_PORT);
-  
-  // Pass address lcd untuk menampilkan status koneksi
-  if (!connectWiFi(&lcd)) {
-    state.offlineMode = true;
-    showStatusMessage(lcd, "WiFi Gagal!");
-    playTone(500, 1000);
-  } else {
-    connectMQTT(mqttClient);
-    showStatusMessage(lcd, "System Ready");
-  }
-  
-  delay(2000);
-  
-  // Tampilkan layar utama
-  restoreDefaultDisplay(lcd, state);
-  updateWeightDisplay(0.0f);
-  
-  timers.lastWeightRead = millis();
-  timers.lastLCDUpdate = millis();
+  bootProfiler.mark("hx711", millis());
+  app.begin(millis());
+  
+  // 4. Layar utama langsung, tidak menunggu jaringan: status WiFi/MQTT
+  // tampil lewat ikon, record selama offline disimpan di jurnal
+  app.showMainScreen();
+  bootProfiler.mark("ready", millis());
+  bootProfiler.report();
 }
 
 // ==================== MAIN LOOP ====================
 void loop() {
   esp_task_wdt_reset();
-  
-  // 1. Update Buttons
-  for (auto& btn : buttons) btn.loop();
-  
-  // 2. Network Maintenance (Panggil dari NetworkHandler)
-  manageWiFiConnection(state, timers.lastWifiCheck);
-  
-  if (!state.offlineMode) {
-    if (!mqttClient.connected() && millis() - timers.lastMqttRetry > Config::MQTT_RETRY_INTERVAL) {
-      connectMQTT(mqttClient);
-      timers.lastMqttRetry = millis();
-    }
-    mqttClient.loop();
-  }
-  
-  // 3. State Machine Logic
-  switch (state.appState) {
-    case AppState::IDLE: {
-      unsigned long now = millis();
-      
-      // Update Load Cell
-      if (loadCell.update()) {
-        state.newDataReady = true;
-      }
-      
-      // Read Weight
-      if (state.newDataReady && now - timers.lastWeightRead >= Config::WEIGHT_READ_INTERVAL) {
-        state.currentWeight = readSmoothedWeight();
-        timers.lastWeightRead = now;
-        state.newDataReady = false;
-      }
-      
-      // Update Display Weight
-      if (now - timers.lastLCDUpdate >= Config::LCD_UPDATE_INTERVAL) {
-        if (abs(state.currentWeight - state.lastDisplayedWeight) > Config::MIN_WEIGHT_THRESHOLD ||
-            state.lastDisplayedWeight < 0) {
-          updateWeightDisplay(state.currentWeight);
-          state.lastDisplayedWeight = state.currentWeight;
-        }
-        timers.lastLCDUpdate = now;
-      }
-      
-      // Update Status Icons (WiFi/MQTT) di baris bawah
-      if (now - timers.lastStatusDisplay >= Config::STATUS_DISPLAY_INTERVAL) {
-        updateStatusIndicators(lcd, state.offlineMode, mqttClient.connected());
-        timers.lastStatusDisplay = now;
-      }
-
-      processButtons();
-      handleSendData();
-      break;
-    }
-    
-    case AppState::SELECTING_SUBTYPE:
-      processButtons();
-      break;
-      
-    case AppState::SENDING_DATA:
-      // Menunggu proses kirim (blocking sebentar di handleSendData)
-      break;
-      
-    case AppState::SHOWING_STATUS:
-      // Kembali ke tampilan awal setelah durasi tertentu
-      if (millis() - timers.statusMsgTimestamp > Config::STATUS_MSG_DURATION) {
-        restoreDefaultDisplay(lcd, state);
-        state.appState = AppState::IDLE;
-      }
-      break;
-  }
+  pollSerialConsole();
+  app.tick(millis());
 }
 
 // ==================== LOCAL HELPER FUNCTIONS ====================
 
-void processButtons() {
-  // Tombol 1: Organik / Anorganik (Umum)
-  if (buttons[0].isPressed()) {
-    if (state.appState == AppState::IDLE) {
-      state.waste.setType("Organik");
-      playTone(2500, 100);
-      restoreDefaultDisplay(lcd, state);
-    } else if (state.appState == AppState::SELECTING_SUBTYPE) {
-      state.waste.setType("Anorganik", "Umum");
-      playTone(2500, 100);
-      restoreDefaultDisplay(lcd, state);
-      state.appState = AppState::IDLE;
-    }
-  } 
-  // Tombol 2: Menu Subtype / Botol
-  else if (buttons[1].isPressed()) {
-    if (state.appState == AppState::IDLE) {
-      state.appState = AppState::SELECTING_SUBTYPE;
-      showSubtypeSelection(lcd);
-    } else if (state.appState == AppState::SELECTING_SUBTYPE) {
-      state.waste.setType("Anorganik", "Botol");
-      playTone(2500, 100);
-      restoreDefaultDisplay(lcd, state);
-      state.appState = AppState::IDLE;
-    }
-  } 
-  // Tombol 3: Residu / Kertas
-  else if (buttons[2].isPressed()) {
-    if (state.appState == AppState::IDLE) {
-      state.waste.setType("Residu");
-      playTone(2500, 100);
-      restoreDefaultDisplay(lcd, state);
-    } else if (state.appState == AppState::SELECTING_SUBTYPE) {
-      state.waste.setType("Anorganik", "Kertas");
-      playTone(2500, 100);
-      restoreDefaultDisplay(lcd, state);
-      state.appState = AppState::IDLE;
-    }
-  }
+void printFilterStats(const char* args) {
+  app.printStats(args);
 }
 
-void handleSendData() {
-  // Tombol 4: Kirim Data
-  if (state.appState != AppState::IDLE || !buttons[3].isPressed()) return;
-  
-  playTone(2000, 100);
-  
-  if (state.offlineMode) {
-    showStatusMessage(lcd, "Gagal: Offline!");
-    timers.statusMsgTimestamp = millis(); // Set timer agar pesan hilang otomatis
+void calibrate(const char* args) {
+  app.calibrate(args);
+}
+
+void configureProfile(const char* args) {
+  app.configureProfile(args);
+}
+
+void tare(const char* args) {
+  app.tare(args);
+}
+
+void printBootProfile(const char*) {
+  bootProfiler.report();
+}
+
+void printNetStats(const char*) {
+  HttpSessionStats s = getHttpSessionStats();
+  uint32_t fresh = s.requests - s.reused;
+  Serial.printf("HTTPS: post=%lu reuse=%lu connect=%lu stale=%lu gagal=%lu\n",
+                (unsigned long)s.requests, (unsigned long)s.reused, (unsigned long)s.connects,
+                (unsigned long)s.staleRetries, (unsigned long)s.failures);
+  Serial.printf("HTTPS: baru avg=%lums max=%lums | reuse avg=%lums max=%lums\n",
+                (unsigned long)(fresh ? s.freshMsTotal / fresh : 0), (unsigned long)s.freshMsMax,
+                (unsigned long)(s.reused ? s.reusedMsTotal / s.reused : 0), (unsigned long)s.reusedMsMax);
+  const BatchSizer& b = uplink.batchSizer();
+  Serial.printf("BATCH: post=%lu record=%lu | batas=%u/%u RTT~%lums\n",
+                (unsigned long)s.batches, (unsigned long)s.batchRecords, b.limit(),
+                Config::BATCH_MAX_RECORDS, (unsigned long)b.smoothedRttMs());
+  TlsHandshakeStats t = getTlsHandshakeStats();
+  Serial.printf("TLS: penuh=%lu avg=%lums max=%lums | resumed=%lu/%lu avg=%lums max=%lums | gagal=%lu rtc=%d\n",
+                (unsigned long)t.full, (unsigned long)(t.full ? t.fullMsTotal / t.full : 0),
+                (unsigned long)t.fullMsMax, (unsigned long)t.resumed, (unsigned long)t.offered,
+                (unsigned long)(t.resumed ? t.resumedMsTotal / t.resumed : 0),
+                (unsigned long)t.resumedMsMax, (unsigned long)t.failures, t.restoredAtBoot ? 1 : 0);
+  const WifiLink& w = uplink.link();
+  const LinkStats& ls = w.stats();
+  Serial.printf("WIFI: %s join=%lu cepat=%lu gagal=%lu putus=%lu alasan=%u | ke IP avg=%lums max=%lums | ke online avg=%lums max=%lums terakhir=%lums | BSSID cache %s ch%u\n",
+                w.up() ? "up" : "down", (unsigned long)ls.joins, (unsigned long)ls.fastJoins,
+                (unsigned long)ls.failures, (unsigned long)ls.outages, w.lastReason(),
+                (unsigned long)(ls.linkRecovered ? ls.linkMsTotal / ls.linkRecovered : 0), (unsigned long)ls.linkMsMax,
+                (unsigned long)(ls.onlineRecovered ? ls.onlineMsTotal / ls.onlineRecovered : 0),
+                (unsigned long)ls.onlineMsMax, (unsigned long)ls.onlineMsLast,
+                w.hasCachedBss() ? "ya" : "tidak", w.hasCachedBss() ? w.cachedBss().channel : 0);
+  const ReachabilityProbe& p = uplink.probe();
+  const ProbeStats& ps = p.stats();
+  Serial.printf("PROBE: %s:%u %s sukses~%u%% RTT~%lums max=%lums | probe=%lu rst=%lu timeout=%lu | berikut %lus\n",
+                p.host(), p.port(), p.reachable() ? "terjangkau" : "TIDAK terjangkau",
+                p.successPermille() / 10, (unsigned long)p.smoothedRttMs(), (unsigned long)ps.rttMsMax,
+                (unsigned long)ps.probes, (unsigned long)ps.refused, (unsigned long)ps.timeouts,
+                (unsigned long)(p.nextProbeInMs(millis()) / 1000));
+  const MqttStats& m = mqtt.stats();
+  Serial.printf("MQTT: publish=%lu ack=%lu ulang=%lu buang=%lu | antri=%u in-flight=%u | sesi=%lu putus=%lu | ack avg=%lums max=%lums\n",
+                (unsigned long)m.published, (unsigned long)m.acked, (unsigned long)m.retransmits,
+                (unsigned long)m.dropped, (unsigned)mqtt.queued(), (unsigned)mqtt.inFlight(),
+                (unsigned long)m.connects, (unsigned long)m.disconnects,
+                (unsigned long)(m.acked ? m.ackMsTotal / m.acked : 0), (unsigned long)m.ackMsMax);
+}
+
+static uint32_t benchClockUs() {
+  return micros();
+}
+
+void journal(const char* args) {
+  unsigned long count = 0;
+  if (sscanf(args, "bench %lu", &count) != 1 || count == 0) {
+    app.printJournal(args);
     return;
   }
-  
-  if (strcmp(state.waste.jenis, "--") == 0) {
-    showStatusMessage(lcd, "Error: Pilih Jenis!");
-    timers.statusMsgTimestamp = millis();
+  JournalBench b = benchmarkJournal(fileStore, count, benchClockUs);
+  if (!b.ok) {
+    Serial.println("Bench gagal (jurnal penuh / LittleFS error)");
     return;
   }
-  
-  state.appState = AppState::SENDING_DATA;
-  lcd.setCursor(0, 0);
-  lcd.print("Status: Mengirim... ");
-  
-  // Panggil fungsi dari NetworkHandler
-  bool laravelOk = sendToLaravel(state);
-  sendToMQTT(mqttClient, state);
-  
-  if (laravelOk) {
-    showStatusMessage(lcd, "Status: Sukses!");
-    state.waste.reset(); // Reset jenis sampah jika sukses
-  } else {
-    showStatusMessage(lcd, "Status: Gagal!");
-  }
-  
-  timers.statusMsgTimestamp = millis(); // Mulai hitung mundur untuk menghilangkan pesan
-  state.appState = AppState::SHOWING_STATUS;
+  Serial.printf("Jurnal %lu record: append %.0f/s (%luus), replay %.0f/s (%luus)\n",
+                (unsigned long)b.count, b.count * 1e6 / b.appendUs, (unsigned long)(b.appendUs / b.count),
+                b.count * 1e6 / b.replayUs, (unsigned long)(b.replayUs / b.count));
 }
 
-float readSmoothedWeight() {
-  float rawWeight = loadCell.getData();
-  float weightKg = rawWeight / 1000.0f;
-
-  if (weightKg < 0.0) {
-    weightKg = 0.0;
-  }
-  
-  // Noise gate
-  if (abs(weightKg) < Config::NOISE_GATE_THRESHOLD) {
-    weightKg = 0.0f;
+// Decode di host: tools/capture_decode (format frame di CaptureFrame.h)
+void setCaptureMode(const char* args) {
+  if (strcmp(args, "on") == 0) {
+    Serial.println("Capture ON");
+    app.setSampleTap(&captureTap);
+  } else {
+    app.setSampleTap(nullptr);
+    Serial.println("\nCapture OFF");
   }
-  
-  return weightKg;
 }
-
-void playTone(uint16_t freq, uint16_t duration) {
-  tone(Config::PIN_BUZZER, freq, duration);
-}
\ No newline at end of file
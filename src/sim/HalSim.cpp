@@ -0,0 +1,371 @@
+#include "HalSim.h"
+#include <math.h>
+#include <stdarg.h>
+#include <string.h>
+#include "../Config.h"
+#include "../FixedWeight.h"
+#include "TraceFile.h"
+
+// ==================== HX711 BERSKRIP ====================
+
+uint32_t ScriptedSampleSource::durationMs() const {
+  uint32_t total = 0;
+  for (const Segment& s : segments_) total += s.durationMs;
+  return total;
+}
+
+int32_t ScriptedSampleSource::valueAt(uint32_t tMs) {
+  // LCG sederhana agar hasil deterministik antar-run
+  rng_ = rng_ * 1103515245u + 12345u;
+  int32_t uniform = static_cast<int32_t>((rng_ >> 8) & 0xFFFF) - 0x8000;   // -32768..32767
+
+  uint32_t start = 0;
+  for (const Segment& s : segments_) {
+    if (tMs < start + s.durationMs || &s == &segments_.back()) {
+      double local = tMs - start;
+      double swing = 0.0;
+      if (s.swing != 0 && s.swingPeriodMs > 0) {
+        double decay = s.swingHalfLifeMs ? pow(0.5, local / s.swingHalfLifeMs) : 1.0;
+        swing = s.swing * decay * sin(2.0 * M_PI * local / s.swingPeriodMs);
+      }
+      int32_t noise = static_cast<int32_t>(static_cast<int64_t>(uniform) * s.noise / 0x8000);
+      return s.raw + static_cast<int32_t>(lround(swing)) + noise;
+    }
+    start += s.durationMs;
+  }
+  return 0;
+}
+
+bool ScriptedSampleSource::pop(RawSample& out) {
+  if (segments_.empty() || nextUs_ > nowUs_) return false;
+
+  out.timestampUs = static_cast<uint32_t>(nextUs_);
+  out.seq = seq_++;
+  out.raw = valueAt(static_cast<uint32_t>(nextUs_ / 1000));
+  nextUs_ += 1000000 / Config::HX711_SPS;
+  stats_.produced++;
+  stats_.maxGapUs = 1000000 / Config::HX711_SPS;
+  return true;
+}
+
+// ==================== REPLAY TRACE ====================
+
+bool TraceSampleSource::load(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) return false;
+  bool ok = Trace::readHeader(f, sps_);
+  RawSample sample;
+  while (ok && Trace::readRecord(f, sample)) samples_.push_back(sample);
+  fclose(f);
+  return ok && !samples_.empty();
+}
+
+uint32_t TraceSampleSource::durationMs() const {
+  if (samples_.empty()) return 0;
+  return (samples_.back().timestampUs - samples_.front().timestampUs) / 1000;
+}
+
+int32_t TraceSampleSource::averageRaw(size_t count) const {
+  if (count > samples_.size()) count = samples_.size();
+  if (count == 0) return 0;
+  int64_t sum = 0;
+  for (size_t i = 0; i < count; i++) sum += samples_[i].raw;
+  return static_cast<int32_t>(sum / static_cast<int64_t>(count));
+}
+
+bool TraceSampleSource::pop(RawSample& out) {
+  if (next_ >= samples_.size()) return false;
+  // Selisih uint32 tetap benar walau micros() perangkat wrap di tengah rekaman
+  uint32_t offsetUs = samples_[next_].timestampUs - samples_[0].timestampUs;
+  if (offsetUs > nowUs_) return false;
+
+  out = samples_[next_];
+  if (next_ > 0) {
+    const RawSample& prev = samples_[next_ - 1];
+    uint32_t gapUs = out.timestampUs - prev.timestampUs;
+    if (gapUs > stats_.maxGapUs) stats_.maxGapUs = gapUs;
+    if (out.seq - prev.seq > 1) stats_.missed += out.seq - prev.seq - 1;
+  }
+  next_++;
+  stats_.produced++;
+  return true;
+}
+
+// ==================== LCD DI MEMORI ====================
+
+void MemoryLcd::clear() {
+  for (int r = 0; r < ROWS; r++) {
+    memset(text_[r], ' ', COLS);
+    text_[r][COLS] = '\0';
+  }
+}
+
+void MemoryLcd::print(int col, int row, const char* s) {
+  for (int c = col; c < COLS && *s; c++) text_[row][c] = *s++;
+}
+
+void MemoryLcd::showWeight(int32_t weightMg) {
+  // BigNumbers di perangkat memakai 3 baris; di sini cukup teks di baris 1
+  char buffer[10];
+  FixedWeight::formatKg(buffer, sizeof(buffer), weightMg, 6);
+  print(1, 1, buffer);
+}
+
+void MemoryLcd::showDefault(const SystemState& state) {
+  clear();
+  print(0, 0, "Jenis: ");
+  print(7, 0, state.waste.getDisplayName());
+  print(17, 1, "kg");
+}
+
+void MemoryLcd::showSubtypeSelection() {
+  clear();
+  print(2, 0, "Pilih Sub-jenis:");
+  print(0, 1, " 1.Umum     2.Botol");
+  print(0, 2, " 3.Kertas");
+}
+
+void MemoryLcd::showStatusIndicators(bool isOffline, bool mqttConnected) {
+  print(17, 3, isOffline ? "OFF" : "-50");
+  print(0, 3, isOffline ? "x" : (mqttConnected ? " " : "-"));
+}
+
+void MemoryLcd::showStability(bool isStable) {
+  print(19, 1, isStable ? " " : "~");
+}
+
+void MemoryLcd::showStatusMessage(const char* msg) {
+  char line[COLS + 1];
+  snprintf(line, sizeof(line), "%-20.20s", msg);
+  print(0, 0, line);
+}
+
+void MemoryLcd::showLines(const char* r0, const char* r1, const char* r2, const char* r3) {
+  const char* rows[ROWS] = { r0, r1, r2, r3 };
+  clear();
+  for (int r = 0; r < ROWS; r++) {
+    if (rows[r] != nullptr) print(0, r, rows[r]);
+  }
+}
+
+bool MemoryLcd::contains(const char* s) const {
+  for (int r = 0; r < ROWS; r++) {
+    if (strstr(text_[r], s) != nullptr) return true;
+  }
+  return false;
+}
+
+void MemoryLcd::dump(FILE* out) const {
+  fprintf(out, "+--------------------+\n");
+  for (int r = 0; r < ROWS; r++) fprintf(out, "|%s|\n", text_[r]);
+  fprintf(out, "+--------------------+\n");
+}
+
+// ==================== TOMBOL, NETWORK, STORAGE ====================
+
+void VirtualButtons::update() {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    pressed_[i] = queued_[i];
+    queued_[i] = false;
+  }
+}
+
+void LoopbackUplink::maintain(SystemState& state, uint32_t now) {
+  state.offlineMode = !online_;
+  state.isOnline = online_;
+  nowMs_ = now;
+
+  if (!batch_.empty() && static_cast<int32_t>(now - batchDueMs_) >= 0) {
+    const bool committed = online_ && accepts_;
+    const bool replyLost = committed && lostReplyEvery_ != 0 && ++committedBatches_ % lostReplyEvery_ == 0;
+    const bool ok = committed && !replyLost;
+    if (replyLost) lostReplies_++;
+    for (size_t i = 0; i < batch_.size(); i++) {
+      SendResult result;
+      result.id = batch_[i].id;
+      result.record = batch_[i].record;
+      result.ok = ok;
+      result.elapsedMs = now - batchStartMs_;
+      if (committed) {
+        // Dedupe seperti server: satu baris per kunci (deviceId tunggal di simulasi)
+        const uint64_t key = (static_cast<uint64_t>(result.record.bootId) << 32) | result.record.seq;
+        if (keys_.insert(key).second) records_.push_back(result.record);
+        else duplicates_++;
+      }
+      results_.push_back(result);
+    }
+    sizer_.onBatch(static_cast<uint16_t>(batch_.size()), now - batchStartMs_, ok);
+    batch_.clear();
+  }
+
+  if (batch_.empty() && !queued_.empty()) {
+    const size_t limit = sizer_.limit();
+    if (queued_.size() < limit && now - queued_.front().enqueuedMs < Config::BATCH_LINGER_MS) return;
+    while (!queued_.empty() && batch_.size() < limit) {
+      batch_.push_back(queued_.front());
+      queued_.pop_front();
+    }
+    if (batch_.size() > largestBatch_) largestBatch_ = static_cast<uint16_t>(batch_.size());
+    batchStartMs_ = now;
+    batchDueMs_ = now + latencyMs_ + perRecordMs_ * static_cast<uint32_t>(batch_.size());
+  }
+}
+
+uint32_t LoopbackUplink::enqueue(const WeighingRecord& record) {
+  if (pending() >= Config::SEND_QUEUE_SIZE) return 0;
+  Job job = { nextId_++, nowMs_, record };
+  queued_.push_back(job);
+  return job.id;
+}
+
+bool LoopbackUplink::pollResult(SendResult& out) {
+  if (results_.empty()) return false;
+  out = results_.front();
+  results_.pop_front();
+  return true;
+}
+
+int32_t MemoryStorage::getInt(const char* key, int32_t defaultValue) {
+  std::map<std::string, int32_t>::const_iterator it = values_.find(key);
+  return it == values_.end() ? defaultValue : it->second;
+}
+
+bool MemoryStorage::putInt(const char* key, int32_t value) {
+  values_[key] = value;
+  return true;
+}
+
+bool MemoryStorage::getBlob(const char* key, void* out, size_t len) {
+  std::map<std::string, std::vector<uint8_t> >::const_iterator it = blobs_.find(key);
+  if (it == blobs_.end() || it->second.size() != len) return false;
+  memcpy(out, it->second.data(), len);
+  return true;
+}
+
+bool MemoryStorage::putBlob(const char* key, const void* data, size_t len) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  blobs_[key].assign(bytes, bytes + len);
+  return true;
+}
+
+bool MemoryStorage::remove(const char* key) {
+  values_.erase(key);
+  blobs_.erase(key);
+  return true;
+}
+
+int32_t MemoryFileStore::size(const char* path) {
+  std::map<std::string, std::vector<uint8_t> >::const_iterator it = files_.find(path);
+  return it == files_.end() ? -1 : static_cast<int32_t>(it->second.size());
+}
+
+bool MemoryFileStore::append(const char* path, const void* data, size_t len) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  std::vector<uint8_t>& file = files_[path];
+  file.insert(file.end(), bytes, bytes + len);
+  return true;
+}
+
+bool MemoryFileStore::read(const char* path, uint32_t offset, void* out, size_t len) {
+  std::map<std::string, std::vector<uint8_t> >::const_iterator it = files_.find(path);
+  if (it == files_.end() || offset + len > it->second.size()) return false;
+  memcpy(out, it->second.data() + offset, len);
+  return true;
+}
+
+bool MemoryFileStore::truncate(const char* path, uint32_t len) {
+  std::map<std::string, std::vector<uint8_t> >::iterator it = files_.find(path);
+  if (it == files_.end() || len > it->second.size()) return false;
+  it->second.resize(len);
+  return true;
+}
+
+bool MemoryFileStore::remove(const char* path) {
+  files_.erase(path);
+  return true;
+}
+
+bool MemoryFileStore::flipBits(const char* path, uint32_t offset, uint8_t mask) {
+  std::map<std::string, std::vector<uint8_t> >::iterator it = files_.find(path);
+  if (it == files_.end() || offset >= it->second.size()) return false;
+  it->second[offset] ^= mask;
+  return true;
+}
+
+// ==================== WIFI ====================
+
+void ScriptedWifiRadio::schedule(uint32_t delayMs, EventType type, uint8_t reason) {
+  Pending p;
+  p.atMs = nowMs_ + delayMs;
+  p.event.type = type;
+  p.event.reason = reason;
+  pending_.push_back(p);
+}
+
+void ScriptedWifiRadio::advanceTo(uint32_t now) {
+  nowMs_ = now;
+  // Urut sesuai jadwal (pending_ kecil, cukup pindai)
+  for (;;) {
+    size_t due = pending_.size();
+    for (size_t i = 0; i < pending_.size(); i++) {
+      if (static_cast<int32_t>(now - pending_[i].atMs) >= 0 && (due == pending_.size() || pending_[i].atMs < pending_[due].atMs)) due = i;
+    }
+    if (due == pending_.size()) return;
+    Event ev = pending_[due].event;
+    pending_.erase(pending_.begin() + due);
+    if (ev.type == EventType::ASSOCIATED) associated_ = true;
+    if (ev.type == EventType::GOT_IP) hasIp_ = true;
+    if (ev.type == EventType::DISCONNECTED) associated_ = hasIp_ = false;
+    ready_.push_back(ev);
+  }
+}
+
+void ScriptedWifiRadio::setAp(bool up, uint32_t now, uint8_t channel) {
+  nowMs_ = now;
+  apUp_ = up;
+  if (channel != 0) ap_.channel = channel;
+  if (!up) {
+    // Join yang sedang berjalan tidak akan selesai; link aktif putus setelah beacon timeout
+    bool wasLinked = associated_ || !pending_.empty();
+    pending_.clear();
+    if (wasLinked) schedule(associated_ ? beaconLossMs : 0, EventType::DISCONNECTED,
+                            associated_ ? REASON_BEACON_TIMEOUT : REASON_NO_AP_FOUND);
+  }
+}
+
+void ScriptedWifiRadio::join(const Bss* hint) {
+  joinTimes_.push_back(nowMs_);
+  joinHinted_.push_back(hint != nullptr);
+  pending_.clear();
+  associated_ = hasIp_ = false;
+  const bool hintOk = hint != nullptr && hint->channel == ap_.channel && memcmp(hint->bssid, ap_.bssid, 6) == 0;
+  const uint32_t findMs = hint != nullptr ? assocMs / 2 : scanMs;
+  if (!apUp_ || (hint != nullptr && !hintOk)) {
+    schedule(findMs, EventType::DISCONNECTED, REASON_NO_AP_FOUND);
+    return;
+  }
+  schedule(findMs + assocMs, EventType::ASSOCIATED);
+  schedule(findMs + assocMs + dhcpMs, EventType::GOT_IP);
+}
+
+bool ScriptedWifiRadio::pollEvent(Event& out) {
+  if (ready_.empty()) return false;
+  out = ready_.front();
+  ready_.pop_front();
+  return true;
+}
+
+bool ScriptedWifiRadio::currentBss(Bss& out) {
+  if (!associated_) return false;
+  out = ap_;
+  return true;
+}
+
+// ==================== LOG ====================
+
+void logPrintf(const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+}
@@ -0,0 +1,308 @@
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include <stdio.h>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "../Hal.h"
+#include "../BatchSizer.h"
+#include "../Config.h"
+
+// ==================== IMPLEMENTASI HAL SIMULASI ====================
+// Pengganti perangkat untuk env 'native' (Linux). Semua berbasis waktu
+// virtual (ms) yang dimajukan oleh runner, jadi state machine dan jalur
+// berat bisa dijalankan secepat CPU host tanpa board.
+
+// HX711 berskrip: daftar segmen beban, konversi dihasilkan pada Config::HX711_SPS
+class ScriptedSampleSource : public Hal::SampleSource {
+public:
+  struct Segment {
+    uint32_t durationMs;
+    int32_t raw;            // nilai raw rata-rata (sudah termasuk offset nol sel)
+    int32_t noise;          // amplitudo noise uniform +/- (count)
+    int32_t swing;          // amplitudo ayunan awal (count), meluruh setengah tiap swingHalfLifeMs
+    uint32_t swingPeriodMs;
+    uint32_t swingHalfLifeMs;
+  };
+
+  explicit ScriptedSampleSource(uint32_t seed = 1) : rng_(seed) {}
+
+  void add(const Segment& segment) { segments_.push_back(segment); }
+  uint32_t durationMs() const;
+
+  // Majukan waktu virtual; konversi yang jatuh tempo siap di-pop
+  void advanceTo(uint32_t nowMs) { nowUs_ = static_cast<uint64_t>(nowMs) * 1000; }
+
+  bool pop(RawSample& out) override;
+  AcquisitionStats stats() override { return stats_; }
+
+private:
+  int32_t valueAt(uint32_t tMs);
+
+  std::vector<Segment> segments_;
+  uint64_t nowUs_ = 0;
+  uint64_t nextUs_ = 0;
+  uint32_t seq_ = 0;
+  uint32_t rng_;
+  AcquisitionStats stats_ = {};
+};
+
+// Replay file trace (.estr, lihat TraceFile.h) pada cap waktu aslinya
+class TraceSampleSource : public Hal::SampleSource {
+public:
+  bool load(const char* path);
+  uint32_t durationMs() const;
+  // Rata-rata raw 'count' konversi pertama (tare seperti saat boot)
+  int32_t averageRaw(size_t count) const;
+  uint16_t sps() const { return sps_; }
+
+  // Waktu virtual 0 = sampel pertama di trace
+  void advanceTo(uint32_t nowMs) { nowUs_ = static_cast<uint64_t>(nowMs) * 1000; }
+
+  bool pop(RawSample& out) override;
+  AcquisitionStats stats() override { return stats_; }
+
+private:
+  std::vector<RawSample> samples_;
+  size_t next_ = 0;
+  uint64_t nowUs_ = 0;
+  uint16_t sps_ = 0;
+  AcquisitionStats stats_ = {};
+};
+
+// LCD 20x4 di memori; tata letak meniru DisplayHandler
+class MemoryLcd : public Hal::Display {
+public:
+  static constexpr int COLS = 20;
+  static constexpr int ROWS = 4;
+
+  MemoryLcd() { clear(); }
+
+  void showWeight(int32_t weightMg) override;
+  void showDefault(const SystemState& state) override;
+  void showSubtypeSelection() override;
+  void showStatusIndicators(bool isOffline, bool mqttConnected) override;
+  void showStability(bool isStable) override;
+  void showStatusMessage(const char* msg) override;
+  void showLines(const char* r0, const char* r1, const char* r2, const char* r3) override;
+
+  const char* row(int r) const { return text_[r]; }
+  bool contains(const char* s) const;
+  void dump(FILE* out) const;
+
+private:
+  void clear();
+  void print(int col, int row, const char* s);
+
+  char text_[ROWS][COLS + 1];
+};
+
+// Tombol virtual: press() dijadwalkan, terlihat sebagai edge pada update() berikutnya;
+// hold() mengatur level tombol yang ditahan
+class VirtualButtons : public Hal::Buttons {
+public:
+  void press(uint8_t index) { if (index < COUNT) queued_[index] = true; }
+  void hold(uint8_t index, bool down) { if (index < COUNT) down_[index] = down; }
+  void update() override;
+  bool isPressed(uint8_t index) override { return index < COUNT && pressed_[index]; }
+  bool isDown(uint8_t index) override { return index < COUNT && down_[index]; }
+
+private:
+  bool queued_[COUNT] = {};
+  bool pressed_[COUNT] = {};
+  bool down_[COUNT] = {};
+};
+
+class SilentBuzzer : public Hal::Buzzer {
+public:
+  void tone(uint16_t, uint16_t) override { beeps_++; }
+  uint32_t beeps() const { return beeps_; }
+
+private:
+  uint32_t beeps_ = 0;
+};
+
+// Upload tiruan, meniru worker jaringan di perangkat pada waktu virtual
+// (dimajukan oleh maintain()): record antri digabung jadi batch (maks
+// BatchSizer::limit(), tunggu BATCH_LINGER_MS), satu batch selesai
+// latencyMs + perRecordMs x jumlah record setelah mulai dikirim.
+class LoopbackUplink : public Hal::Uplink {
+public:
+  void setOnline(bool online) { online_ = online; }
+  void setServerAccepts(bool accepts) { accepts_ = accepts; }
+  void setLatency(uint32_t ms) { latencyMs_ = ms; }
+  void setPerRecordLatency(uint32_t ms) { perRecordMs_ = ms; }
+  // Ukuran batch tetap (tanpa adaptasi RTT), untuk membandingkan ukuran batch
+  void setFixedBatch(uint16_t records) { sizer_ = BatchSizer(records, UINT32_MAX, records); }
+  // Setiap batch ke-'every' disimpan server tapi balasannya hilang (timeout
+  // di perangkat, record dikirim ulang). 0 = balasan selalu sampai.
+  void setLostReplyEvery(uint32_t every) { lostReplyEvery_ = every; }
+  void setMqttQueueFull(bool full) { mqttQueueFull_ = full; }
+
+  void maintain(SystemState& state, uint32_t now) override;
+  bool mqttConnected() override { return online_; }
+  // Feed live: masuk antrean (MqttPublisher yang menahan saat offline),
+  // kecuali setMqttQueueFull(true) meniru antrean MQTT yang penuh
+  bool publish(uint32_t, const WeighingRecord& record) override {
+    if (mqttQueueFull_) return false;
+    published_.push_back(record);
+    return true;
+  }
+  uint32_t enqueue(const WeighingRecord& record) override;
+  bool pollResult(SendResult& out) override;
+  size_t pending() override { return queued_.size() + batch_.size(); }
+
+  // Baris yang disimpan server: record dengan kunci (bootId, seq) yang sudah
+  // ada tidak disimpan lagi, hanya dihitung di duplicates()
+  const std::vector<WeighingRecord>& records() const { return records_; }
+  uint32_t duplicates() const { return duplicates_; }
+  uint32_t lostReplies() const { return lostReplies_; }
+  const std::vector<WeighingRecord>& published() const { return published_; }
+  const BatchSizer& batchSizer() const { return sizer_; }
+  uint16_t largestBatch() const { return largestBatch_; }
+
+private:
+  struct Job {
+    uint32_t id;
+    uint32_t enqueuedMs;
+    WeighingRecord record;
+  };
+
+  bool online_ = true;
+  bool accepts_ = true;
+  bool mqttQueueFull_ = false;
+  uint32_t latencyMs_ = 0;
+  uint32_t perRecordMs_ = 0;
+  uint32_t nowMs_ = 0;
+  uint32_t nextId_ = 1;
+  BatchSizer sizer_{Config::BATCH_MAX_RECORDS, Config::BATCH_TARGET_MS};
+  std::deque<Job> queued_;
+  std::vector<Job> batch_;
+  uint32_t batchStartMs_ = 0;
+  uint32_t batchDueMs_ = 0;
+  uint16_t largestBatch_ = 0;
+  uint32_t lostReplyEvery_ = 0;
+  uint32_t committedBatches_ = 0;
+  uint32_t lostReplies_ = 0;
+  uint32_t duplicates_ = 0;
+  std::set<uint64_t> keys_;
+  std::deque<SendResult> results_;
+  std::vector<WeighingRecord> records_;
+  std::vector<WeighingRecord> published_;
+};
+
+// AP tiruan untuk WifiLink. Durasi meniru ESP32: scan semua kanal jauh lebih
+// lama dari join langsung ke BSSID/kanal; DHCP bisa dilewati (IP statis).
+// AP mati terdeteksi setelah beaconLossMs (beacon timeout).
+class ScriptedWifiRadio : public Hal::WifiRadio {
+public:
+  static constexpr uint8_t REASON_BEACON_TIMEOUT = 200;
+  static constexpr uint8_t REASON_NO_AP_FOUND = 201;
+
+  uint32_t scanMs = 2200;       // scan penuh 13 kanal
+  uint32_t assocMs = 150;       // auth + assoc + 4-way handshake
+  uint32_t dhcpMs = 900;
+  uint32_t beaconLossMs = 3000;
+
+  void advanceTo(uint32_t now);
+  // AP mati / hidup lagi (boleh di kanal lain)
+  void setAp(bool up, uint32_t now, uint8_t channel = 0);
+
+  void join(const Bss* hint) override;
+  bool pollEvent(Event& out) override;
+  bool currentBss(Bss& out) override;
+
+  bool linkUp() const { return hasIp_; }
+  // Waktu mulai setiap join() dan apakah pakai hint (jadwal backoff)
+  const std::vector<uint32_t>& joinTimes() const { return joinTimes_; }
+  const std::vector<bool>& joinHinted() const { return joinHinted_; }
+
+private:
+  struct Pending {
+    uint32_t atMs;
+    Event event;
+  };
+  void schedule(uint32_t delayMs, EventType type, uint8_t reason = 0);
+
+  uint32_t nowMs_ = 0;
+  bool apUp_ = true;
+  Bss ap_ = { { 0x24, 0x0A, 0xC4, 0x11, 0x22, 0x33 }, 6 };
+  bool associated_ = false;
+  bool hasIp_ = false;
+  std::vector<Pending> pending_;
+  std::deque<Event> ready_;
+  std::vector<uint32_t> joinTimes_;
+  std::vector<bool> joinHinted_;
+};
+
+// Server tiruan untuk ReachabilityProbe: tiap connect selesai setelah
+// 'latencyMs' sesuai mode (ACCEPT = SYN-ACK, REFUSE = RST, BLACKHOLE = tidak
+// pernah dijawab). Waktu dimajukan lewat advanceTo().
+class ScriptedConnector : public Hal::Connector {
+public:
+  enum class Mode : uint8_t { ACCEPT, REFUSE, BLACKHOLE };
+
+  void setMode(Mode mode, uint32_t latencyMs = 0) {
+    mode_ = mode;
+    latencyMs_ = latencyMs;
+  }
+  void advanceTo(uint32_t now) { nowMs_ = now; }
+
+  bool start(const char*, uint16_t) override {
+    open_ = true;
+    startedMs_ = nowMs_;
+    starts_.push_back(nowMs_);
+    return true;
+  }
+  Status poll() override {
+    if (!open_ || mode_ == Mode::BLACKHOLE || nowMs_ - startedMs_ < latencyMs_) return Status::PENDING;
+    return mode_ == Mode::ACCEPT ? Status::CONNECTED : Status::FAILED;
+  }
+  void close() override { open_ = false; }
+
+  // Waktu mulai setiap probe (untuk memeriksa jadwal backoff)
+  const std::vector<uint32_t>& starts() const { return starts_; }
+
+private:
+  Mode mode_ = Mode::ACCEPT;
+  uint32_t latencyMs_ = 0;
+  uint32_t nowMs_ = 0;
+  uint32_t startedMs_ = 0;
+  bool open_ = false;
+  std::vector<uint32_t> starts_;
+};
+
+class MemoryStorage : public Hal::Storage {
+public:
+  int32_t getInt(const char* key, int32_t defaultValue) override;
+  bool putInt(const char* key, int32_t value) override;
+  bool getBlob(const char* key, void* out, size_t len) override;
+  bool putBlob(const char* key, const void* data, size_t len) override;
+  bool remove(const char* key) override;
+
+private:
+  std::map<std::string, int32_t> values_;
+  std::map<std::string, std::vector<uint8_t> > blobs_;
+};
+
+// "Flash" di memori; isi bertahan selama objek hidup, jadi beberapa
+// ScaleApp berurutan pada store yang sama meniru reboot
+class MemoryFileStore : public Hal::FileStore {
+public:
+  int32_t size(const char* path) override;
+  bool append(const char* path, const void* data, size_t len) override;
+  bool read(const char* path, uint32_t offset, void* out, size_t len) override;
+  bool truncate(const char* path, uint32_t len) override;
+  bool remove(const char* path) override;
+
+  // Balik bit pada byte 'offset' (kerusakan flash). Return false jika di luar file.
+  bool flipBits(const char* path, uint32_t offset, uint8_t mask);
+
+private:
+  std::map<std::string, std::vector<uint8_t> > files_;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef TRACE_FILE_H
+#define TRACE_FILE_H
+
+#include <stdio.h>
+#include <string.h>
+#include "../CaptureFrame.h"
+
+// ==================== FILE TRACE (.estr) ====================
+// Rekaman konversi HX711 untuk di-replay di host (env native).
+//
+//   header 8 byte : "ESTR", versi (1 byte), reserved (1 byte), SPS (uint16 LE)
+//   record 12 byte: seq (uint32 LE), timestamp us (uint32 LE), raw (int32 LE)
+//
+// Ditulis oleh tools/capture_decode dari stream capture, dibaca oleh
+// TraceSampleSource (HalSim.h) untuk replay deterministik.
+
+namespace Trace {
+
+  constexpr uint8_t VERSION = 1;
+  constexpr size_t HEADER_SIZE = 8;
+  constexpr size_t RECORD_SIZE = 12;
+
+  inline bool writeHeader(FILE* f, uint16_t sps) {
+    uint8_t h[HEADER_SIZE] = { 'E', 'S', 'T', 'R', VERSION, 0, 0, 0 };
+    Capture::putLe(h + 6, sps, 2);
+    return fwrite(h, 1, sizeof(h), f) == sizeof(h);
+  }
+
+  inline bool writeRecord(FILE* f, const RawSample& s) {
+    uint8_t r[RECORD_SIZE];
+    Capture::putLe(r, s.seq, 4);
+    Capture::putLe(r + 4, s.timestampUs, 4);
+    Capture::putLe(r + 8, static_cast<uint32_t>(s.raw), 4);
+    return fwrite(r, 1, sizeof(r), f) == sizeof(r);
+  }
+
+  // Return false jika bukan file trace yang dikenal
+  inline bool readHeader(FILE* f, uint16_t& sps) {
+    uint8_t h[HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), f) != sizeof(h)) return false;
+    if (memcmp(h, "ESTR", 4) != 0 || h[4] != VERSION) return false;
+    sps = static_cast<uint16_t>(Capture::getLe(h + 6, 2));
+    return true;
+  }
+
+  inline bool readRecord(FILE* f, RawSample& s) {
+    uint8_t r[RECORD_SIZE];
+    if (fread(r, 1, sizeof(r), f) != sizeof(r)) return false;
+    s.seq = Capture::getLe(r, 4);
+    s.timestampUs = Capture::getLe(r + 4, 4);
+    s.raw = static_cast<int32_t>(Capture::getLe(r + 8, 4));
+    return true;
+  }
+}
+
+#endif
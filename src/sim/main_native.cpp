@@ -0,0 +1,1519 @@
+// ==================== RUNNER SIMULASI (ENV NATIVE) ====================
+// Menjalankan ScaleApp + WeighingPipeline dengan HAL simulasi pada waktu
+// virtual 1 ms per tick, secepat CPU host:
+//   pio run -e native && .pio/build/native/program
+// Skenario: timbangan kosong -> pilih Organik -> kantong 5.2 kg diletakkan
+// dan berayun -> tekan kirim saat masih berayun (harus ditolak) -> tekan
+// kirim setelah stabil (langsung "Simpan" ke jurnal, upload 3 s menyusul di
+// latar belakang sementara timbangan tetap jalan) -> kantong diangkat.
+// Skenario kedua: tombol 4 ditahan saat boot -> menu maintenance -> ganti
+// profil lokasi -> profil & faktor tersimpan dan dipakai setelah "reboot".
+// Skenario ketiga: boot dengan kantong tertinggal di timbangan dan titik nol
+// sedikit bergeser -> berat langsung tersedia dari tare tersimpan -> re-tare
+// ditolak selama kantong ada, diterima setelah diangkat.
+// Skenario keempat: tombol 1+3 ditahan -> kalibrasi sekuensial dengan beban
+// acuan 1000 g -> berhenti sendiri begitu CI cukup sempit -> simpan ->
+// kalibrasi ulang dengan 'tare' console di tengah fase beban -> faktor tetap.
+// Skenario kelima: tiga kantong ditimbang saat offline -> tersimpan di jurnal
+// -> reboot (dengan ekor jurnal rusak) -> online, server sempat menolak ->
+// terkirim berurutan tanpa duplikat -> reboot lagi tidak mengirim ulang.
+// Entri rusak di tengah jurnal dilewati tanpa membuang entri sesudahnya.
+// Diakhiri laju append & replay jurnal di host.
+// Skenario keenam: backlog 48 record dikuras dengan batch tetap 1..16 dan
+// batch adaptif; dicetak record/detik per ukuran batch.
+// Skenario ketujuh: record biner (RecordCodec) bolak-balik untuk semua jenis
+// & fakultas, frame rusak ditolak; ukuran & waktu encode dibandingkan dengan
+// JSON MQTT dan form POST yang dipakai firmware.
+// Skenario kedelapan: probe keterjangkauan server -> online setelah satu
+// connect sukses -> server hilang (tanpa jawaban) -> offline setelah dua
+// timeout, backoff 1, 2, 4, ... 60 s -> server kembali -> online lagi.
+// Skenario kesembilan: WiFi berbasis event -> boot tanpa / dengan BSSID cache
+// dan IP statis -> AP restart dibandingkan dengan polling 15 s lama -> AP
+// pindah kanal -> jitter backoff saat AP mati lama.
+// Skenario kesepuluh: record idempoten (bootId, seq) -> server menyimpan tapi
+// balasan hilang (timeout) setiap beberapa batch, reboot di tengah kiriman,
+// entri jurnal format lama, jurnal dihapus di tengah boot (seq mulai dari 1
+// lagi, boot ID baru) -> setiap penimbangan tersimpan tepat sekali di server.
+// Skenario kesebelas: Hx711::readWord() pada model pin DOUT/SCK -> sign
+// extension 24 bit, jumlah pulsa gain 25/26/27, SCK tidak pernah cukup lama
+// HIGH untuk power-down, power-down & bangun dengan settling 50 ms.
+// Skenario kedua belas: micro-benchmark preset filter (Responsive, Standard,
+// Adaptive, Heavy) -> ns/sampel di host dan waktu settle setelah kantong
+// 5.2 kg diletakkan (dengan noise & spike), dibatasi FILTER_SETTLE_BOUND_MS.
+// Skenario ketiga belas: auto-zero pada trace drift 4 jam (suhu harian +
+// creep, kantong ditimbang tiap 20 menit) -> sisa error nol tetap di bawah
+// AZT_ZERO_BAND_MG; beban yang ditambahkan pelan-pelan tidak ikut di-nol-kan.
+// Skenario keempat belas: antrean MQTT penuh saat menimbang -> record diulang
+// dari jurnal berurutan begitu antrean lega; record yang keburu di-ack Laravel
+// dihitung hilang dan tampil di LCD.
+// Skenario kelima belas: RunningStats / P2Quantile (statistik noise) vs
+// hitungan dua-pass & kuantil array terurut pada 20000 sampel Gaussian +
+// spike dan uniform.
+// Exit code != 0 jika hasil tidak sesuai, jadi bisa dipakai di CI.
+//
+// Replay rekaman nyata (file .estr dari tools/capture_decode):
+//   .pio/build/native/program --replay trace.estr [out.csv]
+// Setiap konversi melewati WeighingPipeline yang sama dengan firmware;
+// CSV berisi seq,timestamp_us,raw,filtered_mg,stable,stable_mg.
+//
+// Bandingkan kalibrasi faktor tunggal vs multi-titik pada rekaman beban acuan:
+//   .pio/build/native/program --cal-eval trace.estr 0,1000,5000,10000,20000,50000
+// Gram acuan dicocokkan berurutan dengan plateau stabil di trace. Faktor
+// tunggal dihitung dari plateau terdekat 1000 g (seperti kalibrasi-baru.cpp);
+// error multi-titik dihitung leave-one-out (titik yang diuji tidak ikut tabel).
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "HalSim.h"
+#include "../ScaleApp.h"
+#include "../RecordCodec.h"
+#include "../ReachabilityProbe.h"
+#include "../WifiLink.h"
+#include "../CaptureFrame.h"
+#include "../DeviceProfile.h"
+#include "../FixedWeight.h"
+#include "../Settings.h"
+#include "../Hx711SimPins.h"
+#include "../WeightFilters.h"
+#include "../StreamingStats.h"
+
+namespace {
+
+  struct ButtonEvent {
+    uint32_t atMs;
+    uint8_t index;
+    const char* label;
+  };
+
+  constexpr int32_t CELL_ZERO_RAW = 84000;               // offset nol sel beban (count)
+  constexpr int32_t BAG_MG = 5200000;                    // 5.2 kg
+  constexpr int32_t BAG_RAW = static_cast<int32_t>(BAG_MG / 1000.0 * Config::CALIBRATION_VALUE + 0.5);
+  constexpr int32_t ACCEPT_ERROR_MG = 10000;             // 1 digit layar
+
+  // Perangkat di sekeliling ScaleApp (layar, tombol, buzzer, uplink, flash)
+  struct AppRig {
+    MemoryLcd lcd;
+    VirtualButtons buttons;
+    SilentBuzzer buzzer;
+    LoopbackUplink uplink;
+    MemoryFileStore files;
+  };
+
+  int failures = 0;
+
+  void expect(bool ok, const char* what) {
+    printf("[%s] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+  }
+}
+
+static int runBagDropScenario() {
+  ScriptedSampleSource source(42);
+  //            durasi  raw                     noise swing period halfLife
+  source.add({  3000, CELL_ZERO_RAW,            60,   0,    0,     0   });
+  source.add({  6000, CELL_ZERO_RAW + BAG_RAW,  60,   4000, 700,   400 });
+  source.add({  3000, CELL_ZERO_RAW,            60,   0,    0,     0   });
+
+  AppRig rig;
+  rig.uplink.setLatency(3000);
+  int startFailures = failures;
+  ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+
+  const ButtonEvent events[] = {
+    {  500, 0, "Organik" },
+    { 3200, 3, "Kirim (masih berayun)" },
+    { 7000, 3, "Kirim (stabil)" },
+  };
+  size_t nextEvent = 0;
+
+  app.begin(0);
+  app.showMainScreen();
+
+  bool rejectedWhileSwinging = false;
+  bool queuedInstantly = false;
+  bool weighingDuringUpload = false;
+  uint32_t sentAtMs = 0;
+  uint32_t stableAtMs = 0;
+  const uint32_t endMs = source.durationMs();
+  auto wallStart = std::chrono::steady_clock::now();
+
+  for (uint32_t now = 0; now <= endMs; now++) {
+    if (nextEvent < sizeof(events) / sizeof(events[0]) && events[nextEvent].atMs == now) {
+      printf("t=%5lums tombol %u: %s\n", (unsigned long)now, events[nextEvent].index + 1, events[nextEvent].label);
+      rig.buttons.press(events[nextEvent].index);
+      nextEvent++;
+    }
+
+    source.advanceTo(now);
+    app.tick(now);
+
+    if (now == 3201) {
+      rejectedWhileSwinging = rig.lcd.contains("Tunggu: Blm Stabil");
+      rig.lcd.dump(stdout);
+    }
+    if (now > 3000 && stableAtMs == 0 && app.state().isStable) stableAtMs = now;
+    if (now == 7001) {
+      rig.lcd.dump(stdout);
+      queuedInstantly = rig.lcd.contains("Simpan #1") && app.state().appState == AppState::IDLE;
+    }
+    // Kantong diangkat di t=9000 saat upload masih berjalan: berat harus ikut turun
+    if (now == 9900) weighingDuringUpload = rig.uplink.records().empty() && app.state().currentWeightMg < 10000;
+    if (sentAtMs == 0 && rig.lcd.contains("Terkirim #1")) sentAtMs = now;
+  }
+
+  double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+  rig.lcd.dump(stdout);
+  app.printStats(nullptr);
+
+  printf("Stabil %lums setelah beban diletakkan\n", (unsigned long)(stableAtMs - 3000));
+  printf("Simulasi %lums selesai dalam %.1fms waktu host\n", (unsigned long)endMs, wallMs);
+
+  expect(rejectedWhileSwinging, "kirim ditolak selama kantong berayun");
+  expect(queuedInstantly, "kirim langsung diakui \"Simpan\" tanpa menunggu upload");
+  expect(weighingDuringUpload, "timbangan tetap berjalan selama upload");
+  expect(sentAtMs >= 10000, "hasil upload muncul setelah latensi upload");
+  expect(stableAtMs > 3000 && stableAtMs < 7000, "stabil sebelum tombol kirim kedua");
+  expect(rig.uplink.records().size() == 1, "tepat satu record terkirim");
+  if (!rig.uplink.records().empty()) {
+    const WeighingRecord& r = rig.uplink.records()[0];
+    printf("Record: %ld mg, fakultas=%s, jenis=%s\n", (long)r.weightMg, r.fakultas, r.jenis);
+    expect(abs(r.weightMg - BAG_MG) <= ACCEPT_ERROR_MG, "berat record dalam 1 digit dari 5.2 kg");
+  }
+  expect(app.state().currentWeightMg == 0, "kembali ke nol setelah kantong diangkat");
+
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runMaintenanceScenario() {
+  AppRig rig;
+  ScriptedSampleSource source(7);
+  source.add({ 2000, CELL_ZERO_RAW, 60, 0, 0, 0 });
+
+  int startFailures = failures;
+  {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    rig.buttons.hold(3, true);
+    app.begin(0);
+    rig.buttons.hold(3, false);
+    app.showMainScreen();
+    expect(rig.lcd.contains("MAINTENANCE: PROFIL"), "tombol 4 saat boot membuka menu maintenance");
+
+    // Preset awal = indeks 0 (profil default kustom), geser ke FT lalu simpan
+    rig.buttons.press(1);
+    app.tick(10);
+    rig.buttons.press(2);
+    app.tick(20);
+    rig.lcd.dump(stdout);
+    expect(strcmp(app.state().fakultas, "FT") == 0, "fakultas berganti ke FT");
+    expect(app.state().appState == AppState::IDLE, "kembali ke layar utama");
+  }
+  {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    app.begin(0);
+    expect(strcmp(app.state().fakultas, "FT") == 0, "profil FT dimuat setelah reboot");
+    expect(abs(app.pipeline().calibration().toMg(12244) - 1000000) < 100, "faktor FT dipakai (12244 count = 1000 g)");
+    app.calibrate("reset");
+    expect(abs(app.pipeline().calibration().toMg(12244) - 1000000) < 100, "'cal reset' kembali ke faktor profil FT");
+  }
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runFastBootScenario() {
+  constexpr int32_t DRIFT_RAW = 150;                     // ~12 g, di luar jangkauan auto-zero
+  constexpr int32_t LEFT_BAG_MG = 2000000;
+
+  AppRig rig;
+  ScriptedSampleSource source(23);
+  ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+
+  int startFailures = failures;
+  app.begin(0);
+  app.showMainScreen();
+  const int32_t savedTare = app.pipeline().tareOffset();
+  const int32_t bagRaw = app.pipeline().calibration().toNet(LEFT_BAG_MG);
+  source.add({ 4000, savedTare + DRIFT_RAW + bagRaw, 60, 0, 0, 0 });
+  source.add({ 4000, savedTare + DRIFT_RAW,          60, 0, 0, 0 });
+
+  uint32_t firstWeightMs = 0;
+  for (uint32_t now = 0; now <= source.durationMs(); now++) {
+    source.advanceTo(now);
+    app.tick(now);
+    if (firstWeightMs == 0 && abs(app.state().currentWeightMg - LEFT_BAG_MG) < 20000) firstWeightMs = now;
+    if (now == 3999) expect(app.pipeline().tarePending(), "re-tare ditolak selama kantong di timbangan");
+  }
+  printf("Berat kantong tersedia %lums setelah boot, tare %ld -> %ld\n", (unsigned long)firstWeightMs,
+         (long)savedTare, (long)app.pipeline().tareOffset());
+  expect(firstWeightMs > 0 && firstWeightMs < 500, "berat tersedia < 500 ms setelah boot dari tare tersimpan");
+  expect(!app.pipeline().tarePending(), "re-tare diterima setelah kantong diangkat");
+  expect(abs(app.pipeline().tareOffset() - (savedTare + DRIFT_RAW)) < 20, "tare baru menyerap drift");
+  expect(app.state().currentWeightMg == 0, "layar kembali ke nol");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runCalibrationScenario() {
+  constexpr double TRUE_FACTOR = 12.40;                  // count per gram sel beban simulasi
+  const int32_t refRaw = static_cast<int32_t>(settings.calibration.referenceGrams * TRUE_FACTOR + 0.5);
+
+  AppRig rig;
+  ScriptedSampleSource source(11);
+  source.add({  6000, CELL_ZERO_RAW,          60, 0,    0,   0   });
+  source.add({ 40000, CELL_ZERO_RAW + refRaw, 60, 3000, 700, 400 });
+
+  int startFailures = failures;
+  ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+  app.begin(0);
+  app.showMainScreen();
+
+  uint32_t doneAtMs = 0;
+  for (uint32_t now = 0; now <= source.durationMs() && doneAtMs == 0; now++) {
+    if (now == 500) { rig.buttons.hold(0, true); rig.buttons.hold(2, true); rig.buttons.press(0); rig.buttons.press(2); }
+    if (now == 2600) { rig.buttons.hold(0, false); rig.buttons.hold(2, false); }
+    source.advanceTo(now);
+    app.tick(now);
+    if (now == 2600) expect(app.state().appState == AppState::CALIBRATING, "tombol 1+3 ditahan 2 detik membuka kalibrasi");
+    if (rig.lcd.contains("KALIBRASI SELESAI") || rig.lcd.contains("KALIBRASI GAGAL")) doneAtMs = now;
+  }
+  rig.lcd.dump(stdout);
+  expect(rig.lcd.contains("KALIBRASI SELESAI"), "kalibrasi berhenti sendiri dengan CI di bawah toleransi");
+
+  rig.buttons.press(2);
+  app.tick(doneAtMs + 1);
+  expect(strcmp(app.state().waste.jenis, "--") == 0, "pilihan jenis dari chord dibatalkan");
+
+  DeviceProfile saved;
+  expect(loadDeviceProfile(saved) && saved.preset == DeviceProfile::CUSTOM, "profil kustom tersimpan");
+  double factor = 1000.0 * (1 << FixedWeight::Q) / saved.mgPerCountQ16;
+  printf("Faktor tersimpan %.5f (benar %.5f), selesai %lums setelah beban diletakkan\n",
+         factor, TRUE_FACTOR, (unsigned long)(doneAtMs - 6000));
+  expect(fabs(factor / TRUE_FACTOR - 1.0) * 1e6 < 2.0 * settings.calibration.tolerancePpm,
+         "faktor hasil dalam 2x toleransi dari faktor sebenarnya");
+
+  // Kalibrasi ulang ('cal auto') dengan 'tare' dari console di tengah fase
+  // LOAD: re-tare paksa menggeser tare pipeline, net count kalibrator harus
+  // tetap relatif ke tare saat kalibrasi dimulai
+  ScriptedSampleSource again(13);
+  again.add({  6000, CELL_ZERO_RAW,          60, 0,    0,   0   });
+  again.add({ 40000, CELL_ZERO_RAW + refRaw, 60, 3000, 700, 400 });
+  ScaleApp rebooted(rig.lcd, rig.buttons, rig.buzzer, again, rig.uplink, rig.files, settings);
+  rebooted.begin(0);
+  rebooted.calibrate("auto");
+  int32_t startTare = 0;
+  doneAtMs = 0;
+  for (uint32_t now = 0; now <= again.durationMs() && doneAtMs == 0; now++) {
+    again.advanceTo(now);
+    rebooted.tick(now);
+    if (now == 8000) {
+      startTare = rebooted.pipeline().tareOffset();
+      rebooted.tare(nullptr);
+    }
+    if (rig.lcd.contains("KALIBRASI SELESAI") || rig.lcd.contains("KALIBRASI GAGAL")) doneAtMs = now;
+  }
+  const bool retared = rebooted.pipeline().tareOffset() != startTare;
+  const bool finished = rig.lcd.contains("KALIBRASI SELESAI");
+  rig.buttons.press(2);
+  rebooted.tick(doneAtMs + 1);
+  factor = finished && loadDeviceProfile(saved) ? 1000.0 * (1 << FixedWeight::Q) / saved.mgPerCountQ16 : 0.0;
+  printf("Kalibrasi ulang dengan re-tare di fase LOAD: faktor %.5f\n", factor);
+  expect(retared, "re-tare paksa terjadi selama kalibrasi");
+  expect(finished, "kalibrasi ulang selesai meski tare pipeline berubah");
+  expect(fabs(factor / TRUE_FACTOR - 1.0) * 1e6 < 2.0 * settings.calibration.tolerancePpm,
+         "re-tare di tengah kalibrasi tidak menggeser faktor");
+
+  // 'cal auto' hanya dari layar utama; keluar dari kalibrasi menulis ulang
+  // berat (0.00: beban acuan ikut ter-tare oleh 'tare' di atas)
+  uint32_t now = doneAtMs + 1;
+  rebooted.calibrate("auto");
+  expect(rebooted.state().appState == AppState::SHOWING_STATUS, "'cal auto' ditolak selama pesan status tampil");
+  auto runUntil = [&](uint32_t until) {
+    for (; now < until; now++) {
+      again.advanceTo(now);
+      rebooted.tick(now);
+    }
+  };
+  runUntil(now + Config::STATUS_MSG_DURATION + 500);
+  expect(rebooted.state().appState == AppState::IDLE && strstr(rig.lcd.row(1), "0.00") != nullptr,
+         "berat tampil setelah pesan status");
+  rebooted.calibrate("auto");
+  runUntil(now + 500);
+  rig.buttons.press(3);
+  runUntil(now + 500);
+  rig.lcd.dump(stdout);
+  expect(rebooted.state().appState == AppState::IDLE && strstr(rig.lcd.row(1), "0.00") != nullptr,
+         "berat tampil lagi setelah kalibrasi dibatalkan tanpa beban berubah");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static uint32_t hostClockUs() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count());
+}
+
+static int runOfflineJournalScenario() {
+  const int32_t BAG_MGS[] = { 1000000, 2500000, 4000000 };
+  const size_t BAGS = sizeof(BAG_MGS) / sizeof(BAG_MGS[0]);
+
+  AppRig rig;
+  ScriptedSampleSource source(5);
+  rig.uplink.setOnline(false);
+  rig.uplink.setLatency(500);
+
+  int startFailures = failures;
+  uint32_t now = 0;
+  uint32_t firstSeq = 0;
+  {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    app.begin(now);
+    app.showMainScreen();
+    firstSeq = app.journal().nextSeq();
+    const int32_t tare = app.pipeline().tareOffset();
+    for (size_t i = 0; i < BAGS; i++) {
+      source.add({ 1500, tare + app.pipeline().calibration().toNet(BAG_MGS[i]), 60, 0, 0, 0 });
+      source.add({ 1000, tare, 60, 0, 0, 0 });
+    }
+    // Tiap kantong: pilih Residu, kirim 1.2 s setelah diletakkan
+    for (; now <= source.durationMs(); now++) {
+      uint32_t phase = now % 2500;
+      if (phase == 100) rig.buttons.press(2);
+      if (phase == 1200) rig.buttons.press(3);
+      source.advanceTo(now);
+      app.tick(now);
+      if (phase == 1201 && !rig.lcd.contains("Simpan #")) rig.lcd.dump(stdout);
+    }
+    rig.lcd.dump(stdout);
+    expect(rig.uplink.records().empty(), "tidak ada yang terkirim selama offline");
+    expect(app.journal().unacked() == BAGS, "ketiga record tersimpan di jurnal");
+  }
+
+  // Listrik mati di tengah append: 3 byte entri berikutnya tertulis
+  const uint8_t torn[] = { 0x4A, 0x52, 0x07 };
+  rig.files.append("/jr.bin", torn, sizeof(torn));
+
+  rig.uplink.setOnline(true);
+  rig.uplink.setServerAccepts(false);
+  uint32_t drainedAtMs = 0;
+  const uint32_t onlineAtMs = now;
+  {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    app.begin(now);
+    expect(app.journal().unacked() == BAGS && app.journal().droppedTail() == 1,
+           "setelah reboot: 3 record menunggu, ekor rusak dipotong");
+    source.add({ 20000, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+    for (; now <= source.durationMs(); now++) {
+      if (now == onlineAtMs + 2000) rig.uplink.setServerAccepts(true);
+      source.advanceTo(now);
+      app.tick(now);
+      if (drainedAtMs == 0 && app.journal().unacked() == 0) drainedAtMs = now;
+    }
+  }
+  printf("Jurnal terkirim %lums setelah online (server menolak 2 s pertama)\n",
+         (unsigned long)(drainedAtMs - onlineAtMs));
+  expect(drainedAtMs > 0, "jurnal terkirim habis setelah online");
+  expect(rig.uplink.records().size() == BAGS && rig.uplink.duplicates() == 0, "tepat 3 record sampai di server (tanpa duplikat)");
+  bool ordered = rig.uplink.records().size() == BAGS;
+  for (size_t i = 0; ordered && i < BAGS; i++) {
+    ordered = abs(rig.uplink.records()[i].weightMg - BAG_MGS[i]) <= ACCEPT_ERROR_MG;
+  }
+  expect(ordered, "record terkirim berurutan sesuai penimbangan");
+  expect(rig.files.size("/jr.bin") < 0, "file jurnal dihapus setelah semua di-ack");
+  expect(rig.uplink.published().size() == BAGS, "MQTT di-publish sekali per penimbangan, bukan per kirim ulang");
+
+  {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    app.begin(now);
+    source.add({ 3000, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+    for (; now <= source.durationMs(); now++) {
+      source.advanceTo(now);
+      app.tick(now);
+    }
+    expect(app.journal().unacked() == 0 && rig.uplink.records().size() == BAGS && rig.uplink.duplicates() == 0,
+           "reboot berikutnya tidak mengirim ulang");
+    expect(app.journal().nextSeq() == firstSeq + BAGS, "nomor urut berlanjut setelah file dihapus");
+  }
+
+  // Bit flip di tengah jurnal + ekor tidak lengkap: hanya entri rusak yang
+  // hilang, entri sesudahnya tetap dikirim berurutan
+  {
+    constexpr uint32_t ENTRIES = 5;
+    constexpr uint32_t FLIPPED = 2;
+    RecordJournal journal(rig.files, "jc");
+    journal.clear();
+    journal.open();
+    WeighingRecord record;
+    copyText(record.fakultas, "FT");
+    copyText(record.jenis, "Kertas");
+    for (uint32_t i = 0; i < ENTRIES; i++) {
+      record.weightMg = 1000000 * static_cast<int32_t>(i + 1);
+      journal.append(record);
+    }
+    rig.files.flipBits("/jc.bin", FLIPPED * RecordJournal::ENTRY_SIZE + 7, 0x10);
+    rig.files.append("/jc.bin", torn, sizeof(torn));
+
+    RecordJournal reopened(rig.files, "jc");
+    reopened.open();
+    expect(reopened.corruptEntries() == 1 && reopened.droppedTail() == 1 && reopened.unacked() == ENTRIES,
+           "entri rusak di tengah dihitung & dilewati, hanya ekor tidak lengkap dipotong");
+    bool replayed = true;
+    uint32_t seq = 0;
+    for (uint32_t i = 0; i < ENTRIES; i++) {
+      if (i == FLIPPED) continue;
+      replayed = replayed && reopened.peek(0, record, seq) && seq == i + 1 &&
+                 record.weightMg == 1000000 * static_cast<int32_t>(i + 1) && reopened.ack();
+    }
+    expect(replayed && reopened.unacked() == 0, "entri sesudah yang rusak tetap terkirim berurutan");
+    reopened.clear();
+  }
+
+  // Laju jurnal pada "flash" host (di perangkat: console 'journal bench <n>')
+  const uint32_t BENCH_RECORDS = 1000;
+  JournalBench b = benchmarkJournal(rig.files, BENCH_RECORDS, hostClockUs);
+  printf("Jurnal host %lu record: append %.0f/s, replay %.0f/s\n", (unsigned long)b.count,
+         b.count * 1e6 / (b.appendUs ? b.appendUs : 1), b.count * 1e6 / (b.replayUs ? b.replayUs : 1));
+  expect(b.ok, "benchmark jurnal append & replay lengkap");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Kuras backlog 'count' record lewat uplink rig yang sudah diatur; return waktu
+// kuras (ms virtual), 0 jika tidak habis / urutan atau jumlah salah
+static uint32_t drainBacklog(AppRig& rig, uint32_t count) {
+  ScriptedSampleSource source(3);
+  ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+  app.begin(0);
+  source.add({ 120000, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+
+  WeighingRecord record;
+  copyText(record.fakultas, "FT");
+  copyText(record.jenis, "Organik");
+  for (uint32_t i = 0; i < count; i++) {
+    record.weightMg = 1000000 + static_cast<int32_t>(i) * 10000;
+    app.journal().append(record);
+  }
+
+  uint32_t drainedAtMs = 0;
+  for (uint32_t now = 0; now <= source.durationMs() && drainedAtMs == 0; now++) {
+    source.advanceTo(now);
+    app.tick(now);
+    if (app.journal().unacked() == 0) drainedAtMs = now;
+  }
+  if (rig.uplink.records().size() != count) return 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (rig.uplink.records()[i].weightMg != 1000000 + static_cast<int32_t>(i) * 10000) return 0;
+  }
+  return drainedAtMs;
+}
+
+static int runBatchBacklogScenario() {
+  // Biaya per POST (TLS keep-alive + bootstrap Laravel) jauh di atas biaya
+  // per record (satu INSERT): backlog setelah offline didominasi overhead request
+  constexpr uint32_t BACKLOG = 48;
+  constexpr uint32_t REQUEST_MS = 400;
+  constexpr uint32_t RECORD_MS = 25;
+
+  int startFailures = failures;
+  printf("Backlog %lu record, %lums/POST + %lums/record:\n", (unsigned long)BACKLOG,
+         (unsigned long)REQUEST_MS, (unsigned long)RECORD_MS);
+  printf("%8s %10s %10s\n", "batch", "kuras (ms)", "record/s");
+  uint32_t singleMs = 0;
+  for (uint16_t size = 1; size <= Config::BATCH_MAX_RECORDS; size *= 2) {
+    AppRig rig;
+    rig.uplink.setLatency(REQUEST_MS);
+    rig.uplink.setPerRecordLatency(RECORD_MS);
+    rig.uplink.setFixedBatch(size);
+    uint32_t ms = drainBacklog(rig, BACKLOG);
+    if (size == 1) singleMs = ms;
+    printf("%8u %10lu %10.1f\n", size, (unsigned long)ms, ms ? BACKLOG * 1000.0 / ms : 0.0);
+    expect(ms > 0, "backlog terkirim lengkap & berurutan");
+  }
+
+  AppRig adaptive;
+  adaptive.uplink.setLatency(REQUEST_MS);
+  adaptive.uplink.setPerRecordLatency(RECORD_MS);
+  uint32_t adaptiveMs = drainBacklog(adaptive, BACKLOG);
+  printf("%8s %10lu %10.1f  (%lu POST, batch terbesar %u, RTT %lums)\n", "adaptif", (unsigned long)adaptiveMs,
+         adaptiveMs ? BACKLOG * 1000.0 / adaptiveMs : 0.0, (unsigned long)adaptive.uplink.batchSizer().batches(),
+         adaptive.uplink.largestBatch(), (unsigned long)adaptive.uplink.batchSizer().smoothedRttMs());
+  expect(adaptiveMs > 0 && adaptiveMs * 4 < singleMs, "batch adaptif menguras backlog > 4x lebih cepat");
+  expect(adaptive.uplink.largestBatch() == Config::BATCH_MAX_RECORDS, "ukuran batch tumbuh sampai maksimum");
+
+  // Jaringan lambat: RTT batch besar melewati target, batas diturunkan lagi
+  AppRig slow;
+  slow.uplink.setLatency(REQUEST_MS);
+  slow.uplink.setPerRecordLatency(Config::BATCH_TARGET_MS / 8);
+  uint32_t slowMs = drainBacklog(slow, BACKLOG);
+  printf("Jaringan lambat: kuras %lums, batch terbesar %u, batas akhir %u\n", (unsigned long)slowMs,
+         slow.uplink.largestBatch(), slow.uplink.batchSizer().limit());
+  expect(slowMs > 0 && slow.uplink.largestBatch() < Config::BATCH_MAX_RECORDS,
+         "RTT di atas target membatasi ukuran batch");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runRecordCodecScenario() {
+  const char* const JENIS[] = { "Organik", "Anorganik", "Botol", "Kertas", "Residu" };
+  const uint64_t DEVICE_ID = 0xA1B2C3D4E5F6ull;   // MAC 48-bit utuh
+  int startFailures = failures;
+
+  bool roundTrip = true;
+  size_t cases = 0;
+  for (size_t p = 0; p <= profilePresetCount(); p++) {
+    DeviceProfile profile;
+    // Indeks terakhir: fakultas kustom, nama ikut di frame
+    if (p == profilePresetCount()) makeCustomProfile("Vokasi", 12.2, profile);
+    else profileFromPreset(p, profile);
+    for (size_t j = 0; j < sizeof(JENIS) / sizeof(JENIS[0]); j++) {
+      WeighingRecord r;
+      r.weightMg = static_cast<int32_t>(j * 1234567) - 20000;   // termasuk berat negatif
+      copyText(r.fakultas, profile.fakultas);
+      copyText(r.jenis, JENIS[j]);
+      r.bootId = 0x80000000u + p;
+      r.seq = 1000 + cases;
+      uint8_t frame[RecordCodec::MAX_SIZE];
+      size_t len = RecordCodec::encode(r, DEVICE_ID, frame, sizeof(frame));
+      RecordCodec::Decoded d;
+      roundTrip = roundTrip && len > 0 && RecordCodec::decode(frame, len, d) && d.deviceId == DEVICE_ID &&
+                  d.record.bootId == r.bootId && d.record.seq == r.seq && d.record.weightMg == r.weightMg &&
+                  strcmp(d.record.fakultas, r.fakultas) == 0 && strcmp(d.record.jenis, r.jenis) == 0;
+      cases++;
+    }
+  }
+  expect(roundTrip, "record biner bolak-balik identik (semua fakultas preset + kustom, semua jenis)");
+
+  WeighingRecord sample;
+  sample.weightMg = 5200000;
+  strcpy(sample.fakultas, "FT");
+  strcpy(sample.jenis, "Organik");
+  sample.bootId = 3;
+  sample.seq = 42;
+  uint8_t frame[RecordCodec::MAX_SIZE];
+  size_t len = RecordCodec::encode(sample, DEVICE_ID, frame, sizeof(frame));
+  printf("Contoh FT/Organik/5.20 kg boot 3 seq 42: ");
+  for (size_t i = 0; i < len; i++) printf("%02x", frame[i]);
+  printf("\n");
+
+  // JSON MQTT membawa kunci idempoten yang sama dengan form Laravel
+  char json[200];
+  RecordCodec::formatMqttJson(sample, DEVICE_ID, json, sizeof(json));
+  printf("Contoh JSON MQTT: %s\n", json);
+  expect(strstr(json, "\"device_id\":\"A1B2C3D4E5F6\",\"boot_id\":3,\"seq\":42,") != nullptr,
+         "JSON MQTT memuat device_id (MAC 48-bit), boot_id & seq");
+
+  RecordCodec::Decoded d;
+  bool rejects = RecordCodec::encode(sample, 1, frame, RecordCodec::BASE_SIZE - 1) == 0;
+  len = RecordCodec::encode(sample, 1, frame, sizeof(frame));
+  frame[18] ^= 0x01;
+  rejects = rejects && !RecordCodec::decode(frame, len, d);
+  frame[18] ^= 0x01;
+  rejects = rejects && !RecordCodec::decode(frame, len - 1, d);
+  frame[0] = RecordCodec::VERSION + 1;
+  rejects = rejects && !RecordCodec::decode(frame, len, d);
+  expect(rejects, "buffer kurang, bit terbalik, frame terpotong & versi asing ditolak");
+
+  // Ukuran & waktu encode, record tipikal (fakultas preset)
+  const uint32_t N = 200000;
+  char text[256];
+  size_t sizes[3] = { 0, 0, 0 };
+  uint32_t elapsedUs[3];
+  volatile size_t sink = 0;
+  for (int f = 0; f < 3; f++) {
+    uint32_t start = hostClockUs();
+    for (uint32_t i = 0; i < N; i++) {
+      sample.weightMg = 1000000 + static_cast<int32_t>(i % 50000) * 10;
+      sample.seq = i;
+      // Encoder teks yang sama dengan sendToLaravel() / sendToMQTT() di firmware
+      if (f == 0) sizes[f] = RecordCodec::formatForm(sample, "0123456789abcdef", DEVICE_ID, text, sizeof(text));
+      else if (f == 1) sizes[f] = RecordCodec::formatMqttJson(sample, DEVICE_ID, text, sizeof(text));
+      else sizes[f] = RecordCodec::encode(sample, DEVICE_ID, frame, sizeof(frame));
+      sink = sink + sizes[f];
+    }
+    elapsedUs[f] = hostClockUs() - start;
+  }
+  const char* const NAMES[] = { "form POST", "JSON MQTT", "biner v2" };
+  printf("%10s %8s %12s\n", "format", "byte", "ns/record");
+  for (int f = 0; f < 3; f++) {
+    printf("%10s %8u %12.1f\n", NAMES[f], (unsigned)sizes[f], elapsedUs[f] * 1000.0 / N);
+  }
+  expect(sizes[2] * 2 < sizes[1], "record biner kurang dari separuh JSON");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runReachabilityScenario() {
+  ScriptedConnector server;
+  ReachabilityProbe probe(server);
+  probe.setTarget("ecoscale.undip.us", 443);
+  int startFailures = failures;
+
+  // Jalankan probe per 1 ms sampai 'until'; return waktu reachable() berubah (0 = tidak)
+  uint32_t now = 0;
+  auto runUntil = [&](uint32_t until) -> uint32_t {
+    uint32_t changedAt = 0;
+    bool was = probe.reachable();
+    for (; now < until; now++) {
+      server.advanceTo(now);
+      probe.tick(now);
+      if (changedAt == 0 && probe.reachable() != was) changedAt = now;
+    }
+    return changedAt;
+  };
+
+  server.setMode(ScriptedConnector::Mode::ACCEPT, 80);
+  uint32_t onlineAt = runUntil(60000);
+  printf("Online %lums setelah WiFi (RTT~%lums), %lu probe dalam 60 s\n", (unsigned long)onlineAt,
+         (unsigned long)probe.smoothedRttMs(), (unsigned long)probe.stats().probes);
+  expect(onlineAt == 80 && probe.smoothedRttMs() == 80, "online setelah satu connect sukses, RTT terukur");
+  expect(probe.stats().probes == 4, "saat terjangkau: satu probe tiap PROBE_INTERVAL");
+
+  // Server hilang tanpa RST (mis. uplink kampus putus)
+  const uint32_t lostAt = now;
+  server.setMode(ScriptedConnector::Mode::BLACKHOLE);
+  uint32_t offlineAt = runUntil(lostAt + 300000);
+  printf("Offline %lums setelah server hilang (%lu timeout)\n", (unsigned long)(offlineAt - lostAt),
+         (unsigned long)probe.stats().timeouts);
+  expect(offlineAt > 0 && offlineAt - lostAt <= Config::PROBE_INTERVAL + 2 * Config::PROBE_TIMEOUT + Config::PROBE_BACKOFF_MIN,
+         "offline setelah dua probe gagal");
+
+  // Jarak antar probe gagal: timeout + backoff eksponensial, dibatasi maksimum
+  printf("Jarak probe selama server hilang (s):");
+  bool backoff = true;
+  uint32_t expectedDelay = Config::PROBE_BACKOFF_MIN;
+  const std::vector<uint32_t>& starts = server.starts();
+  size_t first = 0;
+  while (first < starts.size() && starts[first] < lostAt) first++;
+  for (size_t i = first + 1; i < starts.size(); i++) {
+    uint32_t gap = starts[i] - starts[i - 1];
+    printf(" %.0f", gap / 1000.0);
+    backoff = backoff && gap == Config::PROBE_TIMEOUT + expectedDelay;
+    expectedDelay = expectedDelay * 2 < Config::PROBE_BACKOFF_MAX ? expectedDelay * 2 : Config::PROBE_BACKOFF_MAX;
+  }
+  printf("\n");
+  expect(backoff, "backoff 1, 2, 4, ... s sampai PROBE_BACKOFF_MAX");
+
+  // Server kembali: online pada probe berikutnya
+  const uint32_t backAt = now;
+  server.setMode(ScriptedConnector::Mode::ACCEPT, 120);
+  uint32_t recoveredAt = runUntil(backAt + 120000);
+  printf("Online lagi %lums setelah server kembali\n", (unsigned long)(recoveredAt - backAt));
+  expect(recoveredAt > 0 && recoveredAt - backAt <= Config::PROBE_BACKOFF_MAX + Config::PROBE_TIMEOUT + 120,
+         "online lagi dalam satu periode backoff");
+
+  // Satu RST di tengah (server restart): belum offline (histeresis), gagal cepat tanpa timeout
+  server.setMode(ScriptedConnector::Mode::REFUSE, 5);
+  uint32_t timeoutsBefore = probe.stats().timeouts;
+  uint32_t refusedAt = now + probe.nextProbeInMs(now);
+  runUntil(refusedAt + 100);
+  server.setMode(ScriptedConnector::Mode::ACCEPT, 80);
+  uint32_t flapped = runUntil(now + 30000);
+  expect(flapped == 0 && probe.reachable() && probe.stats().timeouts == timeoutsBefore,
+         "satu connect ditolak tidak langsung membuat offline");
+
+  // WiFi putus: langsung offline, probe segera begitu WiFi kembali
+  probe.linkDown();
+  expect(!probe.reachable() && probe.nextProbeInMs(now) == 0, "WiFi putus: offline, probe langsung saat tersambung");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Satu timbangan: radio + WifiLink (atau polling lama) + probe server,
+// urutannya sama dengan NetworkUplink::maintain()
+struct WifiRig {
+  ScriptedWifiRadio radio;
+  WifiLink link{radio};
+  ScriptedConnector server;
+  ReachabilityProbe probe{server};
+  bool legacy = false;          // model lama: cek WiFi.status() tiap 15 s, reconnect dengan scan
+  uint32_t legacyPhase = 0;
+  bool offline = true;
+  uint32_t now = 0;
+  uint32_t linkAt = 0;          // waktu terakhir link naik / server terjangkau
+  uint32_t onlineAt = 0;
+
+  WifiRig() {
+    probe.setTarget("ecoscale.undip.us", 443);
+    server.setMode(ScriptedConnector::Mode::ACCEPT, 80);
+  }
+  void begin(uint32_t seed) {
+    radio.advanceTo(now);
+    if (legacy) radio.join(nullptr);
+    else link.begin(now, seed);
+  }
+  void step() {
+    radio.advanceTo(now);
+    server.advanceTo(now);
+    bool up;
+    if (legacy) {
+      Hal::WifiRadio::Event ev;
+      while (radio.pollEvent(ev)) {}
+      if (now % 15000 == legacyPhase && !radio.linkUp()) radio.join(nullptr);
+      up = radio.linkUp();
+    } else {
+      bool was = link.up();
+      link.tick(now);
+      up = link.up();
+      if (up && !was) linkAt = now;
+    }
+    if (legacy && up && linkAt == 0) linkAt = now;
+    const bool wasOffline = offline;
+    if (up) {
+      probe.tick(now);
+      offline = !probe.reachable();
+    } else {
+      probe.linkDown();
+      offline = true;
+      if (legacy) linkAt = 0;
+    }
+    if (wasOffline && !offline) {
+      onlineAt = now;
+      if (!legacy) link.markOnline(now);
+    }
+    now++;
+  }
+  // Jalan sampai online (return true) atau 'until'
+  bool runUntilOnline(uint32_t until) {
+    onlineAt = 0;
+    while (now < until) {
+      step();
+      if (onlineAt != 0) return true;
+    }
+    return false;
+  }
+  void runUntil(uint32_t until) {
+    while (now < until) step();
+  }
+};
+
+static int runWifiLinkScenario() {
+  int startFailures = failures;
+  const uint32_t fullJoinMs = 2200 + 150 + 900;   // scan + assoc + DHCP (ScriptedWifiRadio)
+  const uint32_t fastJoinMs = 75 + 150 + 900;
+
+  // Boot pertama: belum ada BSSID di NVS -> scan penuh, BSSID disimpan
+  {
+    WifiRig rig;
+    rig.begin(1);
+    bool online = rig.runUntilOnline(20000);
+    printf("Boot tanpa cache: IP %lums, online %lums\n", (unsigned long)rig.linkAt, (unsigned long)rig.onlineAt);
+    expect(online && !rig.radio.joinHinted()[0] && rig.linkAt == fullJoinMs, "boot pertama: scan penuh");
+    expect(rig.link.hasCachedBss() && rig.link.cachedBss().channel == 6, "BSSID/kanal AP disimpan");
+  }
+  // Boot berikutnya: join langsung ke BSSID/kanal dari NVS
+  uint32_t fastBootLink = 0;
+  {
+    WifiRig rig;
+    rig.begin(1);
+    rig.runUntilOnline(20000);
+    fastBootLink = rig.linkAt;
+    printf("Boot dengan cache: IP %lums, online %lums\n", (unsigned long)rig.linkAt, (unsigned long)rig.onlineAt);
+    expect(rig.radio.joinHinted()[0] && rig.linkAt == fastJoinMs, "boot berikutnya: tanpa scan");
+  }
+  // IP statis: DHCP dilewati
+  {
+    WifiRig rig;
+    rig.radio.dhcpMs = 0;
+    rig.begin(1);
+    rig.runUntilOnline(20000);
+    printf("Boot dengan cache + IP statis: IP %lums\n", (unsigned long)rig.linkAt);
+    expect(rig.linkAt + 900 == fastBootLink, "IP statis: tanpa menunggu DHCP");
+  }
+
+  // AP restart 5 s di berbagai fase terhadap polling 15 s: waktu dari AP hidup lagi sampai online
+  const uint32_t apDownMs = 5000;
+  const int phases = 12;
+  uint32_t sum[2] = { 0, 0 };
+  uint32_t worst[2] = { 0, 0 };
+  bool allRecovered = true;
+  for (int legacy = 0; legacy < 2; legacy++) {
+    for (int k = 0; k < phases; k++) {
+      WifiRig rig;
+      rig.legacy = legacy != 0;
+      rig.begin(100 + k);
+      rig.runUntilOnline(20000);
+      rig.runUntil(30000 + k * 15000 / phases);
+      rig.radio.setAp(false, rig.now);
+      rig.runUntil(rig.now + apDownMs);
+      const uint32_t backAt = rig.now;
+      rig.radio.setAp(true, backAt);
+      if (!rig.runUntilOnline(backAt + 60000)) allRecovered = false;
+      uint32_t ms = rig.onlineAt - backAt;
+      sum[legacy] += ms;
+      if (ms > worst[legacy]) worst[legacy] = ms;
+      if (k == 0 && !rig.legacy) {
+        const LinkStats& st = rig.link.stats();
+        printf("Outage (AP mati %lus): link putus -> IP %lums, -> online %lums, %lu join (%lu tanpa scan)\n",
+               (unsigned long)(apDownMs / 1000), (unsigned long)st.linkMsLast, (unsigned long)st.onlineMsLast,
+               (unsigned long)st.joins, (unsigned long)st.fastJoins);
+        expect(st.outages == 1 && st.linkRecovered == 1 && st.onlineRecovered == 1 && st.onlineMsLast > st.linkMsLast,
+               "time-to-online tercatat per outage");
+      }
+    }
+  }
+  printf("AP hidup lagi -> online: event+backoff rata2 %lums (maks %lums), polling 15 s rata2 %lums (maks %lums)\n",
+         (unsigned long)(sum[0] / phases), (unsigned long)worst[0], (unsigned long)(sum[1] / phases),
+         (unsigned long)worst[1]);
+  expect(allRecovered, "semua timbangan online lagi");
+  expect(worst[0] <= Config::WIFI_BACKOFF_MIN * 4 + fullJoinMs + 80, "event-driven: online dalam beberapa detik");
+  expect(sum[0] * 2 < sum[1] && worst[0] * 3 < worst[1], "lebih cepat dari polling WIFI_CHECK_INTERVAL");
+
+  // AP pindah kanal: cache gagal WIFI_FAST_REJOIN_TRIES kali -> scan -> cache diperbarui
+  {
+    WifiRig rig;
+    rig.begin(7);
+    rig.runUntilOnline(20000);
+    rig.radio.setAp(false, rig.now);
+    rig.runUntil(rig.now + 1000);
+    rig.radio.setAp(true, rig.now, 11);
+    bool online = rig.runUntilOnline(rig.now + 60000);
+    const std::vector<bool>& hinted = rig.radio.joinHinted();
+    size_t n = hinted.size();
+    printf("AP pindah ke kanal 11: %lu join, online lagi %lums setelah putus\n", (unsigned long)(n - 1),
+           (unsigned long)rig.link.stats().onlineMsLast);
+    expect(online && n >= 2 + Config::WIFI_FAST_REJOIN_TRIES && !hinted[n - 1] && hinted[n - 2] && hinted[n - 3],
+           "setelah join cache gagal -> scan penuh");
+    expect(rig.link.cachedBss().channel == 11, "kanal baru dipakai");
+    WifiRig reboot;
+    reboot.begin(7);
+    expect(reboot.link.cachedBss().channel == 11, "kanal baru tersimpan di NVS");
+  }
+
+  // Backoff: AP mati lama, jeda join dalam [base/2, base], beda per perangkat (seed)
+  std::vector<uint32_t> delays[2];
+  bool bounded = true;
+  for (int i = 0; i < 2; i++) {
+    WifiRig rig;
+    rig.begin(1 + i);
+    rig.runUntilOnline(20000);
+    const size_t before = rig.radio.joinTimes().size();
+    rig.radio.setAp(false, rig.now);
+    rig.runUntil(rig.now + 180000);
+    const std::vector<uint32_t>& t = rig.radio.joinTimes();
+    const std::vector<bool>& hinted = rig.radio.joinHinted();
+    for (size_t j = before; j + 1 < t.size(); j++) {
+      const uint32_t failedAt = t[j] + (hinted[j] ? rig.radio.assocMs / 2 : rig.radio.scanMs);
+      const uint32_t streak = j - before + 1;
+      uint32_t base = streak <= 16 && (Config::WIFI_BACKOFF_MIN << (streak - 1)) < Config::WIFI_BACKOFF_MAX
+                          ? Config::WIFI_BACKOFF_MIN << (streak - 1) : Config::WIFI_BACKOFF_MAX;
+      const uint32_t delay = t[j + 1] - failedAt;
+      delays[i].push_back(delay);
+      bounded = bounded && delay >= base / 2 && delay <= base;
+    }
+  }
+  printf("Jeda join selama AP mati (s), seed 1:");
+  for (size_t j = 0; j < delays[0].size(); j++) printf(" %.1f", delays[0][j] / 1000.0);
+  printf("\n");
+  expect(delays[0].size() >= 8 && bounded, "backoff eksponensial dengan jitter dalam [base/2, base]");
+  expect(delays[0] != delays[1], "jadwal rejoin berbeda antar perangkat");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Entri jurnal format lama ("JR", jenis 16 byte, tanpa boot ID), seperti
+// yang tertinggal di flash perangkat sebelum update
+static void appendV1Entry(MemoryFileStore& files, uint32_t seq, int32_t weightMg) {
+  uint8_t entry[RecordJournal::ENTRY_SIZE] = { 0x4A, 0x52 };
+  Capture::putLe(entry + 2, seq, 4);
+  Capture::putLe(entry + 6, static_cast<uint32_t>(weightMg), 4);
+  strncpy(reinterpret_cast<char*>(entry + 10), "FT", 8);
+  strncpy(reinterpret_cast<char*>(entry + 18), "Organik", 16);
+  Capture::putLe(entry + 34, Capture::crc16(entry + 2, 32), 2);
+  files.append("/jr.bin", entry, sizeof(entry));
+}
+
+static int runExactlyOnceScenario() {
+  constexpr uint32_t LEGACY = 2;
+  constexpr uint32_t PER_BOOT = 30;
+  AppRig rig;
+  ScriptedSampleSource source(11);
+  rig.uplink.setLatency(300);
+  rig.uplink.setLostReplyEvery(5); // server menyimpan, perangkat timeout
+  int startFailures = failures;
+
+  int64_t expectedMg = 0;
+  uint32_t weighed = 0;
+  auto weighBacklog = [&](ScaleApp& app, uint32_t count) {
+    WeighingRecord record;
+    copyText(record.fakultas, "FT");
+    copyText(record.jenis, "Residu");
+    for (uint32_t i = 0; i < count; i++) {
+      record.weightMg = 1000000 + static_cast<int32_t>(weighed++) * 1000;
+      if (app.journal().append(record) != 0) expectedMg += record.weightMg;
+    }
+  };
+
+  // Sisa jurnal firmware lama yang belum terkirim
+  for (uint32_t i = 0; i < LEGACY; i++) {
+    const int32_t mg = 900000 + static_cast<int32_t>(i);
+    appendV1Entry(rig.files, 1000 + i, mg);
+    expectedMg += mg;
+    weighed++;
+  }
+  uint32_t now = 0;
+  uint32_t bootIds[3] = { 0, 0, 0 };
+  // Boot 1..3: tiap boot menambah record, boot 1 & 2 "mati listrik" di tengah
+  // pengiriman (ack jurnal tertinggal dari yang sudah disimpan server)
+  for (int boot = 0; boot < 3; boot++) {
+    ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+    app.begin(now);
+    bootIds[boot] = app.journal().bootId();
+    const uint32_t bootMs = now;
+    if (boot == 2) {
+      // Maintenance 'journal clear' dua kali di boot yang sama, dengan
+      // penimbangan di antaranya: seq kedua kali mulai dari 1 lagi, kunci
+      // (boot ID, seq) tidak boleh sama dengan record sebelum clear()
+      auto drain = [&]() {
+        for (const uint32_t until = now + 300000; now < until && app.journal().unacked() > 0; now++) {
+          source.advanceTo(now);
+          app.tick(now);
+        }
+      };
+      source.add({ 300000, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+      drain();
+      expect(app.journal().unacked() == 0, "sisa jurnal terkirim sebelum dihapus");
+      app.journal().clear();
+      weighBacklog(app, PER_BOOT / 2);
+      drain();
+      const uint32_t clearedBootId = app.journal().bootId();
+      app.journal().clear();
+      expect(app.journal().nextSeq() == 1 && app.journal().bootId() == clearedBootId + 1,
+             "jurnal dihapus: seq mulai dari 1 dengan boot ID baru");
+    }
+    weighBacklog(app, PER_BOOT);
+    source.add({ 300000, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+    const uint32_t until = boot < 2 ? now + 2500 : now + 300000;
+    for (; now < until; now++) {
+      source.advanceTo(now);
+      app.tick(now);
+      if (boot == 2 && app.journal().unacked() == 0) break;
+    }
+    if (boot == 2) {
+      printf("Jurnal boot terakhir terkirim dalam %lums\n", (unsigned long)(now - bootMs));
+      expect(app.journal().unacked() == 0, "jurnal terkirim habis");
+    }
+  }
+
+  int64_t storedMg = 0;
+  std::set<uint64_t> keys;
+  for (size_t i = 0; i < rig.uplink.records().size(); i++) {
+    const WeighingRecord& r = rig.uplink.records()[i];
+    storedMg += r.weightMg;
+    keys.insert((static_cast<uint64_t>(r.bootId) << 32) | r.seq);
+  }
+  printf("Exactly-once: %lu penimbangan, %lu baris di server, %lu kiriman duplikat dibuang, %lu balasan hilang\n",
+         (unsigned long)weighed, (unsigned long)rig.uplink.records().size(), (unsigned long)rig.uplink.duplicates(),
+         (unsigned long)rig.uplink.lostReplies());
+  printf("Boot ID: %lu, %lu, %lu; tanpa kunci server akan menyimpan %lu baris\n", (unsigned long)bootIds[0],
+         (unsigned long)bootIds[1], (unsigned long)bootIds[2],
+         (unsigned long)(rig.uplink.records().size() + rig.uplink.duplicates()));
+  expect(bootIds[1] == bootIds[0] + 1 && bootIds[2] == bootIds[1] + 1, "boot ID naik setiap boot");
+  expect(rig.uplink.lostReplies() > 0 && rig.uplink.duplicates() > 0, "timeout & reboot benar-benar memicu kirim ulang");
+  expect(rig.uplink.records().size() == weighed && keys.size() == weighed && storedMg == expectedMg,
+         "setiap penimbangan tersimpan tepat sekali");
+  expect(rig.uplink.records()[0].bootId == 0 && rig.uplink.records()[0].seq == 1000, "entri format lama terkirim (boot ID 0)");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runHx711PinsScenario() {
+  int startFailures = failures;
+  SimHx711Pins pins;
+
+  const int32_t VALUES[] = { 0, 1, -1, 123456, -123456, Hx711::RAW_MAX, Hx711::RAW_MIN, 0x400000, -0x400001 };
+  bool signOk = true;
+  for (size_t i = 0; i < sizeof(VALUES) / sizeof(VALUES[0]); i++) {
+    pins.setConversion(VALUES[i]);
+    signOk = signOk && Hx711::isReady(pins) && Hx711::readWord(pins) == VALUES[i] && !Hx711::isReady(pins);
+  }
+  expect(signOk, "word 24 bit di-sign-extend benar (0, +-1, batas RAW_MIN/RAW_MAX)");
+
+  const Hx711::Gain GAINS[] = { Hx711::GAIN_128_A, Hx711::GAIN_32_B, Hx711::GAIN_64_A };
+  bool gainOk = true;
+  for (size_t i = 0; i < 3; i++) {
+    pins.setConversion(-42);
+    const uint32_t start = pins.elapsedUs();
+    gainOk = gainOk && Hx711::readWord(pins, GAINS[i]) == -42 && pins.lastPulses() == 24 + GAINS[i] &&
+             pins.gainPulses() == GAINS[i] && pins.elapsedUs() - start == (24u + GAINS[i]) * 2;
+  }
+  printf("HX711: pulsa per baca %u/%u/%u, SCK HIGH maks %lu us\n", 24 + GAINS[0], 24 + GAINS[1], 24 + GAINS[2],
+         (unsigned long)pins.maxSckHighUs());
+  expect(gainOk, "gain 128/32/64 -> 25/26/27 pulsa SCK");
+  expect(!pins.poweredDown() && pins.maxSckHighUs() < Hx711::POWER_DOWN_US, "readWord tidak memicu power-down");
+
+  // Power-down: DOUT HIGH walau ada konversi; bangun -> settling -> gain kembali 128
+  Hx711::powerDown(pins);
+  pins.setConversion(777);
+  expect(pins.poweredDown() && !Hx711::isReady(pins), "power-down: DOUT HIGH");
+  Hx711::powerUp(pins);
+  const uint32_t wokeUs = pins.elapsedUs();
+  pins.setConversion(777);
+  while (!Hx711::isReady(pins) && pins.elapsedUs() - wokeUs < 2 * Hx711::WAKE_SETTLE_US) pins.delayUs(100);
+  const uint32_t settleUs = pins.elapsedUs() - wokeUs;
+  printf("HX711: data pertama %lu us setelah bangun\n", (unsigned long)settleUs);
+  expect(!pins.poweredDown() && pins.gainPulses() == Hx711::GAIN_128_A, "bangun: reset ke gain 128/A");
+  expect(settleUs >= Hx711::WAKE_SETTLE_US && settleUs < Hx711::WAKE_SETTLE_US + 100 && Hx711::readWord(pins) == 777,
+         "data siap setelah settling, nilainya utuh");
+
+  // Pembacaan yang di-preempt dengan SCK HIGH > 60 us: chip power-down di tengah word
+  pins.setConversion(555);
+  for (int i = 0; i < 10; i++) {
+    pins.writeSck(true);
+    pins.delayUs(1);
+    pins.writeSck(false);
+    pins.delayUs(1);
+  }
+  pins.writeSck(true);
+  pins.delayUs(Hx711::POWER_DOWN_US + 20);
+  expect(pins.poweredDown() && pins.readDout(), "SCK HIGH terlalu lama di tengah word -> power-down");
+  Hx711::powerUp(pins);
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Sinyal uji filter (mg): nol, lalu kantong 5.2 kg mulai sampel STEP_AT,
+// noise +-3 g (LCG deterministik) dan spike 200 g tiap 37 sampel
+struct FilterSignal {
+  static constexpr uint32_t STEP_AT = 100;
+  uint32_t lcg = 12345;
+  int32_t at(uint32_t i) {
+    lcg = lcg * 1103515245u + 12345u;
+    int32_t mg = (i >= STEP_AT ? BAG_MG : 0) + static_cast<int32_t>((lcg >> 16) % 6001) - 3000;
+    if (i % 37 == 36) mg += 200000;
+    return mg;
+  }
+};
+
+struct FilterBench {
+  uint32_t settleMs;     // dari step sampai output menetap dalam ACCEPT_ERROR_MG
+  double nsPerSample;
+};
+
+template <typename Chain>
+static FilterBench benchFilter(Chain chain) {
+  constexpr uint32_t SETTLE_SAMPLES = 400;
+  constexpr uint32_t TIMED_SAMPLES = 2000000;
+  FilterBench result = { 0, 0.0 };
+
+  FilterSignal signal;
+  uint32_t lastOutside = FilterSignal::STEP_AT;
+  for (uint32_t i = 0; i < SETTLE_SAMPLES; i++) {
+    int32_t y = chain.process(signal.at(i));
+    if (i >= FilterSignal::STEP_AT && abs(y - BAG_MG) > ACCEPT_ERROR_MG) lastOutside = i + 1;
+  }
+  result.settleMs = (lastOutside - FilterSignal::STEP_AT) * 1000 / Config::HX711_SPS;
+
+  // Sinyal dibuat dulu agar yang terukur hanya filter
+  static int32_t input[4096];
+  for (size_t i = 0; i < 4096; i++) input[i] = signal.at(static_cast<uint32_t>(i));
+  volatile int32_t sink = 0;
+  const uint32_t start = hostClockUs();
+  for (uint32_t i = 0; i < TIMED_SAMPLES; i++) sink = chain.process(input[i & 4095]);
+  (void)sink;
+  result.nsPerSample = (hostClockUs() - start) * 1000.0 / TIMED_SAMPLES;
+  return result;
+}
+
+static int runFilterBenchScenario() {
+  // Batas settle semua preset: kantong terbaca benar dalam 1 s (80 konversi)
+  constexpr uint32_t FILTER_SETTLE_BOUND_MS = 1000;
+  int startFailures = failures;
+
+  Filter::AdaptiveParams params = settings.adaptive;
+  Filter::AdaptiveMetrics metrics = Filter::AdaptiveMetrics();
+  FilterBench results[4] = {
+    benchFilter(Filter::Preset::Responsive<int32_t>::make(Config::NOISE_GATE_THRESHOLD_MG)),
+    benchFilter(Filter::Preset::Standard<int32_t>::make(Config::NOISE_GATE_THRESHOLD_MG, Config::FILTER_HAMPEL_MIN_MG)),
+    benchFilter(Filter::Preset::Adaptive<int32_t>::make(Config::NOISE_GATE_THRESHOLD_MG, &params, &metrics)),
+    benchFilter(Filter::Preset::Heavy<int32_t>::make(Config::NOISE_GATE_THRESHOLD_MG, Config::FILTER_HAMPEL_MIN_MG,
+                                                     Config::FILTER_DEADBAND_MG)),
+  };
+  const char* const NAMES[4] = { "Responsive", "Standard", "Adaptive", "Heavy" };
+
+  printf("%12s %12s %10s\n", "preset", "settle (ms)", "ns/sampel");
+  bool bounded = true;
+  for (int i = 0; i < 4; i++) {
+    printf("%12s %12lu %10.1f\n", NAMES[i], (unsigned long)results[i].settleMs, results[i].nsPerSample);
+    bounded = bounded && results[i].settleMs <= FILTER_SETTLE_BOUND_MS;
+  }
+  expect(bounded, "semua preset settle dalam FILTER_SETTLE_BOUND_MS");
+  expect(results[2].settleMs <= results[1].settleMs && results[2].settleMs <= results[3].settleMs,
+         "preset Adaptive (firmware) settle paling lambat secepat Standard & Heavy");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Drift titik nol sel beban (mg) pada detik ke-t: ayunan suhu siang hari
+// (puncak 25 g setelah 4 jam) + creep 5 g/jam, seperti rekaman bengkel
+static int32_t zeroDriftMg(double t) {
+  const double PI = 3.14159265358979;
+  return static_cast<int32_t>(25000.0 * (1.0 - cos(PI * t / (4 * 3600.0))) / 2.0 + 5000.0 * t / 3600.0);
+}
+
+static int runZeroDriftScenario() {
+  constexpr uint32_t HOURS = 4;
+  constexpr uint32_t BAG_EVERY_S = 20 * 60;
+  constexpr uint32_t BAG_HOLD_S = 60;
+  constexpr uint32_t SETTLE_S = 10;          // setelah kantong diangkat, sebelum error nol dihitung
+  int startFailures = failures;
+
+  WeighingPipeline pipeline(settings);
+  pipeline.setTare(CELL_ZERO_RAW);
+  uint32_t lcg = 99;
+  auto noiseMg = [&]() {
+    lcg = lcg * 1103515245u + 12345u;
+    return static_cast<int32_t>((lcg >> 16) % 6001) - 3000;
+  };
+  auto feed = [&](uint32_t i, int32_t trueMg) {
+    RawSample sample = { i * (1000000u / Config::HX711_SPS), i, CELL_ZERO_RAW + pipeline.calibration().toNet(trueMg) };
+    pipeline.process(sample);
+  };
+
+  const uint32_t total = HOURS * 3600 * Config::HX711_SPS;
+  int32_t worstResidual = 0;
+  int32_t worstUntracked = 0;
+  int32_t worstLoadedError = 0;
+  double sumSq = 0;
+  uint32_t emptySamples = 0;
+  bool shownZero = true;
+  for (uint32_t i = 0; i < total; i++) {
+    const double t = static_cast<double>(i) / Config::HX711_SPS;
+    const uint32_t phase = static_cast<uint32_t>(t) % BAG_EVERY_S;
+    const bool loaded = phase >= BAG_EVERY_S - BAG_HOLD_S;
+    const int32_t drift = zeroDriftMg(t);
+    feed(i, drift + (loaded ? BAG_MG : 0) + noiseMg());
+
+    if (loaded && phase >= BAG_EVERY_S - BAG_HOLD_S + SETTLE_S) {
+      worstLoadedError = std::max(worstLoadedError, abs(pipeline.filteredMg() - BAG_MG));
+    } else if (!loaded && t > SETTLE_S && phase >= SETTLE_S) {
+      // Sisa error nol = drift yang belum diserap offset auto-zero
+      const int32_t residual = drift - pipeline.zeroTracker().offset();
+      worstResidual = std::max(worstResidual, abs(residual));
+      worstUntracked = std::max(worstUntracked, abs(drift));
+      sumSq += static_cast<double>(residual) * residual;
+      emptySamples++;
+      shownZero = shownZero && pipeline.filteredMg() == 0;
+    }
+  }
+  printf("Drift %lu jam (total %ld g): sisa error nol maks %.1f g, RMS %.2f g (tanpa auto-zero %.1f g); "
+         "error kantong maks %.1f g\n", (unsigned long)HOURS, (long)(zeroDriftMg(HOURS * 3600.0) / 1000),
+         worstResidual / 1000.0, sqrt(sumSq / emptySamples) / 1000.0, worstUntracked / 1000.0,
+         worstLoadedError / 1000.0);
+  expect(worstResidual <= Config::AZT_ZERO_BAND_MG, "sisa error nol dalam AZT_ZERO_BAND_MG sepanjang 4 jam");
+  expect(shownZero, "layar tetap 0 selama kosong");
+  expect(worstLoadedError <= ACCEPT_ERROR_MG, "kantong tetap terbaca benar di tengah drift");
+
+  // Beban ditambahkan pelan-pelan (mis. sampah basah menetes) sampai 500 g
+  const double RAMP_G_PER_S[] = { 50.0, 5.0, 0.5, 0.2 };
+  constexpr int32_t RAMP_MG = 500000;
+  bool kept = true;
+  printf("Beban bertahap sampai 500 g, terserap auto-zero:");
+  for (size_t r = 0; r < sizeof(RAMP_G_PER_S) / sizeof(RAMP_G_PER_S[0]); r++) {
+    WeighingPipeline ramp(settings);
+    ramp.setTare(CELL_ZERO_RAW);
+    const uint32_t rampSamples = static_cast<uint32_t>(RAMP_MG / 1000.0 / RAMP_G_PER_S[r] * Config::HX711_SPS);
+    const uint32_t end = Config::HX711_SPS * 30 + rampSamples + Config::HX711_SPS * 60;
+    for (uint32_t i = 0; i < end; i++) {
+      int32_t load = 0;
+      if (i >= Config::HX711_SPS * 30) {
+        load = static_cast<int32_t>(static_cast<int64_t>(RAMP_MG) * (i - Config::HX711_SPS * 30) / rampSamples);
+        if (load > RAMP_MG) load = RAMP_MG;
+      }
+      RawSample sample = { i * (1000000u / Config::HX711_SPS), i,
+                           CELL_ZERO_RAW + ramp.calibration().toNet(load + noiseMg()) };
+      ramp.process(sample);
+    }
+    const int32_t lost = ramp.zeroTracker().offset();
+    printf(" %.1f g/s -> %.1f g", RAMP_G_PER_S[r], lost / 1000.0);
+    kept = kept && abs(lost) <= Config::AZT_ZERO_BAND_MG && abs(ramp.filteredMg() - RAMP_MG) <= ACCEPT_ERROR_MG;
+  }
+  printf("\n");
+  expect(kept, "beban bertahap tidak ikut di-nol-kan (terserap <= AZT_ZERO_BAND_MG)");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int runMqttReplayScenario() {
+  const int32_t BAG_MG = 3000000;
+  AppRig rig;
+  ScriptedSampleSource source(14);
+  rig.uplink.setOnline(false);
+  rig.uplink.setMqttQueueFull(true);
+  int startFailures = failures;
+
+  ScaleApp app(rig.lcd, rig.buttons, rig.buzzer, source, rig.uplink, rig.files, settings);
+  uint32_t now = 0;
+  app.begin(now);
+  app.showMainScreen();
+  const uint32_t firstSeq = app.journal().nextSeq();
+  // Tiap kantong: pilih Residu, kirim 1.2 s setelah diletakkan
+  auto weigh = [&](uint32_t bags) {
+    const int32_t tare = app.pipeline().tareOffset();
+    const uint32_t startMs = now;
+    for (uint32_t i = 0; i < bags; i++) {
+      source.add({ 1500, tare + app.pipeline().calibration().toNet(BAG_MG), 60, 0, 0, 0 });
+      source.add({ 1000, tare, 60, 0, 0, 0 });
+    }
+    for (; now <= source.durationMs(); now++) {
+      uint32_t phase = (now - startMs) % 2500;
+      if (phase == 100) rig.buttons.press(2);
+      if (phase == 1200) rig.buttons.press(3);
+      source.advanceTo(now);
+      app.tick(now);
+    }
+  };
+  // Return true jika 'watch' sempat tampil di LCD
+  auto runFor = [&](uint32_t ms, const char* watch) {
+    bool shown = false;
+    source.add({ ms, app.pipeline().tareOffset(), 60, 0, 0, 0 });
+    for (const uint32_t until = now + ms; now < until; now++) {
+      source.advanceTo(now);
+      app.tick(now);
+      shown = shown || (watch != nullptr && rig.lcd.contains(watch));
+    }
+    return shown;
+  };
+
+  // Broker lambat (antrean MQTT penuh) selagi Laravel offline: record tetap
+  // di jurnal dan di-publish berurutan begitu antrean lega
+  weigh(3);
+  expect(rig.uplink.published().empty() && app.journal().unacked() == 3,
+         "antrean MQTT penuh: 3 record hanya di jurnal");
+  rig.uplink.setMqttQueueFull(false);
+  runFor(Config::MQTT_REPLAY_INTERVAL + 10, nullptr);
+  bool ordered = rig.uplink.published().size() == 3;
+  for (size_t i = 0; ordered && i < 3; i++) {
+    const WeighingRecord& r = rig.uplink.published()[i];
+    ordered = r.seq == firstSeq + i && r.bootId == app.journal().bootId() && abs(r.weightMg - BAG_MG) <= ACCEPT_ERROR_MG;
+  }
+  printf("MQTT diulang dari jurnal: %u record\n", (unsigned)rig.uplink.published().size());
+  expect(ordered, "record yang ditolak antrean MQTT di-publish ulang dari jurnal, berurutan");
+  weigh(1);
+  expect(rig.uplink.published().size() == 4, "penimbangan berikutnya langsung di-publish lagi");
+
+  // Laravel online dan meng-ack lebih dulu: record yang keluar dari jurnal
+  // sebelum antrean MQTT lega tidak bisa diulang, tapi terlihat di LCD
+  rig.uplink.setMqttQueueFull(true);
+  rig.uplink.setOnline(true);
+  weigh(2);
+  const bool shown = runFor(Config::MQTT_REPLAY_INTERVAL + 10, "MQTT: 2 hilang");
+  expect(app.journal().unacked() == 0, "jurnal terkirim ke Laravel");
+  rig.uplink.setMqttQueueFull(false);
+  runFor(Config::MQTT_REPLAY_INTERVAL + 10, nullptr);
+  expect(shown && rig.uplink.published().size() == 4, "record yang keburu di-ack dihitung hilang dan tampil di LCD");
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Kuantil dari array terurut (interpolasi linear di p * (n - 1)), acuan P2Quantile
+static double sortedQuantile(const std::vector<double>& sorted, double p) {
+  double pos = p * (sorted.size() - 1);
+  size_t i = static_cast<size_t>(pos);
+  if (i + 1 >= sorted.size()) return sorted.back();
+  return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+static int runStreamingStatsScenario() {
+  constexpr uint32_t N = 20000;
+  int startFailures = failures;
+
+  // Dua distribusi noise: Gaussian + spike (kantong tersenggol) dan uniform
+  for (int dist = 0; dist < 2; dist++) {
+    StreamingStats stats;
+    std::vector<double> samples;
+    samples.reserve(N);
+    uint32_t rng = 12345 + dist;   // LCG seperti ScriptedSampleSource: deterministik
+    auto uniform01 = [&]() {
+      rng = rng * 1103515245u + 12345u;
+      return ((rng >> 8) & 0xFFFFFF) / 16777216.0;
+    };
+    for (uint32_t i = 0; i < N; i++) {
+      double x;
+      if (dist == 0) {
+        // Box-Muller, sd 300 mg; 0.5% sampel spike +5 g
+        double u1 = uniform01() + 1e-12, u2 = uniform01();
+        x = 300.0 * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+        if (i % 200 == 7) x += 5000.0;
+      } else {
+        x = 2000.0 * uniform01() - 1000.0;
+      }
+      stats.add(x);
+      samples.push_back(x);
+    }
+
+    // Acuan dua-pass atas semua sampel
+    double sum = 0;
+    for (double x : samples) sum += x;
+    const double mean = sum / N;
+    double sq = 0, absDev = 0;
+    for (double x : samples) {
+      sq += (x - mean) * (x - mean);
+      absDev += fabs(x - mean);
+    }
+    const double sd = sqrt(sq / (N - 1));
+    const double mad = absDev / N;
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    const double exact[3] = { sortedQuantile(sorted, 0.5), sortedQuantile(sorted, 0.95), sortedQuantile(sorted, 0.99) };
+    const double streamed[3] = { stats.median(), stats.p95(), stats.p99() };
+
+    printf("%s, n=%lu: mean %.2f/%.2f sd %.2f/%.2f mad~ %.2f/%.2f (streaming/array)\n",
+           dist == 0 ? "Gaussian + spike" : "Uniform", (unsigned long)N, stats.mean(), mean, stats.stddev(), sd,
+           stats.approxMeanAbsDeviation(), mad);
+    const char* const NAMES[] = { "p50", "p95", "p99" };
+    double worst = 0;
+    for (int q = 0; q < 3; q++) {
+      double err = fabs(streamed[q] - exact[q]) / sd;
+      printf("  %s P2 %9.2f  array %9.2f  error %.3f sd\n", NAMES[q], streamed[q], exact[q], err);
+      if (err > worst) worst = err;
+    }
+    expect(fabs(stats.mean() - mean) < 1e-9 * sd && fabs(stats.stddev() / sd - 1.0) < 1e-9 &&
+           stats.minValue() == sorted.front() && stats.maxValue() == sorted.back(),
+           "mean, sd, min, max streaming = hitungan dua-pass");
+    expect(worst < 0.1, "kuantil P2 (p50/p95/p99) dalam 0.1 sd dari kuantil array terurut");
+    expect(fabs(stats.approxMeanAbsDeviation() / mad - 1.0) < 0.01, "aproksimasi MAD dalam 1% dari MAD dua-pass (noise stasioner)");
+  }
+  return failures == startFailures ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int replayTrace(const char* path, const char* csvPath) {
+  TraceSampleSource source;
+  if (!source.load(path)) {
+    fprintf(stderr, "Gagal membaca trace %s\n", path);
+    return EXIT_FAILURE;
+  }
+  FILE* csv = nullptr;
+  if (csvPath != nullptr) {
+    csv = fopen(csvPath, "w");
+    if (csv == nullptr) {
+      fprintf(stderr, "Gagal membuat %s\n", csvPath);
+      return EXIT_FAILURE;
+    }
+    fprintf(csv, "seq,timestamp_us,raw,filtered_mg,stable,stable_mg\n");
+  }
+
+  // Tare dari rata-rata konversi pertama (timbangan dianggap kosong), tanpa re-tare
+  WeighingPipeline pipeline(settings);
+  pipeline.setTare(source.averageRaw(Config::STABILITY_WINDOW));
+
+  // Tanpa state machine: semua sampel langsung diproses berurutan
+  source.advanceTo(source.durationMs() + 1);
+  RawSample sample;
+  uint32_t stableSamples = 0;
+  while (source.pop(sample)) {
+    pipeline.process(sample);
+    if (pipeline.isStable()) stableSamples++;
+    if (csv != nullptr) {
+      fprintf(csv, "%lu,%lu,%ld,%ld,%d,%ld\n", (unsigned long)sample.seq,
+              (unsigned long)sample.timestampUs, (long)sample.raw, (long)pipeline.filteredMg(),
+              pipeline.isStable() ? 1 : 0, (long)pipeline.stableWeightMg());
+    }
+  }
+  if (csv != nullptr) fclose(csv);
+
+  AcquisitionStats s = source.stats();
+  printf("Trace %s: %lu sampel, %lums, %u SPS, missed=%lu maxGap=%luus, stabil %lu%%\n",
+         path, (unsigned long)s.produced, (unsigned long)source.durationMs(), source.sps(),
+         (unsigned long)s.missed, (unsigned long)s.maxGapUs,
+         (unsigned long)(s.produced ? stableSamples * 100 / s.produced : 0));
+  pipeline.printStats(false);
+  return EXIT_SUCCESS;
+}
+
+static int evaluateCalibration(const char* path, const char* gramsList) {
+  const size_t MAX_PLATEAUS = 16;
+  long grams[MAX_PLATEAUS];
+  size_t refCount = 0;
+  for (const char* p = gramsList; *p && refCount < MAX_PLATEAUS; ) {
+    char* end;
+    grams[refCount++] = strtol(p, &end, 10);
+    p = (*end == ',') ? end + 1 : end;
+  }
+
+  TraceSampleSource source;
+  if (!source.load(path)) {
+    fprintf(stderr, "Gagal membaca trace %s\n", path);
+    return EXIT_FAILURE;
+  }
+  WeighingPipeline pipeline(settings);
+  pipeline.setTare(source.averageRaw(Config::STABILITY_WINDOW));
+  source.advanceTo(source.durationMs() + 1);
+
+  // Plateau = rentang stabil minimal satu window penuh; rata-rata net diambil
+  // di ujung rentang. Plateau berdekatan (< 50 count) dianggap beban yang sama.
+  int32_t plateaus[MAX_PLATEAUS];
+  size_t plateauCount = 0;
+  uint32_t stableRun = 0;
+  int32_t lastNet = 0;
+  RawSample sample;
+  bool more = true;
+  while (more) {
+    more = source.pop(sample);
+    if (more) pipeline.process(sample);
+    if (more && pipeline.isStable()) {
+      stableRun++;
+      lastNet = pipeline.averageNet();
+      continue;
+    }
+    if (stableRun >= Config::STABILITY_WINDOW) {
+      bool same = plateauCount > 0 && abs(plateaus[plateauCount - 1] - lastNet) < 50;
+      if (same) plateaus[plateauCount - 1] = lastNet;
+      else if (plateauCount < MAX_PLATEAUS) plateaus[plateauCount++] = lastNet;
+    }
+    stableRun = 0;
+  }
+
+  if (plateauCount != refCount || refCount < 3) {
+    fprintf(stderr, "Ditemukan %u plateau, gram acuan %u (minimal 3):\n",
+            (unsigned)plateauCount, (unsigned)refCount);
+    for (size_t i = 0; i < plateauCount; i++) fprintf(stderr, "  %ld count\n", (long)plateaus[i]);
+    return EXIT_FAILURE;
+  }
+
+  // Faktor tunggal dari satu beban acuan (terdekat 1000 g), seperti kalibrasi-baru.cpp
+  size_t ref = 0;
+  for (size_t i = 0; i < refCount; i++) {
+    if (grams[i] > 0 && (grams[ref] <= 0 || labs(grams[i] - 1000) < labs(grams[ref] - 1000))) ref = i;
+  }
+  CalibrationTable single(Config::MG_PER_COUNT_Q16);
+  single.insertPoint(CalibrationTable::Point{ plateaus[ref], static_cast<int32_t>(grams[ref] * 1000) });
+
+  printf("%10s %12s %14s %14s\n", "acuan (g)", "net count", "tunggal (g)", "multi LOO (g)");
+  double worstSingle = 0, worstMulti = 0;
+  for (size_t k = 0; k < refCount; k++) {
+    CalibrationTable multi(Config::MG_PER_COUNT_Q16);
+    for (size_t i = 0; i < refCount; i++) {
+      if (i != k && grams[i] != 0) {
+        multi.insertPoint(CalibrationTable::Point{ plateaus[i], static_cast<int32_t>(grams[i] * 1000) });
+      }
+    }
+    double errSingle = (single.toMg(plateaus[k]) - grams[k] * 1000.0) / 1000.0;
+    double errMulti = (multi.toMg(plateaus[k]) - grams[k] * 1000.0) / 1000.0;
+    printf("%10ld %12ld %+14.1f %+14.1f\n", grams[k], (long)plateaus[k], errSingle, errMulti);
+    if (grams[k] == 0) continue;
+    if (fabs(errSingle) > worstSingle) worstSingle = fabs(errSingle);
+    if (fabs(errMulti) > worstMulti) worstMulti = fabs(errMulti);
+  }
+  printf("Error maks: faktor tunggal %.1f g, multi-titik %.1f g\n", worstSingle, worstMulti);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+  MemoryStorage storage;
+  initSettings(storage);
+
+  if (argc >= 3 && strcmp(argv[1], "--replay") == 0) {
+    return replayTrace(argv[2], argc >= 4 ? argv[3] : nullptr);
+  }
+  if (argc >= 4 && strcmp(argv[1], "--cal-eval") == 0) {
+    return evaluateCalibration(argv[2], argv[3]);
+  }
+  int result = runBagDropScenario();
+  if (runMaintenanceScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runFastBootScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runCalibrationScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runOfflineJournalScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runBatchBacklogScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runRecordCodecScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runReachabilityScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runWifiLinkScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runExactlyOnceScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runHx711PinsScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runFilterBenchScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runZeroDriftScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runMqttReplayScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  if (runStreamingStatsScenario() != EXIT_SUCCESS) result = EXIT_FAILURE;
+  return result;
+}
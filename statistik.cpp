@@ -5,6 +5,7 @@
 
 #include <Arduino.h>
 #include "HX711_ADC.h"
+#include "src/StreamingStats.h"   // statistik O(1) memori
 
 const int HX711_dout = 2;
 const int HX711_sck  = 4;
@@ -24,18 +25,15 @@ bool samplingCompleted = false;
 bool stabilizationCompleted = false;
 unsigned long samplingStartTime = 0;
 
-// Array untuk menyimpan data
-float weightReadings[TOTAL_SAMPLES];
-float sumReadings = 0;
-float averageWeight = 0;
+// Statistik streaming (tidak perlu array 500 sampel)
+StreamingStats weightStats;
+float lastWeight = 0;
 
 // Variabel timing
 const unsigned long SAMPLE_DELAY = 100;   // delay 100ms antara sampel
 
 // 🎯 DEKLARASI FUNGSI (untuk PlatformIO)
 void calculateStatistics();
-float findMinWeight();
-float findMaxWeight();
 void displayProgress();
 bool waitForStabilization();
 
@@ -87,8 +85,8 @@ void loop() {
       // Simpan data
       if (samplesCollected < TOTAL_SAMPLES) {
         float weight = LoadCell.getData() / 1000.0; // Convert to kg
-        weightReadings[samplesCollected] = weight;
-        sumReadings += weight;
+        weightStats.add(weight);
+        lastWeight = weight;
         samplesCollected++;
         
         // 🔵 Tampilkan progress untuk SETIAP sampel
@@ -110,16 +108,14 @@ void loop() {
 
 // 🎯 FUNGSI UNTUK MENUNGGU STABILISASI
 bool waitForStabilization() {
-  static float lastReadings[STABILIZATION_SAMPLES];
-  static int readingIndex = 0;
+  static RunningStats batch;
   static unsigned long lastStabPrint = 0;
   
   LoadCell.update();
   float currentWeight = LoadCell.getData() / 1000.0;
   
-  // Simpan reading terbaru
-  lastReadings[readingIndex] = currentWeight;
-  readingIndex = (readingIndex + 1) % STABILIZATION_SAMPLES;
+  // Akumulasi batch STABILIZATION_SAMPLES pembacaan tanpa menyimpan array
+  batch.add(currentWeight);
   
   // Tampilkan progress stabilisasi setiap 500ms
   unsigned long currentMillis = millis();
@@ -136,19 +132,11 @@ bool waitForStabilization() {
   }
   
   // Cek stabilitas jika sudah mengumpulkan cukup samples
-  if (readingIndex == 0) {
-    // Hitung rata-rata dan deviasi
-    float sum = 0;
-    for (int i = 0; i < STABILIZATION_SAMPLES; i++) {
-      sum += lastReadings[i];
-    }
-    float average = sum / STABILIZATION_SAMPLES;
-    
-    float maxDev = 0;
-    for (int i = 0; i < STABILIZATION_SAMPLES; i++) {
-      float dev = abs(lastReadings[i] - average);
-      if (dev > maxDev) maxDev = dev;
-    }
+  if (batch.count() >= STABILIZATION_SAMPLES) {
+    // Deviasi maksimum dari rata-rata = sisi terjauh antara min dan max
+    float average = batch.mean();
+    float maxDev = max(batch.maxValue() - average, average - batch.minValue());
+    batch.reset();
     
     // Jika deviasi maksimum di bawah threshold, dianggap stabil
     if (maxDev <= STABILITY_THRESHOLD && average > 0.01) {
@@ -174,33 +162,18 @@ void displayProgress() {
   Serial.print("/");
   Serial.print(TOTAL_SAMPLES);
   Serial.print(": ");
-  Serial.print(weightReadings[samplesCollected-1], 4);
+  Serial.print(lastWeight, 4);
   Serial.println(" kg");
 }
 
 // 🎯 FUNGSI UNTUK MENGHITUNG STATISTIK
 void calculateStatistics() {
-  // Hitung rata-rata
-  averageWeight = sumReadings / TOTAL_SAMPLES;
-  
-  // Hitung deviasi
-  float sumDeviations = 0;
-  float maxDeviation = 0;
-  float minDeviation = 999999;
-  
-  for (int i = 0; i < TOTAL_SAMPLES; i++) {
-    float deviation = abs(weightReadings[i] - averageWeight);
-    sumDeviations += deviation;
-    
-    if (deviation > maxDeviation) {
-      maxDeviation = deviation;
-    }
-    if (deviation < minDeviation) {
-      minDeviation = deviation;
-    }
-  }
-  
-  float averageDeviation = sumDeviations / TOTAL_SAMPLES;
+  // Semua nilai sudah terakumulasi per sampel, tinggal dibaca
+  float averageWeight = weightStats.mean();
+  float minWeight = weightStats.minValue();
+  float maxWeight = weightStats.maxValue();
+  float averageDeviation = weightStats.approxMeanAbsDeviation();
+  float maxDeviation = max(maxWeight - averageWeight, averageWeight - minWeight);
   
   // Hitung waktu total
   unsigned long totalTime = millis() - samplingStartTime;
@@ -228,15 +201,21 @@ void calculateStatistics() {
   Serial.println(" kg");
   
   Serial.print("Berat minimum: ");
-  float minWeight = findMinWeight();
   Serial.print(minWeight, 4);
   Serial.println(" kg");
   
   Serial.print("Berat maksimum: ");
-  float maxWeight = findMaxWeight();
   Serial.print(maxWeight, 4);
   Serial.println(" kg");
   
+  Serial.print("Median / p95 / p99: ");
+  Serial.print(weightStats.median(), 4);
+  Serial.print(" / ");
+  Serial.print(weightStats.p95(), 4);
+  Serial.print(" / ");
+  Serial.print(weightStats.p99(), 4);
+  Serial.println(" kg");
+  
   Serial.print("Range: ");
   Serial.print(maxWeight - minWeight, 4);
   Serial.println(" kg");
@@ -252,8 +231,8 @@ void calculateStatistics() {
   Serial.print(maxDeviation, 4);
   Serial.println(" kg");
   
-  Serial.print("Deviasi minimum: ±");
-  Serial.print(minDeviation, 4);
+  Serial.print("Simpangan baku: ");
+  Serial.print(weightStats.stddev(), 4);
   Serial.println(" kg");
   
   // Konversi ke gram untuk perspektif yang lebih baik
@@ -294,25 +273,3 @@ void calculateStatistics() {
   Serial.println("         PENGAMBILAN DATA SELESAI");
   Serial.println("==============================================");
 }
-
-// 🎯 FUNGSI UNTUK MENCARI BERAT MINIMUM
-float findMinWeight() {
-  float min = weightReadings[0];
-  for (int i = 1; i < TOTAL_SAMPLES; i++) {
-    if (weightReadings[i] < min) {
-      min = weightReadings[i];
-    }
-  }
-  return min;
-}
-
-// 🎯 FUNGSI UNTUK MENCARI BERAT MAKSIMUM
-float findMaxWeight() {
-  float max = weightReadings[0];
-  for (int i = 1; i < TOTAL_SAMPLES; i++) {
-    if (weightReadings[i] > max) {
-      max = weightReadings[i];
-    }
-  }
-  return max;
-}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# ==================== BENCHMARK UPLOAD BATCH ====================
+# Mengirim backlog record ke server Laravel tiruan (tools/laravel_standin.py)
+# dengan protokol yang sama seperti firmware: satu koneksi HTTPS keep-alive,
+# form POST per record (batch 1) atau JSON ke .../batch (batch > 1), lalu
+# mencetak record/detik per ukuran batch.
+#
+#   python3 tools/laravel_standin.py --port 8443 --quiet --request-ms 40 --record-ms 2 &
+#   python3 tools/batch_bench.py --url https://127.0.0.1:8443/api/receive-sampah --records 96
+#
+# Angka ini mengukur protokol + server di host. Di perangkat, ukuran batch
+# dan RTT-nya terlihat di console 'net' setelah backlog jurnal dikirim.
+
+import argparse
+import http.client
+import json
+import ssl
+import sys
+import time
+import urllib.parse
+
+
+def make_records(count):
+    return [{"berat": "%.2f" % (1.0 + i * 0.01), "fakultas": "FT", "jenis": "Organik"} for i in range(count)]
+
+
+def post(conn, path, body, content_type):
+    conn.request("POST", path, body=body, headers={"Content-Type": content_type})
+    response = conn.getresponse()
+    return response.status, response.read()
+
+
+def run(url, records, batch):
+    parts = urllib.parse.urlsplit(url)
+    context = ssl.create_default_context()
+    context.check_hostname = False
+    context.verify_mode = ssl.CERT_NONE
+    conn = http.client.HTTPSConnection(parts.hostname, parts.port or 443, context=context, timeout=15)
+
+    accepted = 0
+    requests = 0
+    start = time.monotonic()
+    for i in range(0, len(records), batch):
+        chunk = records[i:i + batch]
+        requests += 1
+        if batch == 1:
+            r = chunk[0]
+            body = urllib.parse.urlencode({"api_key": "bench", "berat": r["berat"],
+                                           "fakultas": r["fakultas"], "jenis": r["jenis"]})
+            status, _ = post(conn, parts.path, body, "application/x-www-form-urlencoded")
+            accepted += 1 if status in (200, 201) else 0
+        else:
+            body = json.dumps({"api_key": "bench", "records": chunk})
+            status, reply = post(conn, parts.path.rstrip("/") + "/batch", body, "application/json")
+            if status in (200, 201):
+                accepted += sum(1 for ok in json.loads(reply).get("results", []) if ok)
+    elapsed = time.monotonic() - start
+    conn.close()
+    return accepted, requests, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="record/detik vs ukuran batch")
+    parser.add_argument("--url", default="https://127.0.0.1:8443/api/receive-sampah")
+    parser.add_argument("--records", type=int, default=96)
+    parser.add_argument("--sizes", default="1,2,4,8,16")
+    args = parser.parse_args()
+
+    records = make_records(args.records)
+    print("%8s %8s %10s %10s" % ("batch", "POST", "waktu (s)", "record/s"))
+    for size in (int(s) for s in args.sizes.split(",")):
+        accepted, requests, elapsed = run(args.url, records, size)
+        if accepted != len(records):
+            print("batch %d: hanya %d/%d record diterima" % (size, accepted, len(records)))
+            sys.exit(1)
+        print("%8d %8d %10.2f %10.1f" % (size, requests, elapsed, accepted / elapsed))
+
+
+if __name__ == "__main__":
+    main()
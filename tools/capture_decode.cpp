@@ -0,0 +1,70 @@
+// ==================== DECODER STREAM CAPTURE ====================
+// Mengubah stream biner dari console 'capture on' (CaptureFrame.h) menjadi
+// file trace .estr (src/sim/TraceFile.h) untuk di-replay di env native.
+//
+// Build (host):
+//   g++ -std=gnu++11 -O2 -Isrc tools/capture_decode.cpp -o capture_decode
+// Rekam (Linux, Serial 115200 raw):
+//   stty -F /dev/ttyUSB0 115200 raw -echo
+//   (echo "capture on"; sleep 60; echo "capture off") > /dev/ttyUSB0 &
+//   cat /dev/ttyUSB0 > capture.bin
+//   ./capture_decode capture.bin trace.estr
+// Input '-' = stdin, jadi bisa juga langsung: cat /dev/ttyUSB0 | ./capture_decode - trace.estr
+//
+// Teks log yang tercampur di stream dilewati (sync + CRC), frame dengan
+// CRC salah dibuang dan dihitung, celah nomor urut dilaporkan.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/CaptureFrame.h"
+#include "../src/Config.h"
+#include "../src/sim/TraceFile.h"
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "Pemakaian: %s <capture.bin|-> <trace.estr>\n", argv[0]);
+    return 2;
+  }
+
+  FILE* in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+  if (in == nullptr) {
+    fprintf(stderr, "Gagal membuka %s\n", argv[1]);
+    return 1;
+  }
+  FILE* out = fopen(argv[2], "wb");
+  if (out == nullptr || !Trace::writeHeader(out, Config::HX711_SPS)) {
+    fprintf(stderr, "Gagal membuat %s\n", argv[2]);
+    return 1;
+  }
+
+  Capture::Decoder decoder;
+  RawSample sample;
+  RawSample prev = {};
+  bool havePrev = false;
+  unsigned long gaps = 0, missing = 0, maxGapUs = 0;
+
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    if (!decoder.feed(static_cast<uint8_t>(c), sample)) continue;
+
+    if (havePrev) {
+      uint32_t seqStep = sample.seq - prev.seq;
+      if (seqStep == 0 || seqStep > 0x80000000u) continue;   // duplikat / mundur: abaikan
+      if (seqStep > 1) { gaps++; missing += seqStep - 1; }
+      uint32_t gapUs = sample.timestampUs - prev.timestampUs;
+      if (gapUs > maxGapUs) maxGapUs = gapUs;
+    }
+    Trace::writeRecord(out, sample);
+    prev = sample;
+    havePrev = true;
+  }
+
+  if (in != stdin) fclose(in);
+  fclose(out);
+
+  fprintf(stderr, "frames=%lu crcErrors=%lu skippedBytes=%lu seqGaps=%lu missing=%lu maxGap=%luus\n",
+          (unsigned long)decoder.frames(), (unsigned long)decoder.crcErrors(),
+          (unsigned long)decoder.skippedBytes(), gaps, missing, maxGapUs);
+  return decoder.frames() > 0 ? 0 : 1;
+}
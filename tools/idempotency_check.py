@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# ==================== CEK EXACTLY-ONCE UPLOAD ====================
+# Meniru jurnal firmware (RecordJournal + forwardJournal) terhadap server
+# Laravel tiruan yang membuang duplikat dan memutus sebagian respons:
+#
+#   python3 tools/laravel_standin.py --port 8443 --quiet --drop-reply-every 4 &
+#   python3 tools/idempotency_check.py --url https://127.0.0.1:8443/api/receive-sampah
+#
+# Boot 1 mengirim form POST per record, lalu "mati listrik" setelah server
+# menyimpan record terakhir tapi sebelum ack jurnal tersimpan; boot 2 (boot_id
+# baru, seq berlanjut) mengirim ulang sisa jurnal + record baru lewat batch.
+# Setiap kiriman yang tidak mendapat respons diulang dengan kunci yang sama.
+# Di akhir, selisih GET .../stats harus tepat sama dengan jumlah penimbangan.
+# Exit code != 0 jika ada record yang hilang atau tersimpan dua kali.
+
+import argparse
+import http.client
+import json
+import random
+import socket
+import ssl
+import sys
+import urllib.parse
+
+class Server:
+    def __init__(self, url, timeout, device_id):
+        self.device_id = device_id
+        self.parts = urllib.parse.urlsplit(url)
+        self.context = ssl.create_default_context()
+        self.context.check_hostname = False
+        self.context.verify_mode = ssl.CERT_NONE
+        self.timeout = timeout
+        self.conn = None
+        self.lost = 0
+
+    def request(self, method, path, body=None, content_type=None):
+        """Return (status, body) atau None jika tidak ada respons (koneksi dibuka ulang)."""
+        if self.conn is None:
+            self.conn = http.client.HTTPSConnection(self.parts.hostname, self.parts.port or 443,
+                                                    context=self.context, timeout=self.timeout)
+        headers = {"Content-Type": content_type} if content_type else {}
+        try:
+            self.conn.request(method, path, body=body, headers=headers)
+            response = self.conn.getresponse()
+            return response.status, response.read()
+        except (http.client.HTTPException, socket.timeout, ConnectionError, ssl.SSLError):
+            self.conn.close()
+            self.conn = None
+            self.lost += 1
+            return None
+
+    def stats(self):
+        reply = self.request("GET", self.parts.path.rstrip("/") + "/stats")
+        if reply is None or reply[0] != 200:
+            sys.exit("GET /stats gagal")
+        return json.loads(reply[1])
+
+    def send_form(self, record):
+        body = urllib.parse.urlencode(dict(record, api_key="cek", device_id=self.device_id))
+        reply = self.request("POST", self.parts.path, body, "application/x-www-form-urlencoded")
+        return [reply is not None and reply[0] in (200, 201)]
+
+    def send_batch(self, records):
+        body = json.dumps({"api_key": "cek", "device_id": self.device_id, "records": records})
+        reply = self.request("POST", self.parts.path.rstrip("/") + "/batch", body, "application/json")
+        if reply is None or reply[0] not in (200, 201):
+            return [False] * len(records)
+        return json.loads(reply[1]).get("results", [False] * len(records))
+
+
+class Journal:
+    """Record dengan kunci tetap; ack berurutan seperti RecordJournal."""
+
+    def __init__(self):
+        self.entries = []
+        self.acked = 0
+        self.next_seq = 1
+        self.boot_id = 0
+
+    def boot(self):
+        self.boot_id += 1
+
+    def append(self, weight_kg):
+        self.entries.append({"boot_id": self.boot_id, "seq": self.next_seq,
+                             "berat": "%.2f" % weight_kg, "fakultas": "FT", "jenis": "Residu"})
+        self.next_seq += 1
+
+    def drain(self, send, batch, max_attempts):
+        attempts = 0
+        while self.acked < len(self.entries):
+            attempts += 1
+            if attempts > max_attempts:
+                return False
+            chunk = self.entries[self.acked:self.acked + batch]
+            for ok in send(chunk):
+                if not ok:
+                    break
+                self.acked += 1
+        return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cek exactly-once upload dengan kunci (device_id, boot_id, seq)")
+    parser.add_argument("--url", default="https://127.0.0.1:8443/api/receive-sampah")
+    parser.add_argument("--records", type=int, default=40, help="penimbangan per boot")
+    parser.add_argument("--batch", type=int, default=8)
+    parser.add_argument("--timeout", type=float, default=5.0)
+    parser.add_argument("--device-id", default="%012X" % random.getrandbits(48),
+                        help="default acak: tiap run = perangkat baru, tidak bentrok dengan run sebelumnya")
+    args = parser.parse_args()
+
+    server = Server(args.url, args.timeout, args.device_id)
+    before = server.stats()
+    journal = Journal()
+
+    # Boot 1: form POST per record
+    journal.boot()
+    for i in range(args.records):
+        journal.append(1.0 + i * 0.01)
+    ok = journal.drain(lambda chunk: server.send_form(chunk[0]), 1, args.records * 4)
+    # Mati listrik: server sudah menyimpan record terakhir, ack-nya belum tersimpan
+    journal.acked -= 1
+
+    # Boot 2: sisa jurnal + record baru, lewat batch
+    journal.boot()
+    for i in range(args.records):
+        journal.append(2.0 + i * 0.01)
+    ok = journal.drain(server.send_batch, args.batch, args.records * 4) and ok
+    weight_total = sum(float(e["berat"]) for e in journal.entries)
+
+    after = server.stats()
+    rows = after["rows"] - before["rows"]
+    duplicates = after["duplicates"] - before["duplicates"]
+    stored_kg = after["weight_total"] - before["weight_total"]
+    print("%d penimbangan, %d baris baru di server, %d kiriman duplikat dibuang, %d respons hilang"
+          % (len(journal.entries), rows, duplicates, server.lost))
+    print("Total berat: dikirim %.2f kg, tersimpan %.2f kg" % (weight_total, stored_kg))
+
+    exact = ok and rows == len(journal.entries) and abs(stored_kg - weight_total) < 0.005
+    print("EXACTLY-ONCE: %s" % ("OK" if exact else "GAGAL"))
+    if duplicates == 0:
+        print("Peringatan: tidak ada kiriman ulang (jalankan server dengan --drop-reply-every)")
+    sys.exit(0 if exact else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+# ==================== SERVER LARAVEL TIRUAN (TLS) ====================
+# Pengganti lokal untuk https://ecoscale.undip.us/api/receive-sampah, untuk
+# mengukur latensi POST per record dari perangkat tanpa jaringan internet:
+# HTTPS + HTTP/1.1 keep-alive, respons "berhasil" seperti server asli.
+#
+# Jalankan (sertifikat self-signed dibuat otomatis lewat openssl):
+#   python3 tools/laravel_standin.py --port 8443 --idle 75
+# Build firmware yang mengarah ke sini (platformio.ini, env perangkat):
+#   build_flags = -D LARAVEL_URL=\"https://<ip-host>:8443/api/receive-sampah\"
+# Lalu timbang beberapa kali dan bandingkan console 'net' di perangkat dengan
+# log di sini: setiap koneksi TLS dicetak bersama jumlah POST yang dibawanya.
+#
+# Session ID / ticket TLS 1.2 diterima (default OpenSSL), jadi resumption di
+# firmware terlihat di log sebagai "sesi dilanjutkan".
+#
+# --idle meniru keepalive_timeout nginx: koneksi idle lebih lama dari ini
+# ditutup server, untuk menguji deteksi socket basi di firmware.
+#
+# POST .../receive-sampah/batch menerima upload batch firmware:
+#   {"api_key":"...","records":[{"berat":"5.20","fakultas":"FT","jenis":"Organik"},...]}
+# dan membalas {"status":"berhasil","results":[true,...]} (satu hasil per record).
+# --request-ms / --record-ms meniru biaya server (bootstrap Laravel per request,
+# INSERT per record); tools/batch_bench.py mengukur record/detik per ukuran batch.
+#
+# Kontrak idempoten: record membawa kunci (device_id, boot_id, seq) -- form
+# field, atau "device_id" di body batch + "boot_id"/"seq" per record. Kunci
+# yang sudah tersimpan tidak disimpan lagi: form dibalas 200
+# {"status":"berhasil","duplikat":true}, batch dibalas true untuk record itu.
+# Record tanpa kunci (firmware lama) selalu disimpan.
+# --drop-reply-every K menyimpan POST ke-K lalu menutup koneksi tanpa respons
+# (timeout di perangkat setelah server commit); GET .../stats mengembalikan
+# jumlah baris, duplikat, dan total berat. tools/idempotency_check.py memakai
+# keduanya untuk memeriksa exactly-once.
+
+import argparse
+import http.server
+import json
+import os
+import socket
+import ssl
+import subprocess
+import sys
+import threading
+import time
+import urllib.parse
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"   # keep-alive kecuali klien minta Connection: close
+
+    def setup(self):
+        super().setup()
+        self.connection.settimeout(self.server.idle_timeout)
+        # Header & body ditulis terpisah: tanpa NODELAY, Nagle + delayed ACK
+        # menambah ~40 ms ke setiap POST keep-alive
+        self.connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.posts = 0
+        self.opened = time.monotonic()
+        self.log_message("koneksi TLS baru (%s)",
+                         "sesi dilanjutkan" if self.connection.session_reused else "handshake penuh")
+
+    def finish(self):
+        super().finish()
+        self.log_message("koneksi ditutup setelah %d POST, %.1f s",
+                         self.posts, time.monotonic() - self.opened)
+
+    def do_GET(self):
+        if not self.path.rstrip("/").endswith("/stats"):
+            self.send_error(404)
+            return
+        data = json.dumps(self.server.store.stats()).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_POST(self):
+        start = time.monotonic()
+        length = int(self.headers.get("Content-Length", 0))
+        body = self.rfile.read(length).decode(errors="replace")
+        self.posts += 1
+
+        if self.path.rstrip("/").endswith("/batch"):
+            status, reply, summary = self.handle_batch(body)
+        else:
+            status, reply, summary = self.handle_form(body)
+
+        if self.server.should_drop_reply():
+            # Sudah disimpan, tapi perangkat tidak pernah melihat respons
+            self.log_message("POST #%d disimpan, koneksi diputus tanpa respons (--drop-reply-every)", self.posts)
+            self.close_connection = True
+            self.connection.shutdown(socket.SHUT_RDWR)
+            return
+
+        data = json.dumps(reply).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+        if not self.server.quiet:
+            self.log_message("POST #%d pada koneksi ini (%.1f ms di server): %s",
+                             self.posts, (time.monotonic() - start) * 1000, summary)
+
+    def handle_form(self, body):
+        fields = {k: v[0] for k, v in urllib.parse.parse_qs(body).items()}
+        if not all(k in fields for k in ("berat", "fakultas", "jenis")):
+            return 422, {"status": "gagal", "message": "field kurang"}, body
+        self.server.simulate_cost(1)
+        if not self.server.store.insert(fields.get("device_id"), fields, fields):
+            return 200, {"status": "berhasil", "duplikat": True}, "duplikat: " + body
+        return 201, {"status": "berhasil"}, body
+
+    def handle_batch(self, body):
+        try:
+            request = json.loads(body)
+            records = request["records"]
+        except (ValueError, KeyError, TypeError):
+            return 422, {"status": "gagal", "message": "body batch tidak valid"}, body
+        self.server.simulate_cost(len(records))
+        results = []
+        duplicates = 0
+        for r in records:
+            valid = all(k in r for k in ("berat", "fakultas", "jenis"))
+            if valid and not self.server.store.insert(request.get("device_id"), r, r):
+                duplicates += 1
+            results.append(valid)
+        return 201, {"status": "berhasil", "results": results}, \
+            "batch %d record (%d duplikat)" % (len(records), duplicates)
+
+
+class RecordStore:
+    """Tabel sampah tiruan dengan unique index (device_id, boot_id, seq)."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.keys = set()
+        self.rows = 0
+        self.duplicates = 0
+        self.unkeyed = 0
+        self.weight_total = 0.0
+
+    def insert(self, device_id, key_fields, record):
+        """Return False jika kunci sudah ada (tidak disimpan lagi)."""
+        key = None
+        if device_id is not None and "boot_id" in key_fields and "seq" in key_fields:
+            key = (str(device_id), int(key_fields["boot_id"]), int(key_fields["seq"]))
+        with self.lock:
+            if key is not None and key in self.keys:
+                self.duplicates += 1
+                return False
+            if key is None:
+                self.unkeyed += 1
+            else:
+                self.keys.add(key)
+            self.rows += 1
+            self.weight_total += float(record["berat"])
+            return True
+
+    def stats(self):
+        with self.lock:
+            return {"rows": self.rows, "duplicates": self.duplicates, "unkeyed": self.unkeyed,
+                    "weight_total": round(self.weight_total, 2)}
+
+
+class StandinServer(http.server.ThreadingHTTPServer):
+    def should_drop_reply(self):
+        if not self.drop_reply_every:
+            return False
+        with self.counter_lock:
+            self.post_count += 1
+            return self.post_count % self.drop_reply_every == 0
+
+    def simulate_cost(self, records):
+        delay = self.request_ms + self.record_ms * records
+        if delay > 0:
+            time.sleep(delay / 1000.0)
+
+
+def ensure_certificate(cert, key):
+    if os.path.exists(cert) and os.path.exists(key):
+        return
+    subprocess.check_call([
+        "openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes", "-days", "365",
+        "-subj", "/CN=ecoscale-standin", "-keyout", key, "-out", cert,
+    ])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Server Laravel tiruan (HTTPS keep-alive)")
+    parser.add_argument("--port", type=int, default=8443)
+    parser.add_argument("--idle", type=float, default=75.0, help="detik idle sebelum koneksi ditutup")
+    parser.add_argument("--request-ms", type=float, default=0.0, help="biaya server per request (ms)")
+    parser.add_argument("--record-ms", type=float, default=0.0, help="biaya server per record (ms)")
+    parser.add_argument("--drop-reply-every", type=int, default=0,
+                        help="simpan POST ke-K lalu putus tanpa respons (uji idempoten)")
+    parser.add_argument("--quiet", action="store_true", help="tanpa log per POST (untuk benchmark)")
+    parser.add_argument("--cert", default="standin-cert.pem")
+    parser.add_argument("--key", default="standin-key.pem")
+    args = parser.parse_args()
+
+    ensure_certificate(args.cert, args.key)
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(args.cert, args.key)
+
+    server = StandinServer(("0.0.0.0", args.port), Handler)
+    server.idle_timeout = args.idle
+    server.request_ms = args.request_ms
+    server.record_ms = args.record_ms
+    server.quiet = args.quiet
+    server.store = RecordStore()
+    server.drop_reply_every = args.drop_reply_every
+    server.post_count = 0
+    server.counter_lock = threading.Lock()
+    server.socket = context.wrap_socket(server.socket, server_side=True)
+    print("Mendengarkan di https://0.0.0.0:%d/api/receive-sampah (idle %.0f s)" % (args.port, args.idle))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        sys.exit(0)
+
+
+if __name__ == "__main__":
+    main()
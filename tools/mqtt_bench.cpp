@@ -0,0 +1,186 @@
+// ==================== BENCHMARK MQTT QOS 1 ====================
+// Menjalankan MqttPublisher (kode yang sama dengan firmware) di host lewat
+// socket POSIX ke broker tiruan (tools/mqtt_standin.py), lalu mencetak
+// pesan/detik per ukuran jendela in-flight: 1 = stop-and-wait seperti
+// publish-lalu-tunggu-ack, Config::MQTT_INFLIGHT_WINDOW = default firmware.
+//
+// Build (host):
+//   g++ -std=gnu++11 -O2 -Isrc tools/mqtt_bench.cpp src/MqttPublisher.cpp -o mqtt_bench
+// Jalankan:
+//   python3 tools/mqtt_standin.py --port 1883 --ack-delay-ms 40 --quiet &
+//   ./mqtt_bench 127.0.0.1 1883 200 1,2,4,8
+// Dengan --drop-every K di broker: hitungan 'ulang' dan 'sesi' menunjukkan
+// kirim ulang DUP, ringkasan broker menunjukkan tidak ada seq yang hilang.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/MqttPublisher.h"
+
+namespace {
+  bool verbose = false;
+
+  uint32_t nowMs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint32_t>(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+  }
+
+  class PosixSocket : public Hal::Socket {
+  public:
+    ~PosixSocket() { stop(); }
+
+    // Seperti LwipSocket di perangkat: SYN non-blocking, hasil dilihat poll()
+    // dengan select() timeout 0. (DNS host lewat getaddrinfo boleh blok.)
+    bool connect(const char* host, uint16_t port) override {
+      stop();
+      addrinfo hints;
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_INET;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo* res = nullptr;
+      char service[8];
+      snprintf(service, sizeof(service), "%u", port);
+      if (getaddrinfo(host, service, &hints, &res) != 0) return false;
+      fd_ = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+      bool ok = fd_ >= 0 && fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK) == 0 &&
+                (::connect(fd_, res->ai_addr, res->ai_addrlen) == 0 || errno == EINPROGRESS);
+      freeaddrinfo(res);
+      if (!ok) {
+        stop();
+        return false;
+      }
+      int one = 1;
+      setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      established_ = false;
+      return true;
+    }
+
+    Hal::Connector::Status poll() override {
+      if (fd_ < 0) return Hal::Connector::Status::FAILED;
+      if (established_) return Hal::Connector::Status::CONNECTED;
+      fd_set writable;
+      FD_ZERO(&writable);
+      FD_SET(fd_, &writable);
+      timeval zero = { 0, 0 };
+      if (select(fd_ + 1, nullptr, &writable, nullptr, &zero) <= 0) return Hal::Connector::Status::PENDING;
+      int error = 0;
+      socklen_t len = sizeof(error);
+      getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+      if (error != 0) return Hal::Connector::Status::FAILED;
+      established_ = true;
+      return Hal::Connector::Status::CONNECTED;
+    }
+
+    void stop() override {
+      if (fd_ >= 0) close(fd_);
+      fd_ = -1;
+    }
+
+    bool connected() override { return fd_ >= 0; }
+
+    size_t read(uint8_t* buf, size_t len) override {
+      if (fd_ < 0) return 0;
+      ssize_t n = recv(fd_, buf, len, MSG_DONTWAIT);
+      if (n > 0) return static_cast<size_t>(n);
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) stop();   // ditutup broker
+      return 0;
+    }
+
+    bool write(const uint8_t* data, size_t len) override {
+      if (fd_ < 0) return false;
+      return send(fd_, data, len, MSG_NOSIGNAL) == static_cast<ssize_t>(len);
+    }
+
+  private:
+    int fd_ = -1;
+    bool established_ = false;
+  };
+
+  struct Result {
+    uint32_t elapsedMs;
+    MqttStats stats;
+    bool complete;
+  };
+
+  Result run(const char* host, uint16_t port, uint32_t count, uint16_t window) {
+    PosixSocket socket;
+    MqttPublisher mqtt(socket, window);
+    mqtt.setServer(host, port);
+    mqtt.setClientId("mqtt-bench");
+    mqtt.setRetryInterval(50);
+
+    const uint32_t start = nowMs();
+    uint32_t next = 0;
+    char payload[96];
+    while (nowMs() - start < 60000) {
+      // Antrean diisi terus seperti backlog, dibatasi MQTT_QUEUE_SIZE
+      while (next < count) {
+        snprintf(payload, sizeof(payload), "{\"seq\":%lu,\"weight\":1.25,\"fakultas\":\"FT\",\"jenis\":\"Organik\"}",
+                 (unsigned long)(next + 1));
+        if (!mqtt.publish("ecoscale/bench", payload)) break;
+        next++;
+      }
+      mqtt.loop(nowMs());
+      if (next == count && mqtt.queued() == 0) break;
+      usleep(200);
+    }
+    Result r = { nowMs() - start, mqtt.stats(), next == count && mqtt.queued() == 0 };
+    // Antrean penuh saat publish() di atas ikut terhitung 'dropped'; bukan pesan hilang
+    r.stats.dropped = 0;
+    mqtt.disconnect();
+    return r;
+  }
+}
+
+void logPrintf(const char* fmt, ...) {
+  if (!verbose) return;
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    fprintf(stderr, "Pemakaian: %s <host> <port> <pesan> [jendela,...] [-v]\n", argv[0]);
+    return 2;
+  }
+  const char* host = argv[1];
+  const uint16_t port = static_cast<uint16_t>(atoi(argv[2]));
+  const uint32_t count = static_cast<uint32_t>(atol(argv[3]));
+  char windows[64] = "1,2,4,8";
+  if (argc > 4) {
+    strncpy(windows, argv[4], sizeof(windows) - 1);
+    windows[sizeof(windows) - 1] = '\0';
+  }
+  verbose = argc > 5 && strcmp(argv[5], "-v") == 0;
+
+  printf("%8s %8s %10s %8s %8s %6s %10s\n", "jendela", "pesan", "waktu (s)", "pesan/s", "ulang", "sesi", "ack avg");
+  int rc = 0;
+  for (char* tok = strtok(windows, ","); tok != nullptr; tok = strtok(nullptr, ",")) {
+    uint16_t window = static_cast<uint16_t>(atoi(tok));
+    Result r = run(host, port, count, window);
+    if (!r.complete || r.stats.acked != count) {
+      printf("jendela %u: hanya %lu/%lu pesan di-ack\n", window, (unsigned long)r.stats.acked, (unsigned long)count);
+      rc = 1;
+      continue;
+    }
+    printf("%8u %8lu %10.2f %8.1f %8lu %6lu %8lums\n", window, (unsigned long)count, r.elapsedMs / 1000.0,
+           count * 1000.0 / (r.elapsedMs ? r.elapsedMs : 1), (unsigned long)r.stats.retransmits,
+           (unsigned long)r.stats.connects, (unsigned long)(r.stats.ackMsTotal / r.stats.acked));
+  }
+  return rc;
+}
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+# ==================== BROKER MQTT TIRUAN ====================
+# Broker MQTT 3.1.1 minimal untuk menguji jalur QoS 1 firmware (MqttPublisher)
+# tanpa broker.hivemq.com: CONNECT/CONNACK (sesi persisten per client ID),
+# PUBLISH QoS 1 -> PUBACK, PINGREQ -> PINGRESP, DISCONNECT.
+#
+#   python3 tools/mqtt_standin.py --port 1883 --ack-delay-ms 40
+#   python3 tools/mqtt_standin.py --port 1883 --ack-delay-ms 40 --drop-every 25
+#
+# --ack-delay-ms meniru RTT broker internet: PUBACK dikirim sekian ms setelah
+# PUBLISH diterima (tiap pesan sendiri-sendiri, jadi pesan yang dikirim
+# bersamaan juga di-ack bersamaan).
+# --drop-every K menutup koneksi setelah PUBLISH ke-K, sebelum di-ack, untuk
+# menguji kirim ulang DUP setelah reconnect.
+#
+# Payload JSON dengan field "seq" (tools/mqtt_bench.cpp) atau record biner
+# (tools/record_codec.py, MQTT_BIN_TOPIC) dihitung per client:
+# saat DISCONNECT dicetak jumlah seq unik, duplikat (DUP yang sudah pernah
+# diterima) dan seq yang hilang.
+
+import argparse
+import heapq
+import json
+import select
+import socket
+import socketserver
+import threading
+import time
+
+import record_codec
+
+CONNECT, CONNACK, PUBLISH, PUBACK, PINGREQ, PINGRESP, DISCONNECT = 1, 2, 3, 4, 12, 13, 14
+
+sessions = {}            # client ID -> {"seqs": set, "duplicates": int, "publishes": int}
+sessions_lock = threading.Lock()
+
+
+def encode_length(length):
+    out = bytearray()
+    while True:
+        digit = length & 0x7F
+        length >>= 7
+        out.append(digit | 0x80 if length else digit)
+        if not length:
+            return bytes(out)
+
+
+def read_packet(buf):
+    """Return (tipe, flags, body, sisa buffer) atau None jika belum lengkap."""
+    if len(buf) < 2:
+        return None
+    length, mult, i = 0, 1, 1
+    while True:
+        if i >= len(buf):
+            return None
+        length += (buf[i] & 0x7F) * mult
+        mult <<= 7
+        i += 1
+        if not buf[i - 1] & 0x80:
+            break
+        if i > 4:
+            raise ValueError("panjang sisa rusak")
+    if len(buf) < i + length:
+        return None
+    return buf[0] >> 4, buf[0] & 0x0F, bytes(buf[i:i + length]), buf[i + length:]
+
+
+class Handler(socketserver.BaseRequestHandler):
+    def handle(self):
+        sock = self.request
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        opts = self.server.opts
+        buf = bytearray()
+        acks = []                # heap (jatuh tempo, packet ID)
+        client = None
+        while True:
+            timeout = max(0.0, acks[0][0] - time.monotonic()) if acks else 1.0
+            readable, _, _ = select.select([sock], [], [], timeout)
+            now = time.monotonic()
+            while acks and acks[0][0] <= now:
+                _, packet_id = heapq.heappop(acks)
+                sock.sendall(bytes([PUBACK << 4, 2]) + packet_id.to_bytes(2, "big"))
+            if not readable:
+                continue
+            data = sock.recv(4096)
+            if not data:
+                self.log(client, "koneksi ditutup klien")
+                return
+            buf += data
+            while True:
+                packet = read_packet(buf)
+                if packet is None:
+                    break
+                kind, flags, body, buf = packet
+                buf = bytearray(buf)
+                if kind == CONNECT:
+                    client = self.on_connect(sock, body)
+                elif kind == PUBLISH:
+                    if not self.on_publish(client, flags, body, acks, opts):
+                        self.log(client, "diputus (--drop-every) sebelum PUBACK")
+                        return
+                elif kind == PINGREQ:
+                    sock.sendall(bytes([PINGRESP << 4, 0]))
+                elif kind == DISCONNECT:
+                    self.summary(client)
+                    return
+
+    def on_connect(self, sock, body):
+        flags = body[7]
+        id_len = int.from_bytes(body[10:12], "big")
+        client = body[12:12 + id_len].decode(errors="replace")
+        with sessions_lock:
+            present = client in sessions and not flags & 0x02
+            if flags & 0x02 or client not in sessions:
+                sessions[client] = {"seqs": set(), "duplicates": 0, "publishes": 0}
+        sock.sendall(bytes([CONNACK << 4, 2, 1 if present else 0, 0]))
+        self.log(client, "CONNECT (sesi %s)" % ("lanjut" if present else "baru"))
+        return client
+
+    def on_publish(self, client, flags, body, acks, opts):
+        topic_len = int.from_bytes(body[0:2], "big")
+        qos = (flags >> 1) & 0x03
+        offset = 2 + topic_len
+        packet_id = None
+        if qos > 0:
+            packet_id = int.from_bytes(body[offset:offset + 2], "big")
+            offset += 2
+        payload = body[offset:]
+
+        with sessions_lock:
+            session = sessions.setdefault(client, {"seqs": set(), "duplicates": 0, "publishes": 0})
+            session["publishes"] += 1
+            count = session["publishes"]
+            try:
+                seq = json.loads(payload).get("seq")
+            except (ValueError, AttributeError):
+                try:
+                    seq = record_codec.decode(payload)["seq"]
+                except record_codec.DecodeError:
+                    seq = None
+            if seq is not None:
+                if seq in session["seqs"]:
+                    session["duplicates"] += 1
+                session["seqs"].add(seq)
+
+        if opts.drop_every and count % opts.drop_every == 0:
+            return False
+        if packet_id is not None:
+            heapq.heappush(acks, (time.monotonic() + opts.ack_delay_ms / 1000.0, packet_id))
+        return True
+
+    def summary(self, client):
+        with sessions_lock:
+            session = sessions.get(client)
+            if session is None:
+                return
+            seqs = session["seqs"]
+            missing = (max(seqs) - len(seqs)) if seqs else 0
+            self.log(client, "DISCONNECT: %d PUBLISH, %d seq unik, %d duplikat, %d hilang"
+                     % (session["publishes"], len(seqs), session["duplicates"], missing))
+            # Putaran bench berikutnya dengan client ID yang sama mulai dari nol
+            seqs.clear()
+            session["duplicates"] = 0
+            session["publishes"] = 0
+
+    def log(self, client, message):
+        if not self.server.opts.quiet or "DISCONNECT" in message:
+            print("[%s] %s" % (client or "?", message), flush=True)
+
+
+class StandinBroker(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Broker MQTT 3.1.1 tiruan (QoS 1)")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--ack-delay-ms", type=float, default=0.0)
+    parser.add_argument("--drop-every", type=int, default=0)
+    parser.add_argument("--quiet", action="store_true", help="hanya cetak ringkasan DISCONNECT")
+    opts = parser.parse_args()
+
+    server = StandinBroker(("0.0.0.0", opts.port), Handler)
+    server.opts = opts
+    print("Broker tiruan di port %d (ack %.0f ms, putus tiap %s PUBLISH)"
+          % (opts.port, opts.ack_delay_ms, opts.drop_every or "-"), flush=True)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
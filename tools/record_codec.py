@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+# ==================== DECODER RECORD BINER (HOST) ====================
+# Pasangan src/RecordCodec.h untuk sisi server / tool host: mengubah payload
+# MQTT_BIN_TOPIC (undip/scale/new/bin) kembali menjadi field yang sama
+# dengan JSON MQTT. Layout v2 (little-endian):
+#
+#   versi(1) jenis(1) fakultas(1) flag(1) device_id(6) boot_id(4) seq(4)
+#   berat_mg(4) [nama fakultas 8 byte jika flag bit 0] crc16(2)
+#
+# device_id = MAC 48-bit; (device_id, boot_id, seq) = kunci idempoten yang
+# sama dengan form Laravel, dikembalikan sebagai "%012X" seperti firmware.
+# Frame v1 lama (device_id 4 byte, tanpa boot_id) masih dibaca dengan
+# boot_id = 0 untuk perangkat yang belum diperbarui.
+#
+# Sebagai library:
+#   from record_codec import decode
+#   rec = decode(payload)   # {"device_id":..., "boot_id":..., "seq":..., "weight_kg":..., ...}
+# Dari command line (hex, mis. contoh yang dicetak runner native):
+#   python3 tools/record_codec.py 02010100f6e5d4c3b2a1030000002a00000080584f00df1d
+#
+# Tabel ID harus sama dengan RecordCodec.cpp (jenis) dan PRESET_TABLE di
+# DeviceProfile.cpp (fakultas); ID hanya boleh ditambah di belakang.
+
+import struct
+import sys
+
+VERSION = 2
+# versi -> (struct header, ukuran tanpa nama); nama fakultas 8 byte menyusul header
+_LAYOUTS = {
+    1: (struct.Struct("<BBBBIIi"), 18),
+    2: (struct.Struct("<BBBBIHIIi"), 24),
+}
+BASE_SIZE = _LAYOUTS[VERSION][1]
+MAX_SIZE = BASE_SIZE + 8
+CUSTOM_FAKULTAS = 0xFF
+FLAG_FAKULTAS_NAME = 0x01
+
+CATEGORIES = ["--", "Organik", "Anorganik", "Botol", "Kertas", "Residu"]
+FAKULTAS = ["FIB", "FT", "FISIP", "FPsi", "TPST", "FKM", "FSM"]
+
+
+class DecodeError(ValueError):
+    pass
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, sama dengan Capture::crc16."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def decode(payload):
+    payload = bytes(payload)
+    if len(payload) < 4 or payload[0] not in _LAYOUTS:
+        raise DecodeError("versi record tidak dikenal")
+    header, base_size = _LAYOUTS[payload[0]]
+    with_name = bool(payload[3] & FLAG_FAKULTAS_NAME)
+    size = base_size + 8 if with_name else base_size
+    if len(payload) != size:
+        raise DecodeError("panjang %d, seharusnya %d" % (len(payload), size))
+    if crc16(payload[:-2]) != struct.unpack_from("<H", payload, size - 2)[0]:
+        raise DecodeError("CRC salah")
+
+    fields = header.unpack_from(payload)
+    version, category, fakultas_id = fields[:3]
+    if version == 1:
+        device_id, boot_id, seq, weight_mg = fields[4], 0, fields[5], fields[6]
+    else:
+        device_id = fields[4] | (fields[5] << 32)
+        boot_id, seq, weight_mg = fields[6:]
+    if with_name:
+        name_at = header.size
+        fakultas = payload[name_at:name_at + 8].split(b"\0", 1)[0].decode("ascii", "replace")
+    elif fakultas_id < len(FAKULTAS):
+        fakultas = FAKULTAS[fakultas_id]
+    else:
+        raise DecodeError("ID fakultas %d tidak dikenal" % fakultas_id)
+    return {
+        "version": version,
+        "device_id": "%012X" % device_id if version >= 2 else "%08X" % device_id,
+        "boot_id": boot_id,
+        "seq": seq,
+        "weight_mg": weight_mg,
+        "weight_kg": weight_mg / 1e6,
+        "fakultas": fakultas,
+        "jenis": CATEGORIES[category] if category < len(CATEGORIES) else "--",
+    }
+
+
+def encode(device_id, boot_id, seq, weight_mg, fakultas, jenis):
+    """Encoder referensi v2 (uji server tanpa perangkat); hasil identik dengan firmware.
+
+    device_id: int 48-bit atau teks hex 12 digit seperti di form Laravel.
+    """
+    if isinstance(device_id, str):
+        device_id = int(device_id, 16)
+    category = CATEGORIES.index(jenis) if jenis in CATEGORIES[1:] else 0
+    with_name = fakultas not in FAKULTAS
+    body = _LAYOUTS[VERSION][0].pack(VERSION, category, CUSTOM_FAKULTAS if with_name else FAKULTAS.index(fakultas),
+                                     FLAG_FAKULTAS_NAME if with_name else 0, device_id & 0xFFFFFFFF,
+                                     (device_id >> 32) & 0xFFFF, boot_id, seq, weight_mg)
+    if with_name:
+        body += fakultas.encode("ascii")[:7].ljust(8, b"\0")
+    return body + struct.pack("<H", crc16(body))
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Pemakaian: %s <hex> [hex...]" % sys.argv[0], file=sys.stderr)
+        return 2
+    rc = 0
+    for text in sys.argv[1:]:
+        try:
+            print(decode(bytes.fromhex(text)))
+        except (DecodeError, ValueError) as e:
+            print("%s: %s" % (text, e))
+            rc = 1
+    return rc
+
+
+if __name__ == "__main__":
+    sys.exit(main())